@@ -1,6 +1,11 @@
 #include "algorithms/custom_hybrid/hybrid_algorithm.hpp"
 #include "utils/crc.hpp"
+#include "utils/dictionary.hpp"
+#include "utils/kernels.hpp"
+#include "utils/shuffle.hpp"
+#include "utils/tracing.hpp"
 #include <cmath>
+#include <cstdint>
 #include <algorithm>
 #include <unordered_map>
 
@@ -22,11 +27,37 @@ CompressionResult HybridAlgorithm::compress(const ByteVector& input, const Compr
     
     initialize_algorithms();
     
+    bool use_dictionary = config.dictionary_id != utils::Dictionary::NONE;
+    if (use_dictionary && !utils::DictionaryRegistry::instance().find(config.dictionary_id)) {
+        return CompressionResult(false, "Dictionary " + utils::Dictionary::format_id(config.dictionary_id) +
+                                        " is not loaded");
+    }
+    
+    size_t shuffle_width = config.shuffle_width;
+    if (shuffle_width == CompressionConfig::SHUFFLE_AUTO) {
+        shuffle_width = utils::ByteShuffle::detect_width(input);
+    }
+    if (shuffle_width > utils::ByteShuffle::MAX_WIDTH) {
+        return CompressionResult(false, "Invalid shuffle width: " + std::to_string(shuffle_width));
+    }
+    if (shuffle_width == 1) {
+        shuffle_width = 0;
+    }
+    
+    // Dictionaries are trained on raw bytes, so the codecs working on
+    // differenced blocks run without one
+    CompressionConfig block_config = config;
+    block_config.dictionary_id = utils::Dictionary::NONE;
+    
+    utils::TraceSpan span("hybrid.compress");
+    span.arg("bytes", input.size());
+    
     CompressionResult result(true);
     auto& stats = result.stats();
     
     stats.original_size = input.size();
     if (config.verify_integrity) {
+        utils::TraceSpan checksum_span("hybrid.checksum");
         stats.checksum = utils::CRC32::calculate(input);
     }
     
@@ -36,41 +67,66 @@ CompressionResult HybridAlgorithm::compress(const ByteVector& input, const Compr
     size_t block_size = get_optimal_block_size(input.size());
     
     // Apply preprocessing to improve compression
-    ByteVector preprocessed = apply_preprocessing(input);
+    ByteVector preprocessed;
+    {
+        utils::TraceSpan preprocess_span("hybrid.preprocess");
+        preprocessed = apply_preprocessing(input, block_size, shuffle_width);
+    }
     
     // Analyze input and classify blocks
-    auto blocks = analyze_input(preprocessed, block_size);
+    std::vector<BlockInfo> blocks;
+    {
+        utils::TraceSpan analyze_span("hybrid.analyze");
+        blocks = analyze_input(preprocessed, block_size);
+    }
     
     // Compress each block with optimal algorithm
     ByteVector compressed;
     compressed.reserve(input.size()); // Conservative estimate
     
-    // Header: Hybrid signature and block count
+    // Header: Hybrid signature and block count, plus the shuffle width if any
     compressed.push_back('H');
     compressed.push_back('Y');
     compressed.push_back('B');
-    compressed.push_back('R');
+    compressed.push_back(shuffle_width ? 'S' : 'R');
     
     uint32_t block_count = blocks.size();
     compressed.push_back((block_count >> 24) & 0xFF);
     compressed.push_back((block_count >> 16) & 0xFF);
     compressed.push_back((block_count >> 8) & 0xFF);
     compressed.push_back(block_count & 0xFF);
+    if (shuffle_width) {
+        compressed.push_back(static_cast<uint8_t>(shuffle_width));
+    }
     
     // Compress blocks
     size_t total_compressed = 0;
     std::unordered_map<BlockType, size_t> algorithm_usage;
     
     for (const auto& block_info : blocks) {
+        utils::TraceSpan block_span("hybrid.block");
+        block_span.arg("offset", block_info.start_offset);
+        
         // Extract block data
         ByteVector block_data(preprocessed.begin() + block_info.start_offset,
                              preprocessed.begin() + block_info.start_offset + block_info.size);
         
         // Compress block
-        ByteVector compressed_block = compress_block(block_data, block_info.type, config);
+        BlockType encoded_as = block_info.type;
+        ByteVector compressed_block = compress_block(block_data, block_info.type, block_config, encoded_as);
+        
+        if (use_dictionary) {
+            ByteVector raw_block(input.begin() + block_info.start_offset,
+                                 input.begin() + block_info.start_offset + block_info.size);
+            auto primed = lz77_algo_->compress(raw_block, config);
+            if (primed.is_success() && primed.data().size() < compressed_block.size()) {
+                compressed_block = primed.data();
+                encoded_as = BlockType::DICTIONARY;
+            }
+        }
         
-        // Store block header: type + original size + compressed size
-        compressed.push_back(static_cast<uint8_t>(block_info.type));
+        // Store block header: codec type + original size + compressed size
+        compressed.push_back(static_cast<uint8_t>(encoded_as));
         
         uint32_t original_size = block_info.size;
         compressed.push_back((original_size >> 24) & 0xFF);
@@ -92,7 +148,11 @@ CompressionResult HybridAlgorithm::compress(const ByteVector& input, const Compr
     }
     
     // Apply postprocessing
-    ByteVector final_compressed = apply_postprocessing(compressed);
+    ByteVector final_compressed;
+    {
+        utils::TraceSpan postprocess_span("hybrid.postprocess");
+        final_compressed = apply_postprocessing(compressed);
+    }
     
     auto end_time = now();
     
@@ -111,6 +171,9 @@ CompressionResult HybridAlgorithm::compress(const ByteVector& input, const Compr
                algorithm_usage[BlockType::HIGH_REPETITION],
                algorithm_usage[BlockType::RANDOM],
                algorithm_usage[BlockType::MIXED]);
+        if (shuffle_width) {
+            printf("  Byte shuffle width: %zu\n", shuffle_width);
+        }
     }
     
     return result;
@@ -123,28 +186,27 @@ CompressionResult HybridAlgorithm::decompress(const ByteVector& input, const Com
     
     initialize_algorithms();
     
+    utils::TraceSpan span("hybrid.decompress");
+    span.arg("bytes", input.size());
+    
     CompressionResult result(true);
     auto& stats = result.stats();
     
     auto start_time = now();
     
     try {
-        // Check signature
-        if (input.size() < 8 || input[0] != 'H' || input[1] != 'Y' || input[2] != 'B' || input[3] != 'R') {
-            throw DecompressionException("Invalid hybrid compression signature");
-        }
-        
-        // Read block count
-        uint32_t block_count = (static_cast<uint32_t>(input[4]) << 24) |
-                              (static_cast<uint32_t>(input[5]) << 16) |
-                              (static_cast<uint32_t>(input[6]) << 8) |
-                              static_cast<uint32_t>(input[7]);
+        // Check signature and read block count
+        uint32_t block_count;
+        size_t shuffle_width;
+        size_t offset = read_header(input, block_count, shuffle_width);
         
         ByteVector decompressed;
-        size_t offset = 8;
         
         // Decompress each block
         for (uint32_t i = 0; i < block_count; ++i) {
+            utils::TraceSpan block_span("hybrid.block");
+            block_span.arg("index", i);
+            
             if (offset + 9 > input.size()) {
                 throw DecompressionException("Incomplete block header");
             }
@@ -178,6 +240,9 @@ CompressionResult HybridAlgorithm::decompress(const ByteVector& input, const Com
             if (decompressed_block.size() != original_size) {
                 throw DecompressionException("Block size mismatch after decompression");
             }
+            if (type != BlockType::DICTIONARY) {
+                undo_preprocessing(decompressed_block, shuffle_width);
+            }
             
             decompressed.insert(decompressed.end(), decompressed_block.begin(), decompressed_block.end());
         }
@@ -191,6 +256,7 @@ CompressionResult HybridAlgorithm::decompress(const ByteVector& input, const Com
         stats.threads_used = config.num_threads;
         
         if (config.verify_integrity) {
+            utils::TraceSpan checksum_span("hybrid.checksum");
             stats.checksum = utils::CRC32::calculate(decompressed);
         }
         
@@ -203,6 +269,139 @@ CompressionResult HybridAlgorithm::decompress(const ByteVector& input, const Com
     return result;
 }
 
+CompressionResult HybridAlgorithm::decompress_range(const ByteVector& input, size_t offset, size_t length,
+                                                   const CompressionConfig& config) {
+    initialize_algorithms();
+    
+    CompressionResult result(true);
+    auto& stats = result.stats();
+    
+    auto start_time = now();
+    
+    try {
+        uint32_t block_count;
+        size_t shuffle_width;
+        size_t pos = read_header(input, block_count, shuffle_width);
+        
+        size_t range_end = length > SIZE_MAX - offset ? SIZE_MAX : offset + length;
+        size_t block_start = 0;  // Position of the current block in the original data
+        
+        ByteVector decompressed;
+        
+        for (uint32_t i = 0; i < block_count && block_start < range_end; ++i) {
+            if (pos + 9 > input.size()) {
+                throw DecompressionException("Incomplete block header");
+            }
+            
+            BlockType type = static_cast<BlockType>(input[pos]);
+            uint32_t original_size = (static_cast<uint32_t>(input[pos + 1]) << 24) |
+                                   (static_cast<uint32_t>(input[pos + 2]) << 16) |
+                                   (static_cast<uint32_t>(input[pos + 3]) << 8) |
+                                   static_cast<uint32_t>(input[pos + 4]);
+            uint32_t compressed_size = (static_cast<uint32_t>(input[pos + 5]) << 24) |
+                                     (static_cast<uint32_t>(input[pos + 6]) << 16) |
+                                     (static_cast<uint32_t>(input[pos + 7]) << 8) |
+                                     static_cast<uint32_t>(input[pos + 8]);
+            pos += 9;
+            
+            if (pos + compressed_size > input.size()) {
+                throw DecompressionException("Incomplete block data");
+            }
+            
+            size_t block_end = block_start + original_size;
+            
+            // Only blocks overlapping the range are decoded
+            if (block_end > offset) {
+                utils::TraceSpan block_span("hybrid.block");
+                block_span.arg("index", i);
+                
+                ByteVector compressed_block(input.begin() + pos, input.begin() + pos + compressed_size);
+                ByteVector block = decompress_block(compressed_block, type, config);
+                
+                if (block.size() != original_size) {
+                    throw DecompressionException("Block size mismatch after decompression");
+                }
+                if (type != BlockType::DICTIONARY) {
+                    undo_preprocessing(block, shuffle_width);
+                }
+                
+                size_t from = offset > block_start ? offset - block_start : 0;
+                size_t to = std::min(block.size(), range_end - block_start);
+                decompressed.insert(decompressed.end(), block.begin() + from, block.begin() + to);
+            }
+            
+            pos += compressed_size;
+            block_start = block_end;
+        }
+        
+        auto end_time = now();
+        
+        stats.original_size = decompressed.size();
+        stats.compressed_size = input.size();
+        stats.decompression_time_ms = duration_ms(start_time, end_time);
+        stats.threads_used = 1;
+        
+        if (config.verify_integrity) {
+            utils::TraceSpan checksum_span("hybrid.checksum");
+            stats.checksum = utils::CRC32::calculate(decompressed);
+        }
+        
+        result.set_data(std::move(decompressed));
+        
+    } catch (const std::exception& e) {
+        return CompressionResult(false, "Decompression failed: " + std::string(e.what()));
+    }
+    
+    return result;
+}
+
+size_t HybridAlgorithm::read_header(const ByteVector& input, uint32_t& block_count, size_t& shuffle_width) {
+    if (input.size() < 8 || input[0] != 'H' || input[1] != 'Y' || input[2] != 'B' ||
+        (input[3] != 'R' && input[3] != 'S')) {
+        throw DecompressionException("Invalid hybrid compression signature");
+    }
+    
+    block_count = (static_cast<uint32_t>(input[4]) << 24) |
+                  (static_cast<uint32_t>(input[5]) << 16) |
+                  (static_cast<uint32_t>(input[6]) << 8) |
+                  static_cast<uint32_t>(input[7]);
+    
+    shuffle_width = 0;
+    if (input[3] == 'S') {
+        if (input.size() < 9) {
+            throw DecompressionException("Invalid hybrid compression header");
+        }
+        shuffle_width = input[8];
+        return 9;
+    }
+    return 8;
+}
+
+size_t HybridAlgorithm::original_size(const ByteVector& input) {
+    uint32_t block_count;
+    size_t shuffle_width;
+    size_t pos = read_header(input, block_count, shuffle_width);
+    
+    size_t total = 0;
+    for (uint32_t i = 0; i < block_count; ++i) {
+        if (pos + 9 > input.size()) {
+            throw DecompressionException("Incomplete block header");
+        }
+        
+        total += (static_cast<uint32_t>(input[pos + 1]) << 24) |
+                 (static_cast<uint32_t>(input[pos + 2]) << 16) |
+                 (static_cast<uint32_t>(input[pos + 3]) << 8) |
+                 static_cast<uint32_t>(input[pos + 4]);
+        uint32_t compressed_size = (static_cast<uint32_t>(input[pos + 5]) << 24) |
+                                 (static_cast<uint32_t>(input[pos + 6]) << 16) |
+                                 (static_cast<uint32_t>(input[pos + 7]) << 8) |
+                                 static_cast<uint32_t>(input[pos + 8]);
+        pos += 9 + compressed_size;
+    }
+    
+    return total;
+}
+
 double HybridAlgorithm::estimate_ratio(const ByteVector& input) const {
     if (input.empty()) return 1.0;
     
@@ -276,16 +475,15 @@ BlockType HybridAlgorithm::classify_block(const ByteVector& block) {
 double HybridAlgorithm::calculate_entropy(const ByteVector& data) const {
     if (data.empty()) return 0.0;
     
-    std::unordered_map<uint8_t, size_t> frequencies;
-    for (uint8_t byte : data) {
-        frequencies[byte]++;
-    }
+    uint64_t counts[256] = {};
+    utils::Kernels::histogram(data.data(), data.size(), counts);
     
     double entropy = 0.0;
     double size = static_cast<double>(data.size());
     
-    for (const auto& pair : frequencies) {
-        double probability = static_cast<double>(pair.second) / size;
+    for (uint64_t count : counts) {
+        if (count == 0) continue;
+        double probability = static_cast<double>(count) / size;
         entropy -= probability * std::log2(probability);
     }
     
@@ -326,8 +524,10 @@ double HybridAlgorithm::calculate_local_entropy(const ByteVector& data, size_t w
     return windows > 0 ? total_entropy / windows : 0.0;
 }
 
-ByteVector HybridAlgorithm::compress_block(const ByteVector& block, BlockType type, const CompressionConfig& config) {
+ByteVector HybridAlgorithm::compress_block(const ByteVector& block, BlockType type, const CompressionConfig& config,
+                                          BlockType& encoded_as) {
     CompressionResult result(false);
+    encoded_as = type;
     
     switch (type) {
         case BlockType::LOW_ENTROPY:
@@ -350,18 +550,25 @@ ByteVector HybridAlgorithm::compress_block(const ByteVector& block, BlockType ty
                 (rle_result.stats().compressed_size <= lz77_result.stats().compressed_size) &&
                 (rle_result.stats().compressed_size <= huffman_result.stats().compressed_size)) {
                 result = std::move(rle_result);
+                encoded_as = BlockType::LOW_ENTROPY;
             } else if (lz77_result.is_success() && 
                        (lz77_result.stats().compressed_size <= huffman_result.stats().compressed_size)) {
                 result = std::move(lz77_result);
+                encoded_as = BlockType::HIGH_REPETITION;
             } else {
                 result = std::move(huffman_result);
+                encoded_as = BlockType::RANDOM;
             }
             break;
         }
+        case BlockType::STORED:
+        case BlockType::DICTIONARY:  // Chosen by compress() on the raw block
+            break;
     }
     
-    if (!result.is_success()) {
+    if (!result.is_success() || result.data().size() >= block.size()) {
         // Fallback to storing uncompressed
+        encoded_as = BlockType::STORED;
         return block;
     }
     
@@ -376,12 +583,16 @@ ByteVector HybridAlgorithm::decompress_block(const ByteVector& block, BlockType
             result = rle_algo_->decompress(block, config);
             break;
         case BlockType::HIGH_REPETITION:
+        case BlockType::DICTIONARY:  // The LZ77 header names the dictionary
             result = lz77_algo_->decompress(block, config);
             break;
         case BlockType::RANDOM:
-        case BlockType::MIXED:
             result = huffman_algo_->decompress(block, config);
             break;
+        case BlockType::STORED:
+            return block;
+        default:
+            throw DecompressionException("Unknown hybrid block type");
     }
     
     if (!result.is_success()) {
@@ -391,24 +602,41 @@ ByteVector HybridAlgorithm::decompress_block(const ByteVector& block, BlockType
     return result.data();
 }
 
-ByteVector HybridAlgorithm::apply_preprocessing(const ByteVector& input) {
-    // Simple preprocessing: byte differencing for improved compression
-    if (input.size() < 2) return input;
-    
-    ByteVector preprocessed;
-    preprocessed.reserve(input.size());
-    
-    preprocessed.push_back(input[0]); // First byte unchanged
-    
-    for (size_t i = 1; i < input.size(); ++i) {
-        // Store difference from previous byte
-        int16_t diff = input[i] - input[i-1];
-        preprocessed.push_back(static_cast<uint8_t>(diff & 0xFF));
+ByteVector HybridAlgorithm::apply_preprocessing(const ByteVector& input, size_t block_size, size_t shuffle_width) {
+    // Byte shuffling groups the byte positions of fixed-width records, then
+    // byte differencing turns slowly changing planes into runs
+    ByteVector preprocessed(input.size());
+    
+    for (size_t start = 0; start < input.size(); start += block_size) {
+        size_t size = std::min(block_size, input.size() - start);
+        const uint8_t* block = input.data() + start;
+        
+        ByteVector shuffled;
+        if (shuffle_width > 1) {
+            shuffled = utils::ByteShuffle::shuffle(ByteVector(block, block + size), shuffle_width);
+            block = shuffled.data();
+        }
+        
+        uint8_t* out = preprocessed.data() + start;
+        out[0] = block[0]; // First byte of each block unchanged
+        for (size_t i = 1; i < size; ++i) {
+            // Store difference from previous byte
+            out[i] = static_cast<uint8_t>(block[i] - block[i - 1]);
+        }
     }
     
     return preprocessed;
 }
 
+void HybridAlgorithm::undo_preprocessing(ByteVector& block, size_t shuffle_width) {
+    for (size_t i = 1; i < block.size(); ++i) {
+        block[i] = static_cast<uint8_t>(block[i] + block[i - 1]);
+    }
+    if (shuffle_width > 1) {
+        block = utils::ByteShuffle::unshuffle(block, shuffle_width);
+    }
+}
+
 ByteVector HybridAlgorithm::apply_postprocessing(const ByteVector& compressed) {
     // Simple postprocessing: could add additional entropy coding here
     return compressed;
@@ -14,7 +14,9 @@ enum class BlockType {
     LOW_ENTROPY,     // Use RLE
     HIGH_REPETITION, // Use LZ77
     RANDOM,          // Use Huffman
-    MIXED            // Use hybrid approach
+    MIXED,           // Use hybrid approach
+    STORED,          // Incompressible, kept raw
+    DICTIONARY       // LZ77 primed with a dictionary, on the raw (undifferenced) bytes
 };
 
 // Block metadata
@@ -41,6 +43,15 @@ public:
     
     double estimate_ratio(const ByteVector& input) const override;
     size_t get_optimal_block_size(size_t input_size) const override;
+    
+    // Decompress only bytes [offset, offset + length) of the original data.
+    // Block headers are scanned to skip blocks outside the range, so the
+    // cost is proportional to the blocks covering the range.
+    CompressionResult decompress_range(const ByteVector& input, size_t offset, size_t length,
+                                       const CompressionConfig& config = CompressionConfig());
+    
+    // Original data size, read from the block headers without decoding
+    static size_t original_size(const ByteVector& input);
 
 private:
     // Block size for analysis (adaptive based on input size)
@@ -69,12 +80,20 @@ private:
     // Compression strategy selection
     std::string select_best_algorithm(const ByteVector& block, const CompressionConfig& config);
     
-    // Block processing
-    ByteVector compress_block(const ByteVector& block, BlockType type, const CompressionConfig& config);
+    // Block processing; `encoded_as` receives the codec actually used
+    ByteVector compress_block(const ByteVector& block, BlockType type, const CompressionConfig& config,
+                              BlockType& encoded_as);
     ByteVector decompress_block(const ByteVector& block, BlockType type, const CompressionConfig& config);
     
+    // Stream header: "HYBR" | block count, or "HYBS" | block count | shuffle
+    // width when blocks are byte-shuffled. Returns the first block's offset.
+    static size_t read_header(const ByteVector& input, uint32_t& block_count, size_t& shuffle_width);
+    
     // Advanced hybrid techniques
-    ByteVector apply_preprocessing(const ByteVector& input);
+    // Byte shuffling (optional) and differencing restart at every block so
+    // blocks decode independently
+    ByteVector apply_preprocessing(const ByteVector& input, size_t block_size, size_t shuffle_width);
+    void undo_preprocessing(ByteVector& block, size_t shuffle_width);
     ByteVector apply_postprocessing(const ByteVector& compressed);
     
     // Context-based prediction for better compression
@@ -1,10 +1,134 @@
 #include "algorithms/huffman/huffman_algorithm.hpp"
 #include "utils/crc.hpp"
+#include "utils/dictionary.hpp"
+#include "utils/kernels.hpp"
+#include "utils/tracing.hpp"
 #include <cmath>
 #include <algorithm>
+#include <array>
 
 namespace compressor {
 
+namespace {
+
+std::unordered_map<uint8_t, size_t> count_frequencies(const ByteVector& input) {
+    uint64_t counts[256] = {};
+    utils::Kernels::histogram(input.data(), input.size(), counts);
+
+    std::unordered_map<uint8_t, size_t> frequencies;
+    for (int byte = 0; byte < 256; ++byte) {
+        if (counts[byte] > 0) {
+            frequencies[static_cast<uint8_t>(byte)] = static_cast<size_t>(counts[byte]);
+        }
+    }
+    return frequencies;
+}
+
+// Codes are written through a uint32_t
+constexpr uint8_t MAX_CODE_LENGTH = 32;
+
+// Huffman code lengths for all 256 bytes of a dictionary distribution.
+// Nothing is stored, so the result may depend only on the frequencies:
+// leaves are taken in (frequency, byte) order and merged with the
+// two-queue method, which prefers a leaf over an equal-weight internal
+// node. Frequencies are halved until no code is longer than
+// MAX_CODE_LENGTH.
+std::array<uint8_t, 256> dictionary_code_lengths(const std::vector<uint32_t>& frequencies) {
+    std::vector<uint64_t> weights(frequencies.begin(), frequencies.end());
+    while (true) {
+        std::array<int, 256> order;
+        for (int byte = 0; byte < 256; ++byte) order[byte] = byte;
+        std::sort(order.begin(), order.end(), [&](int a, int b) {
+            return weights[a] != weights[b] ? weights[a] < weights[b] : a < b;
+        });
+
+        // Nodes 0-255 are leaves by byte, 256 onwards internal nodes in
+        // creation order, whose weights never decrease
+        std::vector<uint64_t> weight(weights.begin(), weights.end());
+        std::vector<size_t> parent(511, 0);
+        size_t next_leaf = 0;
+        size_t next_internal = 256;
+        auto take = [&]() {
+            if (next_leaf < 256 && (next_internal == weight.size() || weight[order[next_leaf]] <= weight[next_internal])) {
+                return static_cast<size_t>(order[next_leaf++]);
+            }
+            return next_internal++;
+        };
+        while (weight.size() < 511) {
+            size_t a = take();
+            size_t b = take();
+            parent[a] = parent[b] = weight.size();
+            weight.push_back(weight[a] + weight[b]);
+        }
+
+        // Parents are created after their children, so walk down from the root
+        std::vector<uint8_t> depth(511, 0);
+        bool fits = true;
+        for (size_t node = 509;; --node) {
+            depth[node] = static_cast<uint8_t>(std::min<int>(depth[parent[node]] + 1, 255));
+            fits = fits && depth[node] <= MAX_CODE_LENGTH;
+            if (node == 0) break;
+        }
+        if (fits) {
+            std::array<uint8_t, 256> lengths;
+            std::copy(depth.begin(), depth.begin() + 256, lengths.begin());
+            return lengths;
+        }
+        for (auto& w : weights) w = std::max<uint64_t>(1, w / 2);
+    }
+}
+
+// Canonical codes: ordered by (length, byte), each the previous plus one,
+// shifted left to its length
+std::unordered_map<uint8_t, HuffmanCode> canonical_codes(const std::array<uint8_t, 256>& lengths) {
+    std::array<int, 256> order;
+    for (int byte = 0; byte < 256; ++byte) order[byte] = byte;
+    std::sort(order.begin(), order.end(), [&](int a, int b) {
+        return lengths[a] != lengths[b] ? lengths[a] < lengths[b] : a < b;
+    });
+
+    std::unordered_map<uint8_t, HuffmanCode> codes;
+    uint32_t code = 0;
+    uint8_t previous = lengths[order[0]];
+    for (size_t i = 0; i < order.size(); ++i) {
+        uint8_t length = lengths[order[i]];
+        if (i > 0) {
+            code = (code + 1) << (length - previous);
+        }
+        previous = length;
+        codes[static_cast<uint8_t>(order[i])] = HuffmanCode(code, length);
+    }
+    return codes;
+}
+
+// Decoding tree for a complete prefix code
+std::unique_ptr<HuffmanNode> tree_from_codes(const std::unordered_map<uint8_t, HuffmanCode>& codes) {
+    auto root = std::make_unique<HuffmanNode>(size_t(0), nullptr, nullptr);
+    for (const auto& entry : codes) {
+        HuffmanNode* node = root.get();
+        for (int bit = entry.second.length - 1; bit > 0; --bit) {
+            auto& child = (entry.second.code >> bit) & 1 ? node->right : node->left;
+            if (!child) {
+                child = std::make_unique<HuffmanNode>(size_t(0), nullptr, nullptr);
+            }
+            node = child.get();
+        }
+        auto& leaf = entry.second.code & 1 ? node->right : node->left;
+        leaf = std::make_unique<HuffmanNode>(entry.first, 0);
+    }
+    return root;
+}
+
+std::shared_ptr<const utils::Dictionary> find_dictionary(uint32_t id) {
+    auto dictionary = utils::DictionaryRegistry::instance().find(id);
+    if (!dictionary) {
+        throw DecompressionException("Dictionary " + utils::Dictionary::format_id(id) + " is not loaded");
+    }
+    return dictionary;
+}
+
+} // namespace
+
 // Comparator for priority queue (min-heap)
 struct NodeComparator {
     bool operator()(const std::unique_ptr<HuffmanNode>& a, const std::unique_ptr<HuffmanNode>& b) {
@@ -30,24 +154,39 @@ CompressionResult HuffmanAlgorithm::compress(const ByteVector& input, const Comp
         return CompressionResult(false, "Input data is empty");
     }
     
+    utils::TraceSpan span("huffman.compress");
+    span.arg("bytes", input.size());
+    
     CompressionResult result(true);
     auto& stats = result.stats();
     
     stats.original_size = input.size();
     if (config.verify_integrity) {
+        utils::TraceSpan checksum_span("huffman.checksum");
         stats.checksum = utils::CRC32::calculate(input);
     }
     
     auto start_time = now();
     
+    // A dictionary supplies the byte distribution, so no tree is stored
+    std::shared_ptr<const utils::Dictionary> dictionary;
+    if (config.dictionary_id != utils::Dictionary::NONE) {
+        dictionary = utils::DictionaryRegistry::instance().find(config.dictionary_id);
+        if (!dictionary) {
+            return CompressionResult(false, "Dictionary " + utils::Dictionary::format_id(config.dictionary_id) +
+                                            " is not loaded");
+        }
+    }
+    
     // Count byte frequencies
     std::unordered_map<uint8_t, size_t> frequencies;
-    for (uint8_t byte : input) {
-        frequencies[byte]++;
+    if (!dictionary) {
+        utils::TraceSpan analyze_span("huffman.analyze");
+        frequencies = count_frequencies(input);
     }
     
     // Handle special case: only one unique byte
-    if (frequencies.size() == 1) {
+    if (!dictionary && frequencies.size() == 1) {
         ByteVector compressed;
         compressed.push_back(0x01); // Special header for single byte
         compressed.push_back(frequencies.begin()->first); // The byte
@@ -70,22 +209,39 @@ CompressionResult HuffmanAlgorithm::compress(const ByteVector& input, const Comp
     }
     
     // Build Huffman tree
-    auto tree = build_tree(frequencies);
-    auto codes = generate_codes(tree.get());
-    
-    // Serialize the tree
-    ByteVector tree_data = serialize_tree(tree.get());
+    std::unordered_map<uint8_t, HuffmanCode> codes;
+    ByteVector tree_data;
+    {
+        utils::TraceSpan tree_span("huffman.build_tree");
+        if (dictionary) {
+            codes = canonical_codes(dictionary_code_lengths(dictionary->frequencies()));
+        } else {
+            auto tree = build_tree(frequencies);
+            codes = generate_codes(tree.get());
+            tree_data = serialize_tree(tree.get());
+        }
+    }
     
     // Compress data
     ByteVector compressed;
-    compressed.push_back(0x02); // Normal Huffman header
-    
-    // Store tree size (2 bytes)
-    compressed.push_back((tree_data.size() >> 8) & 0xFF);
-    compressed.push_back(tree_data.size() & 0xFF);
-    
-    // Store tree
-    compressed.insert(compressed.end(), tree_data.begin(), tree_data.end());
+    if (dictionary) {
+        // Dictionary header: the id replaces the tree
+        uint32_t id = dictionary->id();
+        compressed.push_back(0x03);
+        compressed.push_back((id >> 24) & 0xFF);
+        compressed.push_back((id >> 16) & 0xFF);
+        compressed.push_back((id >> 8) & 0xFF);
+        compressed.push_back(id & 0xFF);
+    } else {
+        compressed.push_back(0x02); // Normal Huffman header
+        
+        // Store tree size (2 bytes)
+        compressed.push_back((tree_data.size() >> 8) & 0xFF);
+        compressed.push_back(tree_data.size() & 0xFF);
+        
+        // Store tree
+        compressed.insert(compressed.end(), tree_data.begin(), tree_data.end());
+    }
     
     // Store original size (4 bytes)
     size_t original_size = input.size();
@@ -95,12 +251,15 @@ CompressionResult HuffmanAlgorithm::compress(const ByteVector& input, const Comp
     compressed.push_back(original_size & 0xFF);
     
     // Encode data
-    BitWriter writer(compressed);
-    for (uint8_t byte : input) {
-        const auto& code = codes[byte];
-        writer.write_bits(code.code, code.length);
+    {
+        utils::TraceSpan encode_span("huffman.encode");
+        BitWriter writer(compressed);
+        for (uint8_t byte : input) {
+            const auto& code = codes[byte];
+            writer.write_bits(code.code, code.length);
+        }
+        writer.flush();
     }
-    writer.flush();
     
     auto end_time = now();
     
@@ -113,7 +272,7 @@ CompressionResult HuffmanAlgorithm::compress(const ByteVector& input, const Comp
     
     if (config.verbose) {
         printf("Huffman compression: %.2f%% (%zu unique bytes)\n", 
-               stats.compression_ratio * 100.0, frequencies.size());
+               stats.compression_ratio * 100.0, dictionary ? codes.size() : frequencies.size());
     }
     
     return result;
@@ -124,6 +283,9 @@ CompressionResult HuffmanAlgorithm::decompress(const ByteVector& input, const Co
         return CompressionResult(false, "Input data is empty");
     }
     
+    utils::TraceSpan span("huffman.decompress");
+    span.arg("bytes", input.size());
+    
     CompressionResult result(true);
     auto& stats = result.stats();
     
@@ -159,7 +321,11 @@ CompressionResult HuffmanAlgorithm::decompress(const ByteVector& input, const Co
             
             // Deserialize tree
             size_t offset = 3;
-            auto tree = deserialize_tree(input, offset);
+            std::unique_ptr<HuffmanNode> tree;
+            {
+                utils::TraceSpan tree_span("huffman.read_tree");
+                tree = deserialize_tree(input, offset);
+            }
             
             // Read original size
             size_t original_size = (static_cast<size_t>(input[offset]) << 24) |
@@ -168,30 +334,30 @@ CompressionResult HuffmanAlgorithm::decompress(const ByteVector& input, const Co
                                   static_cast<size_t>(input[offset + 3]);
             offset += 4;
             
-            // Decode data
-            ByteVector compressed_data(input.begin() + offset, input.end());
-            BitReader reader(compressed_data);
+            decode_symbols(tree.get(), input, offset, original_size, decompressed);
+        } else if (input[0] == 0x03) {
+            // Dictionary Huffman data: canonical code rebuilt from the dictionary
+            if (input.size() < 9) {
+                throw DecompressionException("Invalid Huffman data header");
+            }
             
-            decompressed.reserve(original_size);
+            uint32_t dictionary_id = (static_cast<uint32_t>(input[1]) << 24) |
+                                     (static_cast<uint32_t>(input[2]) << 16) |
+                                     (static_cast<uint32_t>(input[3]) << 8) |
+                                     static_cast<uint32_t>(input[4]);
+            size_t original_size = (static_cast<size_t>(input[5]) << 24) |
+                                  (static_cast<size_t>(input[6]) << 16) |
+                                  (static_cast<size_t>(input[7]) << 8) |
+                                  static_cast<size_t>(input[8]);
             
-            for (size_t i = 0; i < original_size; ++i) {
-                const HuffmanNode* current = tree.get();
-                
-                while (!current->is_leaf()) {
-                    if (!reader.has_more()) {
-                        throw DecompressionException("Unexpected end of compressed data");
-                    }
-                    
-                    uint32_t bit = reader.read_bits(1);
-                    current = bit ? current->right.get() : current->left.get();
-                    
-                    if (!current) {
-                        throw DecompressionException("Invalid Huffman tree traversal");
-                    }
-                }
-                
-                decompressed.push_back(current->byte);
+            std::unique_ptr<HuffmanNode> tree;
+            {
+                utils::TraceSpan tree_span("huffman.read_tree");
+                const auto& frequencies = find_dictionary(dictionary_id)->frequencies();
+                tree = tree_from_codes(canonical_codes(dictionary_code_lengths(frequencies)));
             }
+            
+            decode_symbols(tree.get(), input, 9, original_size, decompressed);
         } else {
             throw DecompressionException("Unknown Huffman format");
         }
@@ -205,6 +371,7 @@ CompressionResult HuffmanAlgorithm::decompress(const ByteVector& input, const Co
         stats.threads_used = 1;
         
         if (config.verify_integrity) {
+            utils::TraceSpan checksum_span("huffman.checksum");
             stats.checksum = utils::CRC32::calculate(decompressed);
         }
         
@@ -221,10 +388,7 @@ double HuffmanAlgorithm::estimate_ratio(const ByteVector& input) const {
     if (input.empty()) return 1.0;
     
     // Count frequencies
-    std::unordered_map<uint8_t, size_t> frequencies;
-    for (uint8_t byte : input) {
-        frequencies[byte]++;
-    }
+    auto frequencies = count_frequencies(input);
     
     // Calculate theoretical Huffman compression size
     double entropy = calculate_entropy(frequencies, input.size());
@@ -336,6 +500,34 @@ std::unique_ptr<HuffmanNode> HuffmanAlgorithm::deserialize_tree(const ByteVector
     }
 }
 
+void HuffmanAlgorithm::decode_symbols(const HuffmanNode* tree, const ByteVector& input, size_t offset,
+                                      size_t original_size, ByteVector& output) {
+    ByteVector compressed_data(input.begin() + offset, input.end());
+    BitReader reader(compressed_data);
+    
+    output.reserve(original_size);
+    
+    utils::TraceSpan decode_span("huffman.decode");
+    for (size_t i = 0; i < original_size; ++i) {
+        const HuffmanNode* current = tree;
+        
+        while (!current->is_leaf()) {
+            if (!reader.has_more()) {
+                throw DecompressionException("Unexpected end of compressed data");
+            }
+            
+            uint32_t bit = reader.read_bits(1);
+            current = bit ? current->right.get() : current->left.get();
+            
+            if (!current) {
+                throw DecompressionException("Invalid Huffman tree traversal");
+            }
+        }
+        
+        output.push_back(current->byte);
+    }
+}
+
 void HuffmanAlgorithm::BitWriter::write_bits(uint32_t value, uint8_t count) {
     while (count > 0) {
         uint8_t bits_to_write = std::min(count, static_cast<uint8_t>(8 - bits_used_));
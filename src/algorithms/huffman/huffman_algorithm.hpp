@@ -58,6 +58,10 @@ private:
     ByteVector serialize_tree(const HuffmanNode* root);
     std::unique_ptr<HuffmanNode> deserialize_tree(const ByteVector& data, size_t& offset);
     
+    // Decode `original_size` symbols from the bit stream at input[offset..]
+    void decode_symbols(const HuffmanNode* tree, const ByteVector& input, size_t offset,
+                        size_t original_size, ByteVector& output);
+    
     // Bit manipulation utilities
     class BitWriter {
     public:
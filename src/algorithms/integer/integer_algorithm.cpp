@@ -0,0 +1,566 @@
+#include "algorithms/integer/integer_algorithm.hpp"
+#include "utils/crc.hpp"
+#include "utils/kernels.hpp"
+#include "utils/tracing.hpp"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+namespace compressor {
+
+namespace {
+
+using utils::Kernels;
+
+constexpr size_t BLOCK = Kernels::PACK_BLOCK;
+
+constexpr uint8_t MODE_FOR = 0;        // value - block minimum
+constexpr uint8_t MODE_DELTA = 1;      // zigzag(value - previous value)
+constexpr uint8_t MODE_DELTA_FOR = 2;  // value - previous value - smallest such delta
+constexpr uint8_t MODE_STORED = 3;     // raw values, for blocks that do not pack smaller
+
+// Residual bits kept in the packed array; the rest go to exceptions
+constexpr unsigned MAX_PACKED_BITS = 32;
+
+// "INTC" | width | value count | tail length
+constexpr size_t FIXED_HEADER_SIZE = 4 + 1 + 8 + 1;
+
+struct Header {
+    size_t width;
+    uint64_t count;
+    size_t tail_offset;
+    size_t tail_length;
+    uint32_t block_count;
+    size_t table_offset;
+    size_t blocks_offset;
+};
+
+uint32_t get_u32(const uint8_t* data) {
+    return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16) |
+           (static_cast<uint32_t>(data[2]) << 8) | static_cast<uint32_t>(data[3]);
+}
+
+void put_u32(ByteVector& out, uint32_t value) {
+    out.push_back((value >> 24) & 0xFF);
+    out.push_back((value >> 16) & 0xFF);
+    out.push_back((value >> 8) & 0xFF);
+    out.push_back(value & 0xFF);
+}
+
+Header read_header(const ByteVector& input) {
+    if (input.size() < FIXED_HEADER_SIZE || input[0] != 'I' || input[1] != 'N' ||
+        input[2] != 'T' || input[3] != 'C') {
+        throw DecompressionException("Invalid integer compression signature");
+    }
+
+    Header header;
+    header.width = input[4];
+    if (header.width != 4 && header.width != 8) {
+        throw DecompressionException("Unsupported integer width " + std::to_string(header.width));
+    }
+    header.count = (static_cast<uint64_t>(get_u32(&input[5])) << 32) | get_u32(&input[9]);
+    header.tail_length = input[13];
+    header.tail_offset = FIXED_HEADER_SIZE;
+    header.table_offset = header.tail_offset + header.tail_length + 4;
+    if (header.tail_length >= header.width || header.table_offset > input.size()) {
+        throw DecompressionException("Invalid integer compression header");
+    }
+
+    header.block_count = get_u32(&input[header.table_offset - 4]);
+    if (header.count > static_cast<uint64_t>(std::numeric_limits<uint32_t>::max()) * BLOCK ||
+        header.block_count != (header.count + BLOCK - 1) / BLOCK ||
+        header.block_count > (input.size() - header.table_offset) / 4) {
+        throw DecompressionException("Invalid integer block count");
+    }
+    header.blocks_offset = header.table_offset + static_cast<size_t>(header.block_count) * 4;
+    return header;
+}
+
+template<typename T>
+unsigned bit_length(T value) {
+    if (value == 0) {
+        return 0;
+    }
+    return sizeof(T) == 8 ? 64 - __builtin_clzll(static_cast<unsigned long long>(value))
+                          : 32 - __builtin_clz(static_cast<unsigned>(value));
+}
+
+template<typename T>
+T zigzag(T delta) {
+    using Signed = typename std::make_signed<T>::type;
+    return static_cast<T>(delta << 1) ^ static_cast<T>(static_cast<Signed>(delta) >> (sizeof(T) * 8 - 1));
+}
+
+template<typename T>
+T unzigzag(T value) {
+    return (value >> 1) ^ (T(0) - (value & 1));
+}
+
+// LSB-first bit stream for the exceptions' high bits
+void put_bits(ByteVector& out, size_t& bit_pos, uint64_t value, unsigned bits) {
+    while (bits > 0) {
+        unsigned used = bit_pos % 8;
+        if (used == 0) {
+            out.push_back(0);
+        }
+        unsigned take = std::min(bits, 8 - used);
+        out.back() |= static_cast<uint8_t>((value & ((1u << take) - 1)) << used);
+        value >>= take;
+        bits -= take;
+        bit_pos += take;
+    }
+}
+
+uint64_t get_bits(const uint8_t* data, size_t& bit_pos, unsigned bits) {
+    uint64_t value = 0;
+    unsigned filled = 0;
+    while (filled < bits) {
+        unsigned used = bit_pos % 8;
+        unsigned take = std::min(bits - filled, 8 - used);
+        uint64_t chunk = (data[bit_pos / 8] >> used) & ((1u << take) - 1);
+        value |= chunk << filled;
+        filled += take;
+        bit_pos += take;
+    }
+    return value;
+}
+
+// Packed width and exception layout for one block of residuals
+struct Plan {
+    unsigned bits;
+    unsigned exception_bits;
+    size_t exceptions;
+    size_t bytes;
+};
+
+template<typename T>
+Plan plan_block(const T* residuals) {
+    size_t histogram[65] = {};
+    for (size_t i = 0; i < BLOCK; ++i) {
+        histogram[bit_length(residuals[i])]++;
+    }
+    unsigned max_bits = 64;
+    while (max_bits > 0 && histogram[max_bits] == 0) {
+        --max_bits;
+    }
+
+    // Every packed bit costs 128 bits, so a few wide outliers are cheaper
+    // as exceptions (a position byte plus their high bits). Scanning from
+    // the widest width keeps ties on the version with fewer exceptions.
+    Plan best = {0, 0, 0, SIZE_MAX};
+    size_t exceptions = 0;
+    for (unsigned b = max_bits; ; --b) {
+        if (b <= MAX_PACKED_BITS) {
+            size_t bytes = 16 * b + exceptions + (exceptions * (max_bits - b) + 7) / 8;
+            if (bytes < best.bytes) {
+                best = {b, max_bits - b, exceptions, bytes};
+            }
+        }
+        if (b == 0) {
+            break;
+        }
+        exceptions += histogram[b];
+    }
+    return best;
+}
+
+template<typename T>
+void put_value(ByteVector& out, T value) {
+    for (size_t i = sizeof(T); i-- > 0; ) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+template<typename T>
+T get_value(const uint8_t* data) {
+    T value = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        value = static_cast<T>((static_cast<uint64_t>(value) << 8) | data[i]);
+    }
+    return value;
+}
+
+template<typename T>
+void encode_block(const T* values, size_t count, ByteVector& out) {
+    using Signed = typename std::make_signed<T>::type;
+    T residuals[3][BLOCK] = {};
+
+    // Frame of reference suits unordered values in a narrow range, zigzag
+    // deltas slowly varying ones with outliers in both directions, and
+    // deltas against the smallest delta sorted ids and ticking timestamps
+    T minimum = *std::min_element(values, values + count);
+    T min_delta = 0;
+    for (size_t i = 0; i < count; ++i) {
+        residuals[MODE_FOR][i] = values[i] - minimum;
+    }
+    for (size_t i = 1; i < count; ++i) {
+        T delta = values[i] - values[i - 1];
+        residuals[MODE_DELTA][i] = zigzag(delta);
+        if (i == 1 || static_cast<Signed>(delta) < static_cast<Signed>(min_delta)) {
+            min_delta = delta;
+        }
+    }
+    for (size_t i = 1; i < count; ++i) {
+        residuals[MODE_DELTA_FOR][i] = values[i] - values[i - 1] - min_delta;
+    }
+
+    // Frame of reference decodes without a prefix sum, so it wins ties
+    uint8_t mode = MODE_FOR;
+    Plan plan = plan_block(residuals[MODE_FOR]);
+    size_t best_bytes = plan.bytes;
+    for (uint8_t candidate : {MODE_DELTA, MODE_DELTA_FOR}) {
+        Plan candidate_plan = plan_block(residuals[candidate]);
+        // MODE_DELTA_FOR also stores its smallest delta
+        size_t bytes = candidate_plan.bytes + (candidate == MODE_DELTA_FOR ? sizeof(T) : 0);
+        if (bytes < best_bytes) {
+            mode = candidate;
+            plan = candidate_plan;
+            best_bytes = bytes;
+        }
+    }
+
+    // Full-range 64-bit values would all be exceptions
+    if (1 + count * sizeof(T) <= 4 + sizeof(T) + best_bytes) {
+        out.push_back(MODE_STORED);
+        const uint8_t* raw = reinterpret_cast<const uint8_t*>(values);
+        out.insert(out.end(), raw, raw + count * sizeof(T));
+        return;
+    }
+    const T* chosen = residuals[mode];
+
+    out.push_back(mode);
+    out.push_back(static_cast<uint8_t>(plan.bits));
+    out.push_back(static_cast<uint8_t>(plan.exceptions));
+    out.push_back(static_cast<uint8_t>(plan.exception_bits));
+    put_value(out, mode == MODE_FOR ? minimum : values[0]);
+    if (mode == MODE_DELTA_FOR) {
+        put_value(out, min_delta);
+    }
+
+    uint32_t low[BLOCK];
+    for (size_t i = 0; i < BLOCK; ++i) {
+        low[i] = static_cast<uint32_t>(chosen[i]);
+    }
+    size_t packed_offset = out.size();
+    out.resize(packed_offset + 16 * plan.bits);
+    Kernels::pack128(low, out.data() + packed_offset, plan.bits);
+
+    if (plan.exceptions > 0) {
+        for (size_t i = 0; i < BLOCK; ++i) {
+            if (bit_length(chosen[i]) > plan.bits) {
+                out.push_back(static_cast<uint8_t>(i));
+            }
+        }
+        size_t bit_pos = 0;
+        for (size_t i = 0; i < BLOCK; ++i) {
+            if (bit_length(chosen[i]) > plan.bits) {
+                put_bits(out, bit_pos, static_cast<uint64_t>(chosen[i]) >> plan.bits, plan.exception_bits);
+            }
+        }
+    }
+}
+
+// Decode the block at data[0..size) into `values` (BLOCK entries, the first
+// `count` meaningful)
+template<typename T>
+void decode_block(const uint8_t* data, size_t size, size_t count, T* values) {
+    if (size >= 1 && data[0] == MODE_STORED) {
+        if (size - 1 < count * sizeof(T)) {
+            throw DecompressionException("Incomplete integer block");
+        }
+        std::memcpy(values, data + 1, count * sizeof(T));
+        return;
+    }
+    if (size < 4) {
+        throw DecompressionException("Incomplete integer block header");
+    }
+    uint8_t mode = data[0];
+    unsigned bits = data[1];
+    size_t exceptions = data[2];
+    unsigned exception_bits = data[3];
+    if (mode > MODE_DELTA_FOR || bits > MAX_PACKED_BITS || exceptions > BLOCK ||
+        bits + exception_bits > sizeof(T) * 8) {
+        throw DecompressionException("Invalid integer block header");
+    }
+
+    size_t header_size = 4 + (mode == MODE_DELTA_FOR ? 2 : 1) * sizeof(T);
+    if (size < header_size ||
+        size - header_size < 16 * bits + exceptions + (exceptions * exception_bits + 7) / 8) {
+        throw DecompressionException("Incomplete integer block");
+    }
+    T reference = get_value<T>(data + 4);
+    T min_delta = mode == MODE_DELTA_FOR ? get_value<T>(data + 4 + sizeof(T)) : 0;
+
+    const uint8_t* packed = data + header_size;
+    const uint8_t* positions = packed + 16 * bits;
+    const uint8_t* high_bits = positions + exceptions;
+
+    if (sizeof(T) == sizeof(uint32_t)) {
+        Kernels::unpack128(packed, reinterpret_cast<uint32_t*>(values), bits);
+    } else {
+        uint32_t low[BLOCK];
+        Kernels::unpack128(packed, low, bits);
+        for (size_t i = 0; i < BLOCK; ++i) {
+            values[i] = low[i];
+        }
+    }
+
+    size_t bit_pos = 0;
+    for (size_t e = 0; e < exceptions; ++e) {
+        if (positions[e] >= BLOCK) {
+            throw DecompressionException("Invalid integer exception position");
+        }
+        values[positions[e]] |= static_cast<T>(get_bits(high_bits, bit_pos, exception_bits) << bits);
+    }
+
+    if (mode == MODE_FOR) {
+        for (size_t i = 0; i < count; ++i) {
+            values[i] += reference;
+        }
+        return;
+    }
+
+    // The first residual is 0, so starting one step early yields the
+    // reference as the first value
+    if (mode == MODE_DELTA) {
+        for (size_t i = 0; i < count; ++i) {
+            values[i] = unzigzag(values[i]);
+        }
+    }
+    T initial = reference - min_delta;
+    if (sizeof(T) == sizeof(uint32_t)) {
+        Kernels::prefix_sum32(reinterpret_cast<uint32_t*>(values), count,
+                              static_cast<uint32_t>(initial), static_cast<uint32_t>(min_delta));
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            initial += values[i] + min_delta;
+            values[i] = initial;
+        }
+    }
+}
+
+template<typename T>
+ByteVector encode_values(const ByteVector& input, uint64_t count, std::vector<uint32_t>& offsets) {
+    ByteVector blocks;
+    blocks.reserve(input.size() / 2);
+    T values[BLOCK];
+
+    for (uint64_t start = 0; start < count; start += BLOCK) {
+        size_t n = static_cast<size_t>(std::min<uint64_t>(BLOCK, count - start));
+        if (blocks.size() > std::numeric_limits<uint32_t>::max()) {
+            throw std::length_error("Input too large for integer block offsets");
+        }
+        offsets.push_back(static_cast<uint32_t>(blocks.size()));
+        std::memcpy(values, input.data() + start * sizeof(T), n * sizeof(T));
+        encode_block(values, n, blocks);
+    }
+    return blocks;
+}
+
+// Append bytes [offset, end) of the original data to `output`
+template<typename T>
+void decode_values(const ByteVector& input, const Header& header, uint64_t offset, uint64_t end,
+                   ByteVector& output) {
+    const uint64_t value_bytes = header.count * sizeof(T);
+    T values[BLOCK];
+
+    if (offset < value_bytes) {
+        uint64_t first_block = offset / sizeof(T) / BLOCK;
+        uint64_t last_block = (std::min(end, value_bytes) - 1) / sizeof(T) / BLOCK;
+        size_t blocks_size = input.size() - header.blocks_offset;
+
+        for (uint64_t block = first_block; block <= last_block; ++block) {
+            const uint8_t* entry = &input[header.table_offset + block * 4];
+            size_t block_offset = get_u32(entry);
+            size_t block_end = block + 1 < header.block_count ? get_u32(entry + 4) : blocks_size;
+            if (block_offset > block_end || block_end > blocks_size) {
+                throw DecompressionException("Invalid integer block offset");
+            }
+
+            uint64_t block_start = block * BLOCK;
+            size_t n = static_cast<size_t>(std::min<uint64_t>(BLOCK, header.count - block_start));
+            decode_block(input.data() + header.blocks_offset + block_offset, block_end - block_offset,
+                         n, values);
+
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(values);
+            uint64_t byte_start = block_start * sizeof(T);
+            size_t from = offset > byte_start ? static_cast<size_t>(offset - byte_start) : 0;
+            size_t to = static_cast<size_t>(std::min<uint64_t>(n * sizeof(T), end - byte_start));
+            output.insert(output.end(), bytes + from, bytes + to);
+        }
+    }
+
+    // Trailing bytes that do not fill an element are stored as is
+    if (end > value_bytes) {
+        size_t from = offset > value_bytes ? static_cast<size_t>(offset - value_bytes) : 0;
+        size_t to = static_cast<size_t>(end - value_bytes);
+        const uint8_t* tail = input.data() + header.tail_offset;
+        output.insert(output.end(), tail + from, tail + to);
+    }
+}
+
+ByteVector decode_range(const ByteVector& input, size_t offset, size_t length) {
+    Header header = read_header(input);
+    uint64_t total = header.count * header.width + header.tail_length;
+
+    ByteVector output;
+    if (offset >= total || length == 0) {
+        return output;
+    }
+    uint64_t end = length > total - offset ? total : offset + length;
+    output.reserve(static_cast<size_t>(end - offset));
+
+    if (header.width == 4) {
+        decode_values<uint32_t>(input, header, offset, end, output);
+    } else {
+        decode_values<uint64_t>(input, header, offset, end, output);
+    }
+    return output;
+}
+
+} // namespace
+
+IntegerAlgorithm::IntegerAlgorithm(size_t width) : width_(width == 8 ? 8 : 4) {}
+
+AlgorithmInfo IntegerAlgorithm::get_info() const {
+    return AlgorithmInfo(
+        width_ == 8 ? "int64" : "int32",
+        "Integer arrays - frame of reference or delta coding, bit-packed with patched exceptions",
+        false,
+        BLOCK * width_
+    );
+}
+
+CompressionResult IntegerAlgorithm::compress(const ByteVector& input, const CompressionConfig& config) {
+    if (input.empty()) {
+        return CompressionResult(false, "Input data is empty");
+    }
+
+    utils::TraceSpan span("integer.compress");
+    span.arg("bytes", input.size());
+
+    CompressionResult result(true);
+    auto& stats = result.stats();
+
+    stats.original_size = input.size();
+    if (config.verify_integrity) {
+        utils::TraceSpan checksum_span("integer.checksum");
+        stats.checksum = utils::CRC32::calculate(input);
+    }
+
+    auto start_time = now();
+
+    uint64_t count = input.size() / width_;
+    size_t tail_length = input.size() % width_;
+
+    std::vector<uint32_t> offsets;
+    ByteVector blocks;
+    try {
+        utils::TraceSpan encode_span("integer.encode");
+        blocks = width_ == 8 ? encode_values<uint64_t>(input, count, offsets)
+                             : encode_values<uint32_t>(input, count, offsets);
+    } catch (const std::exception& e) {
+        return CompressionResult(false, e.what());
+    }
+
+    ByteVector compressed;
+    compressed.reserve(FIXED_HEADER_SIZE + tail_length + 4 + offsets.size() * 4 + blocks.size());
+    compressed.push_back('I');
+    compressed.push_back('N');
+    compressed.push_back('T');
+    compressed.push_back('C');
+    compressed.push_back(static_cast<uint8_t>(width_));
+    put_u32(compressed, static_cast<uint32_t>(count >> 32));
+    put_u32(compressed, static_cast<uint32_t>(count));
+    compressed.push_back(static_cast<uint8_t>(tail_length));
+    compressed.insert(compressed.end(), input.end() - tail_length, input.end());
+    put_u32(compressed, static_cast<uint32_t>(offsets.size()));
+    for (uint32_t offset : offsets) {
+        put_u32(compressed, offset);
+    }
+    compressed.insert(compressed.end(), blocks.begin(), blocks.end());
+
+    auto end_time = now();
+
+    stats.compressed_size = compressed.size();
+    stats.compression_ratio = static_cast<double>(stats.compressed_size) / stats.original_size;
+    stats.compression_time_ms = duration_ms(start_time, end_time);
+    stats.threads_used = 1;
+
+    result.set_data(std::move(compressed));
+
+    if (config.verbose) {
+        printf("Integer compression: %.2f%% (%llu values of %zu bytes, %zu blocks)\n",
+               stats.compression_ratio * 100.0, static_cast<unsigned long long>(count), width_,
+               offsets.size());
+    }
+
+    return result;
+}
+
+CompressionResult IntegerAlgorithm::decompress(const ByteVector& input, const CompressionConfig& config) {
+    if (input.empty()) {
+        return CompressionResult(false, "Input data is empty");
+    }
+    return decompress_range(input, 0, SIZE_MAX, config);
+}
+
+CompressionResult IntegerAlgorithm::decompress_range(const ByteVector& input, size_t offset, size_t length,
+                                                     const CompressionConfig& config) {
+    utils::TraceSpan span("integer.decompress");
+    span.arg("bytes", input.size());
+
+    CompressionResult result(true);
+    auto& stats = result.stats();
+
+    auto start_time = now();
+
+    ByteVector decompressed;
+    try {
+        utils::TraceSpan decode_span("integer.decode");
+        decompressed = decode_range(input, offset, length);
+    } catch (const std::exception& e) {
+        return CompressionResult(false, "Decompression failed: " + std::string(e.what()));
+    }
+
+    auto end_time = now();
+
+    stats.original_size = decompressed.size();
+    stats.compressed_size = input.size();
+    stats.compression_ratio = stats.original_size ?
+        static_cast<double>(stats.compressed_size) / stats.original_size : 0.0;
+    stats.decompression_time_ms = duration_ms(start_time, end_time);
+    stats.threads_used = 1;
+
+    if (config.verify_integrity) {
+        utils::TraceSpan checksum_span("integer.checksum");
+        stats.checksum = utils::CRC32::calculate(decompressed);
+    }
+
+    result.set_data(std::move(decompressed));
+    return result;
+}
+
+size_t IntegerAlgorithm::original_size(const ByteVector& input) {
+    Header header = read_header(input);
+    return static_cast<size_t>(header.count * header.width + header.tail_length);
+}
+
+double IntegerAlgorithm::estimate_ratio(const ByteVector& input) const {
+    // Encode the first few blocks
+    size_t sample = std::min(input.size(), 16 * BLOCK * width_);
+    uint64_t count = sample / width_;
+    if (count == 0) {
+        return 1.0;
+    }
+
+    std::vector<uint32_t> offsets;
+    ByteVector sample_data(input.begin(), input.begin() + sample);
+    ByteVector blocks = width_ == 8 ? encode_values<uint64_t>(sample_data, count, offsets)
+                                    : encode_values<uint32_t>(sample_data, count, offsets);
+    return static_cast<double>(blocks.size() + offsets.size() * 4) / (count * width_);
+}
+
+} // namespace compressor
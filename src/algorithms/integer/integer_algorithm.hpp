@@ -0,0 +1,51 @@
+#ifndef COMPRESSOR_INTEGER_ALGORITHM_HPP
+#define COMPRESSOR_INTEGER_ALGORITHM_HPP
+
+#include "core/algorithm.hpp"
+
+namespace compressor {
+
+// Codec for arrays of 32- or 64-bit integers in native byte order, such as
+// sorted ids and timestamps. Each block of 128 values is coded as residuals
+// against a reference: frame of reference (value - block minimum), zigzagged
+// deltas, or deltas minus the block's smallest delta, whichever packs
+// smallest. Residuals are bit-packed at the width that minimizes the block
+// size, and the few that do not fit are patched in as exceptions (PFOR).
+// Blocks that would not shrink keep their raw values. A block offset table
+// gives random access.
+//
+// Format: "INTC" | element width | value count (8) | tail length | tail
+// bytes | block count (4) | block offsets (4 each) | blocks. Each block is
+// mode | bit width | exception count | exception width | reference |
+// [smallest delta] | packed residuals | exception positions | exception
+// high bits, or a stored mode byte followed by the raw values.
+class IntegerAlgorithm : public Algorithm {
+public:
+    // `width` is the element size in bytes, 4 or 8
+    explicit IntegerAlgorithm(size_t width = 4);
+    
+    AlgorithmInfo get_info() const override;
+    
+    CompressionResult compress(const ByteVector& input, 
+                             const CompressionConfig& config = CompressionConfig()) override;
+    
+    CompressionResult decompress(const ByteVector& input,
+                               const CompressionConfig& config = CompressionConfig()) override;
+    
+    double estimate_ratio(const ByteVector& input) const override;
+    
+    // Decompress only bytes [offset, offset + length) of the original data,
+    // decoding just the blocks that hold them
+    CompressionResult decompress_range(const ByteVector& input, size_t offset, size_t length,
+                                       const CompressionConfig& config = CompressionConfig());
+    
+    // Original data size, read from the header without decoding
+    static size_t original_size(const ByteVector& input);
+
+private:
+    size_t width_;
+};
+
+} // namespace compressor
+
+#endif // COMPRESSOR_INTEGER_ALGORITHM_HPP
@@ -1,5 +1,8 @@
 #include "algorithms/lz77/lz77_algorithm.hpp"
 #include "utils/crc.hpp"
+#include "utils/dictionary.hpp"
+#include "utils/kernels.hpp"
+#include "utils/tracing.hpp"
 #include <algorithm>
 #include <cstring>
 
@@ -19,11 +22,24 @@ CompressionResult LZ77Algorithm::compress(const ByteVector& input, const Compres
         return CompressionResult(false, "Input data is empty");
     }
     
+    std::shared_ptr<const utils::Dictionary> dictionary;
+    if (config.dictionary_id != utils::Dictionary::NONE) {
+        dictionary = utils::DictionaryRegistry::instance().find(config.dictionary_id);
+        if (!dictionary) {
+            return CompressionResult(false, "Dictionary " + utils::Dictionary::format_id(config.dictionary_id) +
+                                            " is not loaded");
+        }
+    }
+    
+    utils::TraceSpan span("lz77.compress");
+    span.arg("bytes", input.size());
+    
     CompressionResult result(true);
     auto& stats = result.stats();
     
     stats.original_size = input.size();
     if (config.verify_integrity) {
+        utils::TraceSpan checksum_span("lz77.checksum");
         stats.checksum = utils::CRC32::calculate(input);
     }
     
@@ -32,48 +48,67 @@ CompressionResult LZ77Algorithm::compress(const ByteVector& input, const Compres
     std::vector<LZ77Match> matches;
     matches.reserve(input.size() / 2);
     
-    size_t pos = 0;
-    while (pos < input.size()) {
-        LZ77Match best_match;
-        best_match.distance = 0;
-        best_match.length = 0;
-        best_match.next_char = (pos < input.size()) ? input[pos] : 0;
-        
-        // Search for matches in the sliding window
-        size_t window_start = (pos >= WINDOW_SIZE) ? pos - WINDOW_SIZE : 0;
-        
-        for (size_t search_pos = window_start; search_pos < pos; ++search_pos) {
-            size_t match_length = 0;
+    // A dictionary primes the window: matches are searched over the
+    // dictionary followed by the input, and only the input is encoded
+    ByteVector primed;
+    size_t begin = 0;
+    if (dictionary) {
+        primed.reserve(dictionary->content().size() + input.size());
+        primed.assign(dictionary->content().begin(), dictionary->content().end());
+        primed.insert(primed.end(), input.begin(), input.end());
+        begin = dictionary->content().size();
+    }
+    const ByteVector& data = dictionary ? primed : input;
+    
+    {
+        utils::TraceSpan match_span("lz77.match");
+        size_t pos = begin;
+        while (pos < data.size()) {
+            LZ77Match best_match;
+            best_match.distance = 0;
+            best_match.length = 0;
+            best_match.next_char = (pos < data.size()) ? data[pos] : 0;
+            
+            // Search for matches in the sliding window
+            size_t window_start = (pos >= WINDOW_SIZE) ? pos - WINDOW_SIZE : 0;
             
-            // Count matching characters
-            while (search_pos + match_length < pos && 
-                   pos + match_length < input.size() &&
-                   input[search_pos + match_length] == input[pos + match_length] &&
-                   match_length < MAX_MATCH_LENGTH) {
-                match_length++;
+            // A match always leaves room for next_char
+            size_t remaining = data.size() - pos - 1;
+            for (size_t search_pos = window_start; search_pos < pos; ++search_pos) {
+                // Most candidates fail on the first byte; skip the kernel call for those
+                if (data[search_pos] != data[pos]) continue;
+                
+                // Count matching characters
+                size_t limit = std::min({pos - search_pos, remaining, MAX_MATCH_LENGTH});
+                size_t match_length = utils::Kernels::match_length(&data[search_pos], &data[pos], limit);
+                
+                // Update best match if this is better
+                if (match_length >= MIN_MATCH_LENGTH && match_length > best_match.length) {
+                    best_match.distance = pos - search_pos;
+                    best_match.length = match_length;
+                    best_match.next_char = (pos + match_length < data.size()) ? 
+                                          data[pos + match_length] : 0;
+                }
             }
             
-            // Update best match if this is better
-            if (match_length >= MIN_MATCH_LENGTH && match_length > best_match.length) {
-                best_match.distance = pos - search_pos;
-                best_match.length = match_length;
-                best_match.next_char = (pos + match_length < input.size()) ? 
-                                      input[pos + match_length] : 0;
+            matches.push_back(best_match);
+            
+            // Advance position
+            if (best_match.length > 0) {
+                pos += best_match.length + 1; // Skip matched bytes + next char
+            } else {
+                pos++; // Just the literal character
             }
         }
-        
-        matches.push_back(best_match);
-        
-        // Advance position
-        if (best_match.length > 0) {
-            pos += best_match.length + 1; // Skip matched bytes + next char
-        } else {
-            pos++; // Just the literal character
-        }
     }
     
     // Encode matches
-    ByteVector compressed = encode_matches(matches);
+    ByteVector compressed;
+    {
+        utils::TraceSpan encode_span("lz77.encode");
+        encode_span.arg("matches", matches.size());
+        compressed = encode_matches(matches, config.dictionary_id);
+    }
     
     auto end_time = now();
     
@@ -97,6 +132,9 @@ CompressionResult LZ77Algorithm::decompress(const ByteVector& input, const Compr
         return CompressionResult(false, "Input data is empty");
     }
     
+    utils::TraceSpan span("lz77.decompress");
+    span.arg("bytes", input.size());
+    
     CompressionResult result(true);
     auto& stats = result.stats();
     
@@ -104,38 +142,61 @@ CompressionResult LZ77Algorithm::decompress(const ByteVector& input, const Compr
     
     try {
         // Decode matches
-        auto matches = decode_matches(input);
+        std::vector<LZ77Match> matches;
+        uint32_t dictionary_id = utils::Dictionary::NONE;
+        {
+            utils::TraceSpan parse_span("lz77.parse");
+            matches = decode_matches(input, dictionary_id);
+        }
         
-        // Reconstruct original data
+        // Reconstruct original data after the dictionary, if one was used
         ByteVector decompressed;
-        decompressed.reserve(input.size() * 3);
+        size_t prefix = 0;
+        if (dictionary_id != utils::Dictionary::NONE) {
+            auto dictionary = utils::DictionaryRegistry::instance().find(dictionary_id);
+            if (!dictionary) {
+                throw DecompressionException("Dictionary " + utils::Dictionary::format_id(dictionary_id) +
+                                             " is not loaded");
+            }
+            prefix = dictionary->content().size();
+            decompressed.reserve(prefix + input.size() * 3);
+            decompressed.assign(dictionary->content().begin(), dictionary->content().end());
+        } else {
+            decompressed.reserve(input.size() * 3);
+        }
         
-        for (const auto& match : matches) {
-            if (match.is_literal()) {
-                // Just add the literal character
-                decompressed.push_back(match.next_char);
-            } else {
-                // Copy from sliding window
-                if (match.distance > decompressed.size()) {
-                    throw DecompressionException("Invalid LZ77 match distance: " + 
-                                               std::to_string(match.distance) + 
-                                               " > " + std::to_string(decompressed.size()));
-                }
-                
-                size_t start_pos = decompressed.size() - match.distance;
-                
-                // Copy match.length bytes
-                for (uint16_t i = 0; i < match.length; ++i) {
-                    if (start_pos + i >= decompressed.size()) {
-                        throw DecompressionException("Invalid copy position in LZ77");
+        {
+            utils::TraceSpan copy_span("lz77.copy");
+            for (const auto& match : matches) {
+                if (match.is_literal()) {
+                    // Just add the literal character
+                    decompressed.push_back(match.next_char);
+                } else {
+                    // Copy from sliding window
+                    if (match.distance > decompressed.size()) {
+                        throw DecompressionException("Invalid LZ77 match distance: " + 
+                                                   std::to_string(match.distance) + 
+                                                   " > " + std::to_string(decompressed.size()));
                     }
-                    decompressed.push_back(decompressed[start_pos + i]);
+                    
+                    size_t start_pos = decompressed.size() - match.distance;
+                    
+                    // Copy match.length bytes
+                    for (uint16_t i = 0; i < match.length; ++i) {
+                        if (start_pos + i >= decompressed.size()) {
+                            throw DecompressionException("Invalid copy position in LZ77");
+                        }
+                        decompressed.push_back(decompressed[start_pos + i]);
+                    }
+                    
+                    // Add next character
+                    decompressed.push_back(match.next_char);
                 }
-                
-                // Add next character
-                decompressed.push_back(match.next_char);
             }
         }
+        if (prefix > 0) {
+            decompressed.erase(decompressed.begin(), decompressed.begin() + prefix);
+        }
         
         auto end_time = now();
         
@@ -146,6 +207,7 @@ CompressionResult LZ77Algorithm::decompress(const ByteVector& input, const Compr
         stats.threads_used = 1;
         
         if (config.verify_integrity) {
+            utils::TraceSpan checksum_span("lz77.checksum");
             stats.checksum = utils::CRC32::calculate(decompressed);
         }
         
@@ -193,14 +255,10 @@ LZ77Match LZ77Algorithm::find_longest_match(const ByteVector& input, size_t posi
     
     // Search in the sliding window
     for (size_t i = window_start; i < position; ++i) {
-        uint8_t match_length = 0;
         size_t max_length = std::min(LOOKAHEAD_SIZE, input.size() - position);
         
         // Count matching bytes
-        while (match_length < max_length && 
-               input[i + match_length] == input[position + match_length]) {
-            match_length++;
-        }
+        uint8_t match_length = static_cast<uint8_t>(utils::Kernels::match_length(&input[i], &input[position], max_length));
         
         // Update best match if this is longer
         if (match_length >= MIN_MATCH_LENGTH && match_length > best_length) {
@@ -217,15 +275,23 @@ LZ77Match LZ77Algorithm::find_longest_match(const ByteVector& input, size_t posi
     return LZ77Match(); // Return literal
 }
 
-ByteVector LZ77Algorithm::encode_matches(const std::vector<LZ77Match>& matches) {
+ByteVector LZ77Algorithm::encode_matches(const std::vector<LZ77Match>& matches, uint32_t dictionary_id) {
     ByteVector encoded;
     encoded.reserve(matches.size() * 4); // Conservative estimate
     
-    // Header: LZ77 signature and match count
+    // Header: LZ77 signature ("LZ7D" plus dictionary id when primed) and match count
     encoded.push_back('L');
     encoded.push_back('Z');
     encoded.push_back('7');
-    encoded.push_back('7');
+    if (dictionary_id != utils::Dictionary::NONE) {
+        encoded.push_back('D');
+        encoded.push_back((dictionary_id >> 24) & 0xFF);
+        encoded.push_back((dictionary_id >> 16) & 0xFF);
+        encoded.push_back((dictionary_id >> 8) & 0xFF);
+        encoded.push_back(dictionary_id & 0xFF);
+    } else {
+        encoded.push_back('7');
+    }
     
     uint32_t match_count = matches.size();
     encoded.push_back((match_count >> 24) & 0xFF);
@@ -250,26 +316,40 @@ ByteVector LZ77Algorithm::encode_matches(const std::vector<LZ77Match>& matches)
     return encoded;
 }
 
-std::vector<LZ77Match> LZ77Algorithm::decode_matches(const ByteVector& encoded) {
+std::vector<LZ77Match> LZ77Algorithm::decode_matches(const ByteVector& encoded, uint32_t& dictionary_id) {
     if (encoded.size() < 8) {
         throw DecompressionException("Invalid LZ77 header");
     }
     
     // Check signature
-    if (encoded[0] != 'L' || encoded[1] != 'Z' || encoded[2] != '7' || encoded[3] != '7') {
+    if (encoded[0] != 'L' || encoded[1] != 'Z' || encoded[2] != '7' ||
+        (encoded[3] != '7' && encoded[3] != 'D')) {
         throw DecompressionException("Invalid LZ77 signature");
     }
     
+    size_t offset = 4;
+    dictionary_id = utils::Dictionary::NONE;
+    if (encoded[3] == 'D') {
+        if (encoded.size() < 12) {
+            throw DecompressionException("Invalid LZ77 header");
+        }
+        dictionary_id = (static_cast<uint32_t>(encoded[4]) << 24) |
+                        (static_cast<uint32_t>(encoded[5]) << 16) |
+                        (static_cast<uint32_t>(encoded[6]) << 8) |
+                        static_cast<uint32_t>(encoded[7]);
+        offset = 8;
+    }
+    
     // Read match count
-    uint32_t match_count = (static_cast<uint32_t>(encoded[4]) << 24) |
-                          (static_cast<uint32_t>(encoded[5]) << 16) |
-                          (static_cast<uint32_t>(encoded[6]) << 8) |
-                          static_cast<uint32_t>(encoded[7]);
+    uint32_t match_count = (static_cast<uint32_t>(encoded[offset]) << 24) |
+                          (static_cast<uint32_t>(encoded[offset + 1]) << 16) |
+                          (static_cast<uint32_t>(encoded[offset + 2]) << 8) |
+                          static_cast<uint32_t>(encoded[offset + 3]);
+    offset += 4;
     
     std::vector<LZ77Match> matches;
     matches.reserve(match_count);
     
-    size_t offset = 8;
     for (uint32_t i = 0; i < match_count; ++i) {
         if (offset >= encoded.size()) {
             throw DecompressionException("Unexpected end of LZ77 data");
@@ -345,13 +425,9 @@ LZ77Match LZ77Algorithm::HashSearch::find_match(const ByteVector& input, size_t
         if (distance > WINDOW_SIZE) break;
         
         // Count matching bytes
-        uint8_t match_length = 0;
         size_t max_length = std::min(LOOKAHEAD_SIZE, input.size() - position);
-        
-        while (match_length < max_length && 
-               input[candidate_pos + match_length] == input[position + match_length]) {
-            match_length++;
-        }
+        uint8_t match_length = static_cast<uint8_t>(
+            utils::Kernels::match_length(&input[candidate_pos], &input[position], max_length));
         
         if (match_length > best_length) {
             best_length = match_length;
@@ -34,14 +34,14 @@ private:
     static constexpr size_t WINDOW_SIZE = 4096;      // Look-back window size
     static constexpr size_t LOOKAHEAD_SIZE = 18;     // Look-ahead buffer size
     static constexpr size_t MIN_MATCH_LENGTH = 3;    // Minimum match length
-    static constexpr size_t MAX_MATCH_LENGTH = 258;  // Maximum match length
+    static constexpr size_t MAX_MATCH_LENGTH = 255;  // Maximum match length (8-bit length field)
     
     // Find the longest match in the sliding window
     LZ77Match find_longest_match(const ByteVector& input, size_t position);
     
     // Encode matches and literals
-    ByteVector encode_matches(const std::vector<LZ77Match>& matches);
-    std::vector<LZ77Match> decode_matches(const ByteVector& encoded);
+    ByteVector encode_matches(const std::vector<LZ77Match>& matches, uint32_t dictionary_id);
+    std::vector<LZ77Match> decode_matches(const ByteVector& encoded, uint32_t& dictionary_id);
     
     // Hash-based search for better performance
     class HashSearch {
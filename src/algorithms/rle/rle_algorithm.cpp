@@ -1,5 +1,8 @@
 #include "algorithms/rle/rle_algorithm.hpp"
 #include "utils/crc.hpp"
+#include "utils/kernels.hpp"
+#include "utils/tracing.hpp"
+#include <algorithm>
 #include <cmath>
 #include <unordered_map>
 
@@ -19,12 +22,16 @@ CompressionResult RLEAlgorithm::compress(const ByteVector& input, const Compress
         return CompressionResult(false, "Input data is empty");
     }
     
+    utils::TraceSpan span("rle.compress");
+    span.arg("bytes", input.size());
+    
     CompressionResult result(true);
     auto& stats = result.stats();
     
     // Record original size and calculate checksum
     stats.original_size = input.size();
     if (config.verify_integrity) {
+        utils::TraceSpan checksum_span("rle.checksum");
         stats.checksum = utils::CRC32::calculate(input);
     }
     
@@ -32,15 +39,22 @@ CompressionResult RLEAlgorithm::compress(const ByteVector& input, const Compress
     auto start_time = now();
     
     // Choose encoding method based on data characteristics
-    double entropy = calculate_entropy(input);
+    double entropy;
+    {
+        utils::TraceSpan analyze_span("rle.analyze");
+        entropy = calculate_entropy(input);
+    }
     ByteVector compressed;
     
-    if (entropy < 0.5) {
-        // Low entropy - use enhanced RLE
-        compressed = encode_enhanced_rle(input);
-    } else {
-        // High entropy - use simple RLE
-        compressed = encode_rle(input);
+    {
+        utils::TraceSpan encode_span("rle.encode");
+        if (entropy < 0.5) {
+            // Low entropy - use enhanced RLE
+            compressed = encode_enhanced_rle(input);
+        } else {
+            // High entropy - use simple RLE
+            compressed = encode_rle(input);
+        }
     }
     
     auto end_time = now();
@@ -66,6 +80,9 @@ CompressionResult RLEAlgorithm::decompress(const ByteVector& input, const Compre
         return CompressionResult(false, "Input data is empty");
     }
     
+    utils::TraceSpan span("rle.decompress");
+    span.arg("bytes", input.size());
+    
     CompressionResult result(true);
     auto& stats = result.stats();
     
@@ -74,6 +91,7 @@ CompressionResult RLEAlgorithm::decompress(const ByteVector& input, const Compre
     ByteVector decompressed;
     
     try {
+        utils::TraceSpan decode_span("rle.decode");
         // Try enhanced RLE first (it has a header to identify itself)
         if (input.size() > 1 && input[0] == 0xE1) {
             decompressed = decode_enhanced_rle(input);
@@ -95,6 +113,7 @@ CompressionResult RLEAlgorithm::decompress(const ByteVector& input, const Compre
     
     // Verify integrity if requested
     if (config.verify_integrity) {
+        utils::TraceSpan checksum_span("rle.checksum");
         stats.checksum = utils::CRC32::calculate(decompressed);
     }
     
@@ -106,11 +125,9 @@ double RLEAlgorithm::estimate_ratio(const ByteVector& input) const {
     if (input.empty()) return 1.0;
     
     // Quick estimate based on run lengths
-    size_t runs = 1;
-    for (size_t i = 1; i < input.size(); ++i) {
-        if (input[i] != input[i-1]) {
-            runs++;
-        }
+    size_t runs = 0;
+    for (size_t i = 0; i < input.size(); runs++) {
+        i += utils::Kernels::run_length(&input[i], input.size() - i);
     }
     
     // Estimate: each run takes ~2-3 bytes on average
@@ -124,17 +141,11 @@ ByteVector RLEAlgorithm::encode_rle(const ByteVector& input) {
     
     for (size_t i = 0; i < input.size(); ) {
         uint8_t current_byte = input[i];
-        size_t run_length = 1;
-        
         // Count consecutive identical bytes
-        while (i + run_length < input.size() && 
-               input[i + run_length] == current_byte && 
-               run_length < 255) {
-            run_length++;
-        }
+        size_t run_length = utils::Kernels::run_length(&input[i], std::min<size_t>(255, input.size() - i));
         
-        // Encode the run
-        if (run_length >= 3) {
+        // Encode the run; a leading 0xE1 literal would read as the enhanced header
+        if (run_length >= 3 || (output.empty() && current_byte == 0xE1)) {
             // Use RLE for runs of 3 or more
             output.push_back(0xFF); // Escape byte
             output.push_back(static_cast<uint8_t>(run_length));
@@ -197,14 +208,8 @@ ByteVector RLEAlgorithm::encode_enhanced_rle(const ByteVector& input) {
     
     for (size_t i = 0; i < input.size(); ) {
         uint8_t current_byte = input[i];
-        size_t run_length = 1;
-        
         // Count consecutive identical bytes
-        while (i + run_length < input.size() && 
-               input[i + run_length] == current_byte && 
-               run_length < 127) {
-            run_length++;
-        }
+        size_t run_length = utils::Kernels::run_length(&input[i], std::min<size_t>(127, input.size() - i));
         
         if (run_length >= 4) {
             // Encode as run: high bit set + length + byte
@@ -224,6 +229,7 @@ ByteVector RLEAlgorithm::encode_enhanced_rle(const ByteVector& input) {
                 }
                 
                 if (next_run >= 4) break; // Found a run worth encoding
+                if (literal_length + next_run > 127) break; // Length must not reach the run flag
                 
                 literal_length += next_run;
                 j += next_run;
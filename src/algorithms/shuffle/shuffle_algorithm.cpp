@@ -0,0 +1,163 @@
+#include "algorithms/shuffle/shuffle_algorithm.hpp"
+#include "utils/crc.hpp"
+#include "utils/shuffle.hpp"
+#include "utils/tracing.hpp"
+
+namespace compressor {
+
+ShuffleAlgorithm::ShuffleAlgorithm(const std::string& codec) : codec_(codec) {}
+
+AlgorithmInfo ShuffleAlgorithm::get_info() const {
+    return AlgorithmInfo(
+        codec_ == "hybrid" ? "shuffle" : "shuffle+" + codec_,
+        "Byte shuffle for fixed-width records (numeric arrays, structs) in front of " + codec_,
+        false,
+        1024
+    );
+}
+
+CompressionResult ShuffleAlgorithm::compress(const ByteVector& input, const CompressionConfig& config) {
+    if (input.empty()) {
+        return CompressionResult(false, "Input data is empty");
+    }
+    
+    utils::TraceSpan span("shuffle.compress");
+    span.arg("bytes", input.size());
+    
+    auto inner = AlgorithmFactory::create(codec_);
+    if (!inner) {
+        return CompressionResult(false, "Unknown algorithm: " + codec_);
+    }
+    
+    // Picking this codec asks for a shuffle, so "none" means detect
+    size_t width = config.shuffle_width;
+    if (width == 0 || width == CompressionConfig::SHUFFLE_AUTO) {
+        width = utils::ByteShuffle::detect_width(input);
+    }
+    if (width > utils::ByteShuffle::MAX_WIDTH) {
+        return CompressionResult(false, "Invalid shuffle width: " + std::to_string(width));
+    }
+    
+    auto start_time = now();
+    
+    ByteVector shuffled;
+    {
+        utils::TraceSpan shuffle_span("shuffle.shuffle");
+        shuffled = utils::ByteShuffle::shuffle(input, width);
+    }
+    
+    CompressionConfig inner_config = config;
+    inner_config.shuffle_width = 0;
+    CompressionResult inner_result = inner->compress(shuffled, inner_config);
+    if (!inner_result.is_success()) {
+        return inner_result;
+    }
+    
+    ByteVector compressed;
+    compressed.reserve(MIN_HEADER_SIZE + codec_.size() + inner_result.data().size());
+    compressed.push_back('S');
+    compressed.push_back('H');
+    compressed.push_back('U');
+    compressed.push_back('F');
+    compressed.push_back(static_cast<uint8_t>(width));
+    compressed.push_back(static_cast<uint8_t>(codec_.size()));
+    compressed.insert(compressed.end(), codec_.begin(), codec_.end());
+    compressed.insert(compressed.end(), inner_result.data().begin(), inner_result.data().end());
+    
+    auto end_time = now();
+    
+    CompressionResult result(true);
+    auto& stats = result.stats();
+    stats.original_size = input.size();
+    stats.compressed_size = compressed.size();
+    stats.compression_ratio = static_cast<double>(stats.compressed_size) / stats.original_size;
+    stats.compression_time_ms = duration_ms(start_time, end_time);
+    stats.threads_used = inner_result.stats().threads_used;
+    
+    // The inner codec saw shuffled bytes; callers verify against the input
+    if (config.verify_integrity) {
+        utils::TraceSpan checksum_span("shuffle.checksum");
+        stats.checksum = utils::CRC32::calculate(input);
+    }
+    
+    result.set_data(std::move(compressed));
+    
+    if (config.verbose) {
+        printf("Shuffle compression: %.2f%% (width: %zu, codec: %s)\n",
+               stats.compression_ratio * 100.0, width, codec_.c_str());
+    }
+    
+    return result;
+}
+
+CompressionResult ShuffleAlgorithm::decompress(const ByteVector& input, const CompressionConfig& config) {
+    if (input.empty()) {
+        return CompressionResult(false, "Input data is empty");
+    }
+    
+    utils::TraceSpan span("shuffle.decompress");
+    span.arg("bytes", input.size());
+    
+    if (input.size() < MIN_HEADER_SIZE || input[0] != 'S' || input[1] != 'H' ||
+        input[2] != 'U' || input[3] != 'F') {
+        return CompressionResult(false, "Invalid shuffle signature");
+    }
+    
+    size_t width = input[4];
+    size_t name_length = input[5];
+    if (input.size() < MIN_HEADER_SIZE + name_length) {
+        return CompressionResult(false, "Truncated shuffle header");
+    }
+    std::string codec(input.begin() + MIN_HEADER_SIZE, input.begin() + MIN_HEADER_SIZE + name_length);
+    
+    // Nested shuffles are never written, so refuse them rather than recurse
+    auto inner = codec.compare(0, 7, "shuffle") == 0 ? nullptr : AlgorithmFactory::create(codec);
+    if (!inner) {
+        return CompressionResult(false, "Unknown algorithm in shuffle header: " + codec);
+    }
+    
+    auto start_time = now();
+    
+    ByteVector payload(input.begin() + MIN_HEADER_SIZE + name_length, input.end());
+    CompressionConfig inner_config = config;
+    inner_config.shuffle_width = 0;
+    CompressionResult inner_result = inner->decompress(payload, inner_config);
+    if (!inner_result.is_success()) {
+        return inner_result;
+    }
+    
+    ByteVector decompressed;
+    {
+        utils::TraceSpan unshuffle_span("shuffle.unshuffle");
+        decompressed = utils::ByteShuffle::unshuffle(inner_result.data(), width);
+    }
+    
+    auto end_time = now();
+    
+    CompressionResult result(true);
+    auto& stats = result.stats();
+    stats.original_size = decompressed.size();
+    stats.compressed_size = input.size();
+    stats.compression_ratio = stats.original_size ?
+        static_cast<double>(stats.compressed_size) / stats.original_size : 0.0;
+    stats.decompression_time_ms = duration_ms(start_time, end_time);
+    stats.threads_used = inner_result.stats().threads_used;
+    
+    if (config.verify_integrity) {
+        utils::TraceSpan checksum_span("shuffle.checksum");
+        stats.checksum = utils::CRC32::calculate(decompressed);
+    }
+    
+    result.set_data(std::move(decompressed));
+    return result;
+}
+
+double ShuffleAlgorithm::estimate_ratio(const ByteVector& input) const {
+    auto inner = AlgorithmFactory::create(codec_);
+    if (!inner || input.empty()) {
+        return 1.0;
+    }
+    return inner->estimate_ratio(utils::ByteShuffle::shuffle(input, utils::ByteShuffle::detect_width(input)));
+}
+
+} // namespace compressor
@@ -0,0 +1,34 @@
+#ifndef COMPRESSOR_SHUFFLE_ALGORITHM_HPP
+#define COMPRESSOR_SHUFFLE_ALGORITHM_HPP
+
+#include "core/algorithm.hpp"
+#include <string>
+
+namespace compressor {
+
+// Byte-shuffles fixed-width records, then hands the result to another
+// codec. Registered as "shuffle" (over hybrid) and "shuffle+<codec>".
+class ShuffleAlgorithm : public Algorithm {
+public:
+    explicit ShuffleAlgorithm(const std::string& codec = "hybrid");
+    
+    AlgorithmInfo get_info() const override;
+    
+    CompressionResult compress(const ByteVector& input, 
+                             const CompressionConfig& config = CompressionConfig()) override;
+    
+    CompressionResult decompress(const ByteVector& input,
+                               const CompressionConfig& config = CompressionConfig()) override;
+    
+    double estimate_ratio(const ByteVector& input) const override;
+    
+private:
+    // Header: "SHUF" | width | codec name length | codec name
+    static constexpr size_t MIN_HEADER_SIZE = 6;
+    
+    std::string codec_;
+};
+
+} // namespace compressor
+
+#endif // COMPRESSOR_SHUFFLE_ALGORITHM_HPP
@@ -176,6 +176,26 @@ std::string BenchmarkResult::to_text_report() const {
         oss << "\n";
     }
     
+    bool any_tlb = std::any_of(results_.begin(), results_.end(),
+        [](const AlgorithmBenchmark& r) { return r.success && r.tlb_measured; });
+    if (any_tlb) {
+        oss << "\nTLB Misses (user space):\n";
+        oss << std::setw(12) << "Algorithm"
+            << std::setw(14) << "Comp.dTLB"
+            << std::setw(14) << "Comp.iTLB"
+            << std::setw(14) << "Decomp.dTLB"
+            << std::setw(14) << "Decomp.iTLB" << "\n";
+        oss << std::string(68, '-') << "\n";
+        for (const auto& result : results_) {
+            if (!result.success || !result.tlb_measured) continue;
+            oss << std::setw(12) << result.algorithm_name
+                << std::setw(14) << result.compress_tlb.dtlb
+                << std::setw(14) << result.compress_tlb.itlb
+                << std::setw(14) << result.decompress_tlb.dtlb
+                << std::setw(14) << result.decompress_tlb.itlb << "\n";
+        }
+    }
+    
     return oss.str();
 }
 
@@ -184,7 +204,8 @@ std::string BenchmarkResult::to_csv() const {
     
     // CSV header
     oss << "Algorithm,Status,Original_Size,Compressed_Size,Compression_Ratio,"
-        << "Compression_Time_ms,Decompression_Time_ms,Threads,Checksum,Error\n";
+        << "Compression_Time_ms,Decompression_Time_ms,Threads,Checksum,"
+        << "Compress_dTLB_Misses,Compress_iTLB_Misses,Decompress_dTLB_Misses,Decompress_iTLB_Misses,Error\n";
     
     for (const auto& result : results_) {
         oss << result.algorithm_name << ",";
@@ -198,8 +219,14 @@ std::string BenchmarkResult::to_csv() const {
                 << std::fixed << std::setprecision(3) << result.stats.decompression_time_ms << ","
                 << result.stats.threads_used << ","
                 << "0x" << std::hex << result.stats.checksum << std::dec << ",";
+            if (result.tlb_measured) {
+                oss << result.compress_tlb.dtlb << "," << result.compress_tlb.itlb << ","
+                    << result.decompress_tlb.dtlb << "," << result.decompress_tlb.itlb << ",";
+            } else {
+                oss << ",,,,";
+            }
         } else {
-            oss << "FAILED,,,,,,,," << result.error_message;
+            oss << "FAILED,,,,,,,,,,,," << result.error_message;
         }
         oss << "\n";
     }
@@ -231,7 +258,15 @@ std::string BenchmarkResult::to_json() const {
             oss << "        \"decompression_time_ms\": " << std::fixed << std::setprecision(3) 
                 << result.stats.decompression_time_ms << ",\n";
             oss << "        \"threads_used\": " << result.stats.threads_used << ",\n";
-            oss << "        \"checksum\": \"0x" << std::hex << result.stats.checksum << std::dec << "\"\n";
+            oss << "        \"checksum\": \"0x" << std::hex << result.stats.checksum << std::dec << "\"";
+            if (result.tlb_measured) {
+                oss << ",\n        \"tlb_misses\": {"
+                    << "\"compress_dtlb\": " << result.compress_tlb.dtlb
+                    << ", \"compress_itlb\": " << result.compress_tlb.itlb
+                    << ", \"decompress_dtlb\": " << result.decompress_tlb.dtlb
+                    << ", \"decompress_itlb\": " << result.decompress_tlb.itlb << "}";
+            }
+            oss << "\n";
             oss << "      }\n";
         } else {
             oss << "      \"error\": \"" << result.error_message << "\"\n";
@@ -357,18 +392,24 @@ AlgorithmBenchmark BenchmarkRunner::benchmark_algorithm(const std::string& algor
         
         CompressionStats best_stats;
         bool first_run = true;
+        TlbCounters tlb;
+        result.tlb_measured = tlb.available();
         
         // Run multiple repetitions and keep the best result
         for (size_t rep = 0; rep < config.repetitions; ++rep) {
             // Compression
+            tlb.start();
             auto compress_result = algorithm->compress(data, config.compression_config);
+            TlbMisses compress_tlb = tlb.stop();
             if (!compress_result.is_success()) {
                 result.error_message = compress_result.message();
                 return result;
             }
             
             // Decompression
+            tlb.start();
             auto decompress_result = algorithm->decompress(compress_result.data(), config.compression_config);
+            TlbMisses decompress_tlb = tlb.stop();
             if (!decompress_result.is_success()) {
                 result.error_message = "Decompression failed: " + decompress_result.message();
                 return result;
@@ -388,6 +429,8 @@ AlgorithmBenchmark BenchmarkRunner::benchmark_algorithm(const std::string& algor
             
             if (first_run || current_stats.compression_time_ms < best_stats.compression_time_ms) {
                 best_stats = current_stats;
+                result.compress_tlb = compress_tlb;
+                result.decompress_tlb = decompress_tlb;
                 first_run = false;
             }
         }
@@ -3,6 +3,7 @@
 
 #include "core/common.hpp"
 #include "core/algorithm.hpp"
+#include "benchmark/perf_counters.hpp"
 #include <vector>
 #include <string>
 #include <memory>
@@ -18,8 +19,14 @@ struct AlgorithmBenchmark {
     bool success;
     std::string error_message;
     
+    // TLB misses of the repetition kept in `stats`; only meaningful when
+    // tlb_measured (hardware counters were readable)
+    bool tlb_measured;
+    TlbMisses compress_tlb;
+    TlbMisses decompress_tlb;
+    
     AlgorithmBenchmark(const std::string& name) 
-        : algorithm_name(name), success(false) {}
+        : algorithm_name(name), success(false), tlb_measured(false) {}
 };
 
 // Complete benchmark result for all algorithms
@@ -0,0 +1,75 @@
+#include "benchmark/perf_counters.hpp"
+#include <cstring>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+namespace compressor {
+namespace benchmark {
+
+namespace {
+
+#ifdef __linux__
+int open_cache_event(uint64_t cache, int group_fd) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.size = sizeof(attr);
+    attr.config = cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.disabled = group_fd < 0 ? 1 : 0;  // The group leader gates both
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0));
+}
+#endif
+
+uint64_t read_counter(int fd) {
+    uint64_t value = 0;
+    if (fd < 0 || read(fd, &value, sizeof(value)) != static_cast<ssize_t>(sizeof(value))) {
+        return 0;
+    }
+    return value;
+}
+
+} // namespace
+
+TlbCounters::TlbCounters() : dtlb_fd_(-1), itlb_fd_(-1) {
+#ifdef __linux__
+    dtlb_fd_ = open_cache_event(PERF_COUNT_HW_CACHE_DTLB, -1);
+    if (dtlb_fd_ >= 0) {
+        // Optional: some CPUs expose no iTLB read-miss event
+        itlb_fd_ = open_cache_event(PERF_COUNT_HW_CACHE_ITLB, dtlb_fd_);
+    }
+#endif
+}
+
+TlbCounters::~TlbCounters() {
+    if (itlb_fd_ >= 0) close(itlb_fd_);
+    if (dtlb_fd_ >= 0) close(dtlb_fd_);
+}
+
+void TlbCounters::start() {
+#ifdef __linux__
+    if (dtlb_fd_ < 0) return;
+    ioctl(dtlb_fd_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(dtlb_fd_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+}
+
+TlbMisses TlbCounters::stop() {
+    TlbMisses misses;
+#ifdef __linux__
+    if (dtlb_fd_ < 0) return misses;
+    ioctl(dtlb_fd_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    misses.dtlb = read_counter(dtlb_fd_);
+    misses.itlb = read_counter(itlb_fd_);
+#endif
+    return misses;
+}
+
+} // namespace benchmark
+} // namespace compressor
@@ -0,0 +1,44 @@
+#ifndef COMPRESSOR_PERF_COUNTERS_HPP
+#define COMPRESSOR_PERF_COUNTERS_HPP
+
+#include <cstdint>
+
+namespace compressor {
+namespace benchmark {
+
+// TLB misses between two points of the calling thread
+struct TlbMisses {
+    uint64_t dtlb = 0;   // Data TLB load misses
+    uint64_t itlb = 0;   // Instruction TLB misses
+};
+
+// Hardware TLB-miss counters for the calling thread, read through
+// perf_event_open. User-space only, so the default perf_event_paranoid
+// level allows it. available() is false when the kernel, the CPU or a
+// container's seccomp policy does not provide the events; readings are
+// then zero.
+class TlbCounters {
+public:
+    TlbCounters();
+    ~TlbCounters();
+
+    TlbCounters(const TlbCounters&) = delete;
+    TlbCounters& operator=(const TlbCounters&) = delete;
+
+    bool available() const { return dtlb_fd_ >= 0; }
+
+    // Zero and enable the counters
+    void start();
+
+    // Disable the counters and return the misses since start()
+    TlbMisses stop();
+
+private:
+    int dtlb_fd_;
+    int itlb_fd_;
+};
+
+} // namespace benchmark
+} // namespace compressor
+
+#endif // COMPRESSOR_PERF_COUNTERS_HPP
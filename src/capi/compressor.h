@@ -0,0 +1,98 @@
+#ifndef COMPRESSOR_H
+#define COMPRESSOR_H
+
+/*
+ * libcompressor: C ABI for the compressor codecs.
+ *
+ * Functions never throw or abort; they return a compressor_status (0 on
+ * success, negative on error) and leave a message readable through
+ * compressor_ctx_last_error(). A context binds one algorithm and holds the
+ * state of one stream; it may be used from any thread but not from two at
+ * once. Contexts are independent of each other.
+ *
+ * One-shot calls produce the codec's own format. Streams produce the block
+ * container format ("CBLK", see utils/block_container.hpp), the same
+ * framing the web server uses for job results, so either side can read
+ * what the other wrote.
+ */
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(_WIN32)
+#define COMPRESSOR_API __declspec(dllexport)
+#else
+#define COMPRESSOR_API __attribute__((visibility("default")))
+#endif
+
+#define COMPRESSOR_ABI_VERSION 1
+
+typedef enum {
+    COMPRESSOR_OK = 0,
+    COMPRESSOR_STREAM_PENDING = 1,   /* Output buffer full; call again to drain */
+    COMPRESSOR_STREAM_END = 2,       /* Stream finished and fully drained */
+
+    COMPRESSOR_ERROR_INVALID_ARGUMENT = -1,
+    COMPRESSOR_ERROR_UNKNOWN_ALGORITHM = -2,
+    COMPRESSOR_ERROR_DST_TOO_SMALL = -3,   /* *dst_size holds the size needed */
+    COMPRESSOR_ERROR_CORRUPT_INPUT = -4,
+    COMPRESSOR_ERROR_FAILED = -5,
+    COMPRESSOR_ERROR_OUT_OF_MEMORY = -6,
+    COMPRESSOR_ERROR_STREAM_STATE = -7     /* Stream call without a matching begin */
+} compressor_status;
+
+typedef struct compressor_ctx compressor_ctx;
+
+/* COMPRESSOR_ABI_VERSION the library was built with */
+COMPRESSOR_API int compressor_abi_version(void);
+
+/* Static description of a status code */
+COMPRESSOR_API const char* compressor_status_string(int status);
+
+/* Registered algorithm names; index from 0 to count - 1 */
+COMPRESSOR_API size_t compressor_algorithm_count(void);
+COMPRESSOR_API const char* compressor_algorithm_name(size_t index);
+
+COMPRESSOR_API int compressor_ctx_create(const char* algorithm, compressor_ctx** ctx);
+COMPRESSOR_API void compressor_ctx_free(compressor_ctx* ctx);
+
+/* Message of the last failed call on `ctx`; valid until the next call */
+COMPRESSOR_API const char* compressor_ctx_last_error(const compressor_ctx* ctx);
+
+/*
+ * One-shot calls. On success *dst_size is the number of bytes written.
+ * When dst is too small nothing is written, *dst_size is set to the size
+ * required and COMPRESSOR_ERROR_DST_TOO_SMALL is returned. Empty input
+ * compresses to an empty frame, which decompresses back to empty output.
+ */
+COMPRESSOR_API int compressor_compress(compressor_ctx* ctx, const void* src, size_t src_size,
+                                       void* dst, size_t dst_capacity, size_t* dst_size);
+COMPRESSOR_API int compressor_decompress(compressor_ctx* ctx, const void* src, size_t src_size,
+                                         void* dst, size_t dst_capacity, size_t* dst_size);
+
+/*
+ * Streaming. Begin a stream, then call compressor_stream_update() with
+ * successive input. Each call consumes as much input as it can
+ * (*src_consumed) and writes up to dst_capacity bytes (*dst_written).
+ * Pass end = 1 once all input has been supplied and keep calling until
+ * COMPRESSOR_STREAM_END. COMPRESSOR_STREAM_PENDING asks for another call
+ * with more output space. Memory is bounded by the block size.
+ *
+ * block_size 0 selects the default (1 MiB). Decompression streams use the
+ * algorithm named in the container header, whatever the context's; the
+ * context stays bound to its own algorithm for later calls.
+ */
+COMPRESSOR_API int compressor_stream_compress_begin(compressor_ctx* ctx, size_t block_size);
+COMPRESSOR_API int compressor_stream_decompress_begin(compressor_ctx* ctx);
+COMPRESSOR_API int compressor_stream_update(compressor_ctx* ctx, const void* src, size_t src_size,
+                                            size_t* src_consumed, void* dst, size_t dst_capacity,
+                                            size_t* dst_written, int end);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* COMPRESSOR_H */
@@ -0,0 +1,394 @@
+#include "capi/compressor.h"
+#include "core/algorithm.hpp"
+#include "utils/block_container.hpp"
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <sstream>
+
+using compressor::Algorithm;
+using compressor::AlgorithmFactory;
+using compressor::ByteVector;
+
+namespace {
+
+constexpr size_t DEFAULT_BLOCK_SIZE = 1024 * 1024;
+constexpr size_t MAX_BLOCK_SIZE = 0xFFFFFFFFu;
+
+enum class StreamMode { NONE, COMPRESS, DECOMPRESS };
+
+// Where a decompression stream is within the container
+enum class ParseStep { HEADER_PREFIX, HEADER, FRAME_HEADER, FRAME_DATA };
+
+uint32_t read_u32(const uint8_t* data) {
+    return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16) |
+           (static_cast<uint32_t>(data[2]) << 8) | static_cast<uint32_t>(data[3]);
+}
+
+const std::vector<std::string>& algorithm_names() {
+    static const std::vector<std::string> names = [] {
+        auto list = AlgorithmFactory::list_algorithms();
+        std::sort(list.begin(), list.end());
+        return list;
+    }();
+    return names;
+}
+
+} // namespace
+
+struct compressor_ctx {
+    std::string algorithm;
+    std::unique_ptr<Algorithm> codec;
+    std::string last_error;
+
+    // Decoder for a stream whose container names another algorithm; the
+    // bound codec stays in place for later calls
+    std::unique_ptr<Algorithm> stream_codec;
+
+    StreamMode mode = StreamMode::NONE;
+    bool finished = false;     // All input seen and the last block emitted
+    size_t block_size = 0;
+
+    // Output produced but not yet handed to the caller
+    ByteVector pending;
+    size_t pending_offset = 0;
+
+    // Compression: the block being filled. Decompression: the element
+    // being parsed, which needs exactly `needed` bytes.
+    ByteVector input;
+    ParseStep step = ParseStep::HEADER_PREFIX;
+    size_t needed = 0;
+    uint32_t frame_original = 0;
+
+    int fail(int status, const std::string& message) {
+        last_error = message;
+        return status;
+    }
+
+    size_t pending_size() const { return pending.size() - pending_offset; }
+
+    void append_pending(const ByteVector& bytes) {
+        if (pending_offset == pending.size()) {
+            pending.clear();
+            pending_offset = 0;
+        }
+        pending.insert(pending.end(), bytes.begin(), bytes.end());
+    }
+
+    void append_pending(const std::string& bytes) {
+        append_pending(ByteVector(bytes.begin(), bytes.end()));
+    }
+
+    size_t drain(uint8_t* dst, size_t capacity) {
+        size_t count = std::min(capacity, pending_size());
+        if (count > 0) {
+            std::memcpy(dst, pending.data() + pending_offset, count);
+            pending_offset += count;
+        }
+        return count;
+    }
+
+    void reset_stream() {
+        mode = StreamMode::NONE;
+        finished = false;
+        pending.clear();
+        pending_offset = 0;
+        input.clear();
+        step = ParseStep::HEADER_PREFIX;
+        needed = 0;
+        stream_codec.reset();
+    }
+
+    Algorithm& stream_decoder() { return stream_codec ? *stream_codec : *codec; }
+
+    int emit_block() {
+        auto result = codec->compress(input);
+        if (!result.is_success()) {
+            return fail(COMPRESSOR_ERROR_FAILED, "Block compression failed: " + result.message());
+        }
+        std::ostringstream frame;
+        compressor::utils::BlockContainer::write_block(frame, static_cast<uint32_t>(input.size()), result.data());
+        append_pending(frame.str());
+        input.clear();
+        return COMPRESSOR_OK;
+    }
+
+    // Act on a complete element of a decompression stream
+    int parse_element() {
+        switch (step) {
+            case ParseStep::HEADER_PREFIX:
+                // "CBLK" | version | name length; the name and block size follow
+                step = ParseStep::HEADER;
+                needed = 6 + input[5] + 4;
+                return COMPRESSOR_OK;
+
+            case ParseStep::HEADER: {
+                std::istringstream in(std::string(input.begin(), input.end()));
+                auto header = compressor::utils::BlockContainer::read_header(in);
+                if (header.algorithm != algorithm) {
+                    stream_codec = AlgorithmFactory::create(header.algorithm);
+                    if (!stream_codec) {
+                        return fail(COMPRESSOR_ERROR_UNKNOWN_ALGORITHM,
+                                    "Container uses unknown algorithm: " + header.algorithm);
+                    }
+                }
+                block_size = header.block_size;
+                step = ParseStep::FRAME_HEADER;
+                needed = 8;
+                input.clear();
+                return COMPRESSOR_OK;
+            }
+
+            case ParseStep::FRAME_HEADER: {
+                frame_original = read_u32(input.data());
+                uint32_t compressed_size = read_u32(input.data() + 4);
+                if (!compressor::utils::BlockContainer::frame_fits(static_cast<uint32_t>(block_size),
+                                                                   frame_original, compressed_size)) {
+                    return fail(COMPRESSOR_ERROR_CORRUPT_INPUT, "Block frame sizes exceed the container block size");
+                }
+                step = ParseStep::FRAME_DATA;
+                needed = compressed_size;
+                input.clear();
+                return needed == 0 ? parse_element() : COMPRESSOR_OK;
+            }
+
+            case ParseStep::FRAME_DATA: {
+                auto result = stream_decoder().decompress(input);
+                if (!result.is_success() || result.data().size() != frame_original) {
+                    return fail(COMPRESSOR_ERROR_CORRUPT_INPUT, "Block decompression failed");
+                }
+                append_pending(result.data());
+                step = ParseStep::FRAME_HEADER;
+                needed = 8;
+                input.clear();
+                return COMPRESSOR_OK;
+            }
+        }
+        return COMPRESSOR_OK;
+    }
+
+    int update(const uint8_t* src, size_t src_size, size_t& consumed,
+               uint8_t* dst, size_t capacity, size_t& written, bool end) {
+        while (true) {
+            written += drain(dst + written, capacity - written);
+            if (pending_size() > 0) {
+                return COMPRESSOR_STREAM_PENDING;
+            }
+            if (finished) {
+                return COMPRESSOR_STREAM_END;
+            }
+
+            if (consumed == src_size) {
+                if (!end) {
+                    return COMPRESSOR_OK;
+                }
+                // Flush whatever is left, then finish on the next pass
+                if (mode == StreamMode::COMPRESS && !input.empty()) {
+                    int status = emit_block();
+                    if (status != COMPRESSOR_OK) return status;
+                } else if (mode == StreamMode::DECOMPRESS &&
+                           !(step == ParseStep::FRAME_HEADER && input.empty())) {
+                    return fail(COMPRESSOR_ERROR_CORRUPT_INPUT, "Truncated block container");
+                }
+                finished = true;
+                continue;
+            }
+
+            size_t target = mode == StreamMode::COMPRESS ? block_size : needed;
+            size_t take = std::min(target - input.size(), src_size - consumed);
+            input.insert(input.end(), src + consumed, src + consumed + take);
+            consumed += take;
+
+            if (input.size() == target) {
+                int status = mode == StreamMode::COMPRESS ? emit_block() : parse_element();
+                if (status != COMPRESSOR_OK) return status;
+            }
+        }
+    }
+};
+
+namespace {
+
+// Run `body`, translating exceptions into status codes
+template<typename Func>
+int guarded(compressor_ctx* ctx, Func&& body) {
+    try {
+        return body();
+    } catch (const std::bad_alloc&) {
+        return ctx->fail(COMPRESSOR_ERROR_OUT_OF_MEMORY, "Out of memory");
+    } catch (const compressor::DecompressionException& e) {
+        return ctx->fail(COMPRESSOR_ERROR_CORRUPT_INPUT, e.what());
+    } catch (const std::exception& e) {
+        return ctx->fail(COMPRESSOR_ERROR_FAILED, e.what());
+    } catch (...) {
+        return ctx->fail(COMPRESSOR_ERROR_FAILED, "Unknown error");
+    }
+}
+
+int one_shot(compressor_ctx* ctx, bool compress, const void* src, size_t src_size,
+             void* dst, size_t dst_capacity, size_t* dst_size) {
+    if (!ctx) {
+        return COMPRESSOR_ERROR_INVALID_ARGUMENT;
+    }
+    if ((!src && src_size > 0) || (!dst && dst_capacity > 0) || !dst_size) {
+        return ctx->fail(COMPRESSOR_ERROR_INVALID_ARGUMENT, "Null buffer or size pointer");
+    }
+
+    // Empty input maps to an empty frame both ways; the codecs reject it
+    if (src_size == 0) {
+        *dst_size = 0;
+        return COMPRESSOR_OK;
+    }
+
+    return guarded(ctx, [&]() {
+        const uint8_t* bytes = static_cast<const uint8_t*>(src);
+        ByteVector input(bytes, bytes + src_size);
+        auto result = compress ? ctx->codec->compress(input) : ctx->codec->decompress(input);
+        if (!result.is_success()) {
+            return ctx->fail(compress ? COMPRESSOR_ERROR_FAILED : COMPRESSOR_ERROR_CORRUPT_INPUT,
+                             result.message());
+        }
+
+        *dst_size = result.data().size();
+        if (result.data().size() > dst_capacity) {
+            return ctx->fail(COMPRESSOR_ERROR_DST_TOO_SMALL, "Destination buffer too small");
+        }
+        if (!result.data().empty()) {
+            std::memcpy(dst, result.data().data(), result.data().size());
+        }
+        return static_cast<int>(COMPRESSOR_OK);
+    });
+}
+
+} // namespace
+
+extern "C" {
+
+int compressor_abi_version(void) {
+    return COMPRESSOR_ABI_VERSION;
+}
+
+const char* compressor_status_string(int status) {
+    switch (status) {
+        case COMPRESSOR_OK: return "ok";
+        case COMPRESSOR_STREAM_PENDING: return "output pending";
+        case COMPRESSOR_STREAM_END: return "end of stream";
+        case COMPRESSOR_ERROR_INVALID_ARGUMENT: return "invalid argument";
+        case COMPRESSOR_ERROR_UNKNOWN_ALGORITHM: return "unknown algorithm";
+        case COMPRESSOR_ERROR_DST_TOO_SMALL: return "destination too small";
+        case COMPRESSOR_ERROR_CORRUPT_INPUT: return "corrupt input";
+        case COMPRESSOR_ERROR_FAILED: return "operation failed";
+        case COMPRESSOR_ERROR_OUT_OF_MEMORY: return "out of memory";
+        case COMPRESSOR_ERROR_STREAM_STATE: return "invalid stream state";
+    }
+    return "unknown status";
+}
+
+size_t compressor_algorithm_count(void) {
+    return algorithm_names().size();
+}
+
+const char* compressor_algorithm_name(size_t index) {
+    const auto& names = algorithm_names();
+    return index < names.size() ? names[index].c_str() : nullptr;
+}
+
+int compressor_ctx_create(const char* algorithm, compressor_ctx** ctx) {
+    if (!algorithm || !ctx) {
+        return COMPRESSOR_ERROR_INVALID_ARGUMENT;
+    }
+    *ctx = nullptr;
+
+    try {
+        auto codec = AlgorithmFactory::create(algorithm);
+        if (!codec) {
+            return COMPRESSOR_ERROR_UNKNOWN_ALGORITHM;
+        }
+        auto* created = new compressor_ctx();
+        created->algorithm = algorithm;
+        created->codec = std::move(codec);
+        *ctx = created;
+        return COMPRESSOR_OK;
+    } catch (const std::bad_alloc&) {
+        return COMPRESSOR_ERROR_OUT_OF_MEMORY;
+    } catch (...) {
+        return COMPRESSOR_ERROR_FAILED;
+    }
+}
+
+void compressor_ctx_free(compressor_ctx* ctx) {
+    delete ctx;
+}
+
+const char* compressor_ctx_last_error(const compressor_ctx* ctx) {
+    return ctx ? ctx->last_error.c_str() : "null context";
+}
+
+int compressor_compress(compressor_ctx* ctx, const void* src, size_t src_size,
+                        void* dst, size_t dst_capacity, size_t* dst_size) {
+    return one_shot(ctx, true, src, src_size, dst, dst_capacity, dst_size);
+}
+
+int compressor_decompress(compressor_ctx* ctx, const void* src, size_t src_size,
+                          void* dst, size_t dst_capacity, size_t* dst_size) {
+    return one_shot(ctx, false, src, src_size, dst, dst_capacity, dst_size);
+}
+
+int compressor_stream_compress_begin(compressor_ctx* ctx, size_t block_size) {
+    if (!ctx) {
+        return COMPRESSOR_ERROR_INVALID_ARGUMENT;
+    }
+    if (block_size > MAX_BLOCK_SIZE) {
+        return ctx->fail(COMPRESSOR_ERROR_INVALID_ARGUMENT, "Block size must fit in 32 bits");
+    }
+
+    return guarded(ctx, [&]() {
+        ctx->reset_stream();
+        ctx->mode = StreamMode::COMPRESS;
+        ctx->block_size = block_size == 0 ? DEFAULT_BLOCK_SIZE : block_size;
+
+        std::ostringstream header;
+        compressor::utils::BlockContainer::write_header(
+            header, compressor::utils::BlockContainerHeader(ctx->algorithm, static_cast<uint32_t>(ctx->block_size)));
+        ctx->append_pending(header.str());
+        return static_cast<int>(COMPRESSOR_OK);
+    });
+}
+
+int compressor_stream_decompress_begin(compressor_ctx* ctx) {
+    if (!ctx) {
+        return COMPRESSOR_ERROR_INVALID_ARGUMENT;
+    }
+    ctx->reset_stream();
+    ctx->mode = StreamMode::DECOMPRESS;
+    ctx->needed = 6;
+    return COMPRESSOR_OK;
+}
+
+int compressor_stream_update(compressor_ctx* ctx, const void* src, size_t src_size,
+                             size_t* src_consumed, void* dst, size_t dst_capacity,
+                             size_t* dst_written, int end) {
+    if (!ctx) {
+        return COMPRESSOR_ERROR_INVALID_ARGUMENT;
+    }
+    if ((!src && src_size > 0) || (!dst && dst_capacity > 0) || !src_consumed || !dst_written) {
+        return ctx->fail(COMPRESSOR_ERROR_INVALID_ARGUMENT, "Null buffer or size pointer");
+    }
+    *src_consumed = 0;
+    *dst_written = 0;
+    if (ctx->mode == StreamMode::NONE) {
+        return ctx->fail(COMPRESSOR_ERROR_STREAM_STATE, "No stream in progress");
+    }
+
+    int status = guarded(ctx, [&]() {
+        return ctx->update(static_cast<const uint8_t*>(src), src_size, *src_consumed,
+                           static_cast<uint8_t*>(dst), dst_capacity, *dst_written, end != 0);
+    });
+    // A failed stream cannot be resumed
+    if (status < 0) {
+        ctx->mode = StreamMode::NONE;
+    }
+    return status;
+}
+
+} // extern "C"
@@ -1,6 +1,12 @@
 #include "cli/cli.hpp"
 #include "utils/file_utils.hpp"
+#include "utils/delta.hpp"
+#include "utils/dictionary.hpp"
 #include "benchmark/benchmark.hpp"
+#include "utils/tracing.hpp"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
@@ -73,6 +79,33 @@ CliArgs ArgumentParser::parse_arguments(int argc, char* argv[]) {
             if (i + 1 < argc) {
                 args.repetitions = std::stoul(argv[++i]);
             }
+        } else if (arg == "--trace") {
+            if (i + 1 < argc) {
+                args.trace_file = argv[++i];
+            }
+        } else if (arg == "--dict") {
+            if (i + 1 < argc) {
+                args.dictionary_file = argv[++i];
+            }
+        } else if (arg == "--ref") {
+            if (i + 1 < argc) {
+                args.reference_file = argv[++i];
+            }
+        } else if (arg == "--dict-size") {
+            if (i + 1 < argc) {
+                args.dictionary_size = std::stoul(argv[++i]);
+            }
+        } else if (arg == "--shuffle") {
+            if (i + 1 < argc) {
+                std::string width = argv[++i];
+                if (width == "auto") {
+                    args.shuffle_width = CompressionConfig::SHUFFLE_AUTO;
+                } else if (width == "off") {
+                    args.shuffle_width = 0;
+                } else {
+                    args.shuffle_width = std::stoul(width);
+                }
+            }
         } else if (!arg.empty() && arg[0] != '-') {
             // Positional argument
             if (args.input_file.empty()) {
@@ -94,6 +127,9 @@ void ArgumentParser::print_usage(const std::string& program_name) {
     std::cout << "  compress     Compress a file\n";
     std::cout << "  decompress   Decompress a file\n";
     std::cout << "  benchmark    Run compression benchmarks\n";
+    std::cout << "  train-dict   Train a dictionary from sample files (or one sample per line)\n";
+    std::cout << "  diff         Write a patch from a reference file to a new version\n";
+    std::cout << "  patch        Rebuild a file from its reference and a patch\n";
     std::cout << "  interactive  Start interactive mode\n";
     std::cout << "  help         Show this help message\n";
     std::cout << "  version      Show version information\n\n";
@@ -101,7 +137,8 @@ void ArgumentParser::print_usage(const std::string& program_name) {
     std::cout << "Options:\n";
     std::cout << "  -f, --file <file>        Input file path\n";
     std::cout << "  -o, --output <file>      Output file path\n";
-    std::cout << "  -a, --algorithm <algo>   Compression algorithm (rle, huffman, lz77, hybrid)\n";
+    std::cout << "  -a, --algorithm <algo>   Compression algorithm (rle, huffman, lz77, hybrid, int32, int64, shuffle,\n";
+    std::cout << "                           or shuffle+<algo> to byte-shuffle in front of any of them)\n";
     std::cout << "  --algorithms <list>      Comma-separated list of algorithms for benchmark\n";
     std::cout << "  -t, --threads <num>      Number of threads to use\n";
     std::cout << "  -b, --block-size <size>  Block size for processing\n";
@@ -110,12 +147,23 @@ void ArgumentParser::print_usage(const std::string& program_name) {
     std::cout << "  -r, --repetitions <num>  Number of benchmark repetitions\n";
     std::cout << "  --export-format <fmt>    Export format (text, csv, json)\n";
     std::cout << "  --export-file <file>     Export benchmark results to file\n";
+    std::cout << "  --trace <file>           Write timing spans as Chrome trace JSON\n";
+    std::cout << "  --dict <file>            Compress with (or load for decompression) a trained dictionary\n";
+    std::cout << "  --dict-size <bytes>      Dictionary content size for train-dict (default 4096)\n";
+    std::cout << "  --ref <file>             Reference (old version) for diff and patch\n";
+    std::cout << "  --shuffle <auto|off|N>   Byte-shuffle N-byte records before hybrid/shuffle coding\n";
     std::cout << "  -h, --help               Show help message\n\n";
     
     std::cout << "Examples:\n";
     std::cout << "  " << program_name << " compress -f input.txt -a huffman -o compressed.bin\n";
     std::cout << "  " << program_name << " decompress -f compressed.bin -o restored.txt\n";
     std::cout << "  " << program_name << " benchmark -f testfile.txt --export-format csv\n";
+    std::cout << "  " << program_name << " compress -f input.txt -a hybrid --trace trace.json\n";
+    std::cout << "  " << program_name << " train-dict samples/ -o events.dict\n";
+    std::cout << "  " << program_name << " compress -f event.json -a lz77 --dict events.dict\n";
+    std::cout << "  " << program_name << " compress -f samples.f32 -a shuffle+lz77 --shuffle 4\n";
+    std::cout << "  " << program_name << " diff --ref app-1.0.img app-1.1.img -o app-1.1.patch\n";
+    std::cout << "  " << program_name << " patch --ref app-1.0.img app-1.1.patch -o app-1.1.img\n";
     std::cout << "  " << program_name << " interactive\n\n";
     
     std::cout << "Available algorithms:\n";
@@ -519,25 +567,21 @@ int CliApplication::run(int argc, char* argv[]) {
             return 0;
         }
         
-        if (args.command == "interactive" || args.interactive) {
-            return run_interactive();
+        if (!args.trace_file.empty()) {
+            utils::Tracer::enable();
         }
         
-        if (args.command == "compress") {
-            return run_compress(args);
-        }
+        int status = run_command(args, argv[0]);
         
-        if (args.command == "decompress") {
-            return run_decompress(args);
-        }
-        
-        if (args.command == "benchmark") {
-            return run_benchmark(args);
+        if (!args.trace_file.empty()) {
+            if (utils::Tracer::write(args.trace_file)) {
+                std::cout << "Trace written to: " << args.trace_file << "\n";
+            } else {
+                std::cerr << "Failed to write trace file: " << args.trace_file << "\n";
+            }
         }
         
-        std::cerr << "Unknown command: " << args.command << "\n";
-        std::cerr << "Use '" << argv[0] << " help' for usage information.\n";
-        return 1;
+        return status;
         
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << "\n";
@@ -545,6 +589,40 @@ int CliApplication::run(int argc, char* argv[]) {
     }
 }
 
+int CliApplication::run_command(const CliArgs& args, const std::string& program_name) {
+    if (args.command == "interactive" || args.interactive) {
+        return run_interactive();
+    }
+    
+    if (args.command == "compress") {
+        return run_compress(args);
+    }
+    
+    if (args.command == "decompress") {
+        return run_decompress(args);
+    }
+    
+    if (args.command == "benchmark") {
+        return run_benchmark(args);
+    }
+    
+    if (args.command == "train-dict") {
+        return run_train_dictionary(args);
+    }
+    
+    if (args.command == "diff") {
+        return run_diff(args);
+    }
+    
+    if (args.command == "patch") {
+        return run_patch(args);
+    }
+    
+    std::cerr << "Unknown command: " << args.command << "\n";
+    std::cerr << "Use '" << program_name << " help' for usage information.\n";
+    return 1;
+}
+
 int CliApplication::run_compress(const CliArgs& args) {
     if (args.input_file.empty()) {
         std::cerr << "Input file not specified. Use -f or --file option.\n";
@@ -687,6 +765,132 @@ int CliApplication::run_benchmark(const CliArgs& args) {
     return 0;
 }
 
+int CliApplication::run_train_dictionary(const CliArgs& args) {
+    if (args.input_file.empty()) {
+        std::cerr << "Samples not specified. Pass a directory of sample files or a file with one sample per line.\n";
+        return 1;
+    }
+    
+    std::vector<ByteVector> samples;
+    try {
+        if (utils::FileUtils::is_directory(args.input_file)) {
+            for (const auto& path : utils::FileUtils::list_directory(args.input_file)) {
+                samples.push_back(utils::FileUtils::read_file(path));
+            }
+        } else {
+            ByteVector data = utils::FileUtils::read_file(args.input_file);
+            auto line_start = data.begin();
+            while (line_start != data.end()) {
+                auto line_end = std::find(line_start, data.end(), '\n');
+                if (line_end != line_start) {
+                    samples.emplace_back(line_start, line_end);
+                }
+                line_start = line_end == data.end() ? line_end : line_end + 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to read samples: " << e.what() << "\n";
+        return 1;
+    }
+    
+    size_t capacity = args.dictionary_size > 0 ? args.dictionary_size : utils::Dictionary::DEFAULT_SIZE;
+    auto dictionary = utils::Dictionary::train(samples, capacity);
+    
+    std::string output_file = args.output_file.empty() ? "dictionary.dict" : args.output_file;
+    if (!utils::FileUtils::write_file(output_file, dictionary.serialize())) {
+        std::cerr << "Failed to write output file: " << output_file << "\n";
+        return 1;
+    }
+    
+    std::cout << "Trained dictionary " << dictionary.id_string() << " from " << samples.size()
+              << " samples (" << benchmark::BenchmarkVisualizer::format_size(dictionary.content().size())
+              << ")\n";
+    std::cout << "Dictionary saved: " << output_file << "\n";
+    return 0;
+}
+
+int CliApplication::run_diff(const CliArgs& args) {
+    if (args.reference_file.empty() || args.input_file.empty()) {
+        std::cerr << "Usage: diff --ref <old> <new> [-o patch]\n";
+        return 1;
+    }
+    
+    std::string output_file = args.output_file.empty() ? args.input_file + ".patch" : args.output_file;
+    try {
+        utils::FileUtils::MappedFile reference(args.reference_file);
+        utils::FileUtils::MappedFile target(args.input_file);
+        
+        std::ofstream patch(output_file, std::ios::binary);
+        if (!patch.is_open()) {
+            std::cerr << "Failed to write output file: " << output_file << "\n";
+            return 1;
+        }
+        
+        auto start = std::chrono::steady_clock::now();
+        auto stats = utils::Delta::diff(reference.data(), reference.size(), target.data(), target.size(), patch);
+        patch.close();
+        double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        
+        size_t patch_size = utils::FileUtils::get_file_size(output_file);
+        std::cout << "Patch: " << benchmark::BenchmarkVisualizer::format_size(target.size()) << " -> "
+                  << benchmark::BenchmarkVisualizer::format_size(patch_size) << " ("
+                  << std::fixed << std::setprecision(2)
+                  << (target.size() > 0 ? 100.0 * patch_size / target.size() : 0.0) << "%)\n";
+        if (args.verbose) {
+            std::cout << "Copied from reference: " << benchmark::BenchmarkVisualizer::format_size(stats.copied_bytes)
+                      << " in " << stats.copies << " copies\n";
+            std::cout << "Inserted: " << benchmark::BenchmarkVisualizer::format_size(stats.inserted_bytes)
+                      << " in " << stats.inserts << " inserts\n";
+            std::cout << "Time: " << benchmark::BenchmarkVisualizer::format_time(elapsed) << "\n";
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Diff failed: " << e.what() << "\n";
+        std::remove(output_file.c_str());
+        return 1;
+    }
+    
+    std::cout << "Patch saved: " << output_file << "\n";
+    return 0;
+}
+
+int CliApplication::run_patch(const CliArgs& args) {
+    if (args.reference_file.empty() || args.input_file.empty()) {
+        std::cerr << "Usage: patch --ref <old> <patch> [-o output]\n";
+        return 1;
+    }
+    
+    std::string output_file = args.output_file.empty() ? args.input_file + ".patched" : args.output_file;
+    try {
+        utils::FileUtils::MappedFile reference(args.reference_file);
+        std::ifstream patch(args.input_file, std::ios::binary);
+        if (!patch.is_open()) {
+            std::cerr << "Failed to read input file: " << args.input_file << "\n";
+            return 1;
+        }
+        std::ofstream output(output_file, std::ios::binary);
+        if (!output.is_open()) {
+            std::cerr << "Failed to write output file: " << output_file << "\n";
+            return 1;
+        }
+        
+        auto stats = utils::Delta::apply(reference.data(), reference.size(), patch, output);
+        output.close();
+        
+        if (args.verbose) {
+            std::cout << "Copied from reference: " << benchmark::BenchmarkVisualizer::format_size(stats.copied_bytes)
+                      << ", inserted: " << benchmark::BenchmarkVisualizer::format_size(stats.inserted_bytes) << "\n";
+        }
+    } catch (const std::exception& e) {
+        // Never leave a partial or unverified output behind
+        std::cerr << "Patch failed: " << e.what() << "\n";
+        std::remove(output_file.c_str());
+        return 1;
+    }
+    
+    std::cout << "Patched file saved: " << output_file << "\n";
+    return 0;
+}
+
 int CliApplication::run_interactive() {
     InteractiveCli cli;
     cli.run();
@@ -703,6 +907,13 @@ CompressionConfig CliApplication::create_compression_config(const CliArgs& args)
         config.block_size = args.block_size;
     }
     
+    // Decompression only needs the dictionary registered; the data names it
+    if (!args.dictionary_file.empty()) {
+        config.dictionary_id = utils::DictionaryRegistry::instance().load_file(args.dictionary_file);
+    }
+    
+    config.shuffle_width = args.shuffle_width;
+    
     return config;
 }
 
@@ -28,8 +28,22 @@ struct CliArgs {
     std::string export_file;
     size_t repetitions;
     
+    // Chrome trace JSON of the run's timing spans is written here when set
+    std::string trace_file;
+    
+    // Dictionary file to compress with, and train-dict's target size
+    std::string dictionary_file;
+    size_t dictionary_size;
+    
+    // Reference file for diff and patch
+    std::string reference_file;
+    
+    // Byte-shuffle element size (CompressionConfig::shuffle_width)
+    size_t shuffle_width;
+    
     CliArgs() : num_threads(1), block_size(0), verbose(false), 
-                verify(true), interactive(false), help(false), repetitions(1) {}
+                verify(true), interactive(false), help(false), repetitions(1),
+                dictionary_size(0), shuffle_width(0) {}
 };
 
 // Command line parser
@@ -90,7 +104,11 @@ private:
     static int run_compress(const CliArgs& args);
     static int run_decompress(const CliArgs& args);
     static int run_benchmark(const CliArgs& args);
+    static int run_train_dictionary(const CliArgs& args);
+    static int run_diff(const CliArgs& args);
+    static int run_patch(const CliArgs& args);
     static int run_interactive();
+    static int run_command(const CliArgs& args, const std::string& program_name);
     
     static CompressionConfig create_compression_config(const CliArgs& args);
     static benchmark::BenchmarkConfig create_benchmark_config(const CliArgs& args);
@@ -2,6 +2,9 @@
 #include "algorithms/rle/rle_algorithm.hpp"
 #include "algorithms/huffman/huffman_algorithm.hpp"
 #include "algorithms/lz77/lz77_algorithm.hpp"
+#include "algorithms/custom_hybrid/hybrid_algorithm.hpp"
+#include "algorithms/shuffle/shuffle_algorithm.hpp"
+#include "algorithms/integer/integer_algorithm.hpp"
 #include <unordered_map>
 #include <functional>
 
@@ -12,14 +15,31 @@ using AlgorithmCreator = std::function<std::unique_ptr<Algorithm>()>;
 static std::unordered_map<std::string, AlgorithmCreator> algorithm_registry = {
     {"rle", []() { return std::make_unique<RLEAlgorithm>(); }},
     {"huffman", []() { return std::make_unique<HuffmanAlgorithm>(); }},
-    {"lz77", []() { return std::make_unique<LZ77Algorithm>(); }}
+    {"lz77", []() { return std::make_unique<LZ77Algorithm>(); }},
+    {"hybrid", []() { return std::make_unique<HybridAlgorithm>(); }},
+    {"shuffle", []() { return std::make_unique<ShuffleAlgorithm>(); }},
+    {"int32", []() { return std::make_unique<IntegerAlgorithm>(4); }},
+    {"int64", []() { return std::make_unique<IntegerAlgorithm>(8); }}
 };
 
+// "shuffle+<codec>" puts the byte shuffle in front of any registered codec
+static const std::string SHUFFLE_PREFIX = "shuffle+";
+
+static bool is_shuffle_composite(const std::string& name) {
+    return name.compare(0, SHUFFLE_PREFIX.size(), SHUFFLE_PREFIX) == 0 &&
+           name.size() > SHUFFLE_PREFIX.size() &&
+           algorithm_registry.count(name.substr(SHUFFLE_PREFIX.size())) &&
+           name.compare(SHUFFLE_PREFIX.size(), 7, "shuffle") != 0;
+}
+
 std::unique_ptr<Algorithm> AlgorithmFactory::create(const std::string& name) {
     auto it = algorithm_registry.find(name);
     if (it != algorithm_registry.end()) {
         return it->second();
     }
+    if (is_shuffle_composite(name)) {
+        return std::make_unique<ShuffleAlgorithm>(name.substr(SHUFFLE_PREFIX.size()));
+    }
     return nullptr;
 }
 
@@ -35,7 +55,7 @@ std::vector<std::string> AlgorithmFactory::list_algorithms() {
 }
 
 bool AlgorithmFactory::is_available(const std::string& name) {
-    return algorithm_registry.find(name) != algorithm_registry.end();
+    return algorithm_registry.find(name) != algorithm_registry.end() || is_shuffle_composite(name);
 }
 
 } // namespace compressor
@@ -1,6 +1,7 @@
 #ifndef COMPRESSOR_COMMON_HPP
 #define COMPRESSOR_COMMON_HPP
 
+#include "core/huge_pages.hpp"
 #include <vector>
 #include <string>
 #include <memory>
@@ -9,8 +10,9 @@
 
 namespace compressor {
 
-// Type definitions
-using ByteVector = std::vector<uint8_t>;
+// Type definitions. Large buffers that fill whole 2 MiB pages closely
+// enough are backed by huge pages (HugePages::worth_mapping()).
+using ByteVector = std::vector<uint8_t, HugePageAllocator<uint8_t>>;
 using TimePoint = std::chrono::high_resolution_clock::time_point;
 using Duration = std::chrono::duration<double>;
 
@@ -53,9 +55,14 @@ struct CompressionConfig {
     size_t num_threads;
     bool verify_integrity;
     bool verbose;
+    uint32_t dictionary_id;  // Registered dictionary to compress with; 0 for none
+    size_t shuffle_width;    // Byte-shuffle element size; 0 for none, SHUFFLE_AUTO to detect
+    
+    static constexpr size_t SHUFFLE_AUTO = SIZE_MAX;
     
     CompressionConfig() 
-        : block_size(64 * 1024), num_threads(1), verify_integrity(true), verbose(false) {}
+        : block_size(64 * 1024), num_threads(1), verify_integrity(true), verbose(false), dictionary_id(0),
+          shuffle_width(0) {}
 };
 
 // Result of compression operation
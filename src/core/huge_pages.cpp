@@ -0,0 +1,144 @@
+#include "core/huge_pages.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <sys/mman.h>
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+
+namespace compressor {
+
+namespace {
+
+std::atomic<int> configured_mode{-1};  // -1 until read from the environment
+std::atomic<uint64_t> hugetlb_count{0};
+std::atomic<uint64_t> thp_count{0};
+std::atomic<uint64_t> plain_count{0};
+std::atomic<uint64_t> heap_count{0};
+std::atomic<uint64_t> mapped{0};
+
+size_t mapping_length(size_t bytes) {
+    return (bytes + HugePages::PAGE_SIZE - 1) / HugePages::PAGE_SIZE * HugePages::PAGE_SIZE;
+}
+
+// Anonymous mapping of `length` bytes aligned to PAGE_SIZE: over-map by one
+// page and unmap the unaligned head and tail
+void* map_aligned(size_t length) {
+    size_t padded = length + HugePages::PAGE_SIZE;
+    void* raw = mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        return nullptr;
+    }
+
+    uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+    uintptr_t aligned = (start + HugePages::PAGE_SIZE - 1) & ~(uintptr_t(HugePages::PAGE_SIZE) - 1);
+    size_t head = aligned - start;
+    size_t tail = padded - head - length;
+    if (head > 0) {
+        munmap(raw, head);
+    }
+    if (tail > 0) {
+        munmap(reinterpret_cast<void*>(aligned + length), tail);
+    }
+    return reinterpret_cast<void*>(aligned);
+}
+
+} // namespace
+
+HugePages::Mode HugePages::mode() {
+    int current = configured_mode.load(std::memory_order_relaxed);
+    if (current < 0) {
+        Mode parsed = Mode::THP;
+        const char* name = std::getenv("COMPRESSOR_HUGEPAGES");
+        if (name) {
+            parse_mode(name, parsed);
+        }
+        // Keep a mode set concurrently through set_mode()
+        configured_mode.compare_exchange_strong(current, static_cast<int>(parsed));
+        return static_cast<Mode>(configured_mode.load(std::memory_order_relaxed));
+    }
+    return static_cast<Mode>(current);
+}
+
+void HugePages::set_mode(Mode mode) {
+    configured_mode.store(static_cast<int>(mode), std::memory_order_relaxed);
+}
+
+bool HugePages::parse_mode(const std::string& name, Mode& mode) {
+    if (name == "off") {
+        mode = Mode::OFF;
+    } else if (name == "thp") {
+        mode = Mode::THP;
+    } else if (name == "hugetlb") {
+        mode = Mode::HUGETLB;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* HugePages::mode_name(Mode mode) {
+    switch (mode) {
+        case Mode::OFF: return "off";
+        case Mode::THP: return "thp";
+        case Mode::HUGETLB: return "hugetlb";
+    }
+    return "unknown";
+}
+
+void* HugePages::allocate(size_t bytes) {
+    size_t length = mapping_length(bytes);
+    Mode current = mode();
+
+    if (current == Mode::HUGETLB) {
+        void* data = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_HUGE_2MB, -1, 0);
+        if (data != MAP_FAILED) {
+            hugetlb_count.fetch_add(1, std::memory_order_relaxed);
+            mapped.fetch_add(length, std::memory_order_relaxed);
+            return data;
+        }
+        // Pool empty or not configured
+        current = Mode::THP;
+    }
+
+    void* data = map_aligned(length);
+    if (!data) {
+        throw std::bad_alloc();
+    }
+
+#ifdef MADV_HUGEPAGE
+    if (current == Mode::THP && madvise(data, length, MADV_HUGEPAGE) == 0) {
+        thp_count.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        plain_count.fetch_add(1, std::memory_order_relaxed);
+    }
+#else
+    plain_count.fetch_add(1, std::memory_order_relaxed);
+#endif
+    mapped.fetch_add(length, std::memory_order_relaxed);
+    return data;
+}
+
+void HugePages::release(void* data, size_t bytes) {
+    if (!data) return;
+    size_t length = mapping_length(bytes);
+    munmap(data, length);
+    mapped.fetch_sub(length, std::memory_order_relaxed);
+}
+
+HugePages::Stats HugePages::stats() {
+    return Stats{hugetlb_count.load(std::memory_order_relaxed), thp_count.load(std::memory_order_relaxed),
+                 plain_count.load(std::memory_order_relaxed), heap_count.load(std::memory_order_relaxed),
+                 mapped.load(std::memory_order_relaxed)};
+}
+
+void HugePages::count_heap_allocation() {
+    heap_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace compressor
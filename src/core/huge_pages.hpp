@@ -0,0 +1,100 @@
+#ifndef COMPRESSOR_HUGE_PAGES_HPP
+#define COMPRESSOR_HUGE_PAGES_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+
+namespace compressor {
+
+// Page-mapped allocation for large buffers and tables.
+//
+// Allocations of at least THRESHOLD bytes get their own mapping, rounded
+// up to whole 2 MiB pages and aligned to them, so random access touches one
+// TLB entry per 2 MiB instead of per 4 KiB. HugePageAllocator only maps
+// blocks whose rounding wastes at most 1/8 of their size, since a 2.1 MB
+// buffer would otherwise reserve 4 MiB. Backings:
+//   THP      - anonymous mapping with MADV_HUGEPAGE (default)
+//   HUGETLB  - MAP_HUGETLB from the reserved hugetlbfs pool, falling back
+//              to THP when the pool is empty
+//   OFF      - plain anonymous mapping
+// The mode is read from COMPRESSOR_HUGEPAGES (off, thp, hugetlb) unless
+// set explicitly, and may change at any time: every mode maps the same
+// length, so release() does not need to know how a block was obtained.
+class HugePages {
+public:
+    enum class Mode { OFF, THP, HUGETLB };
+
+    static constexpr size_t PAGE_SIZE = 2 * 1024 * 1024;
+    static constexpr size_t THRESHOLD = 2 * 1024 * 1024;
+
+    struct Stats {
+        uint64_t hugetlb_allocations;  // Served from the hugetlbfs pool
+        uint64_t thp_allocations;      // Mapped with MADV_HUGEPAGE
+        uint64_t plain_allocations;    // OFF mode, or madvise refused
+        uint64_t heap_allocations;     // Large blocks not worth mapping
+        uint64_t mapped_bytes;         // Currently mapped by this path
+    };
+
+    // True if a block of `bytes` should be page-mapped: at least THRESHOLD
+    // and within 1/8 of a whole number of pages
+    static bool worth_mapping(size_t bytes) {
+        size_t waste = (PAGE_SIZE - bytes % PAGE_SIZE) % PAGE_SIZE;
+        return bytes >= THRESHOLD && waste <= bytes / 8;
+    }
+
+    // Throws std::bad_alloc when the mapping fails
+    static void* allocate(size_t bytes);
+    static void release(void* data, size_t bytes);
+
+    static Mode mode();
+    static void set_mode(Mode mode);
+    static bool parse_mode(const std::string& name, Mode& mode);
+    static const char* mode_name(Mode mode);
+
+    static Stats stats();
+    static void count_heap_allocation();
+};
+
+// Allocator that routes blocks HugePages::worth_mapping() accepts through
+// HugePages and leaves the rest to operator new. Stateless, so
+// containers using it move and swap as cheaply as with std::allocator.
+template<typename T>
+class HugePageAllocator {
+public:
+    using value_type = T;
+
+    HugePageAllocator() noexcept = default;
+    template<typename U>
+    HugePageAllocator(const HugePageAllocator<U>&) noexcept {}
+
+    T* allocate(size_t count) {
+        size_t bytes = count * sizeof(T);
+        if (HugePages::worth_mapping(bytes)) {
+            return static_cast<T*>(HugePages::allocate(bytes));
+        }
+        if (bytes >= HugePages::THRESHOLD) {
+            HugePages::count_heap_allocation();
+        }
+        return static_cast<T*>(::operator new(bytes));
+    }
+
+    void deallocate(T* data, size_t count) noexcept {
+        size_t bytes = count * sizeof(T);
+        if (HugePages::worth_mapping(bytes)) {
+            HugePages::release(data, bytes);
+        } else {
+            ::operator delete(data);
+        }
+    }
+
+    template<typename U>
+    bool operator==(const HugePageAllocator<U>&) const noexcept { return true; }
+    template<typename U>
+    bool operator!=(const HugePageAllocator<U>&) const noexcept { return false; }
+};
+
+} // namespace compressor
+
+#endif // COMPRESSOR_HUGE_PAGES_HPP
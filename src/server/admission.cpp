@@ -0,0 +1,156 @@
+#include "server/admission.hpp"
+#include "server/metrics.hpp"
+#include <algorithm>
+#include <sstream>
+
+namespace compressor {
+namespace server {
+
+AdmissionTicket::AdmissionTicket(AdmissionTicket&& other) noexcept
+    : controller_(other.controller_), bytes_(other.bytes_), class_(other.class_), status_(other.status_) {
+    other.controller_ = nullptr;
+}
+
+AdmissionTicket& AdmissionTicket::operator=(AdmissionTicket&& other) noexcept {
+    if (this != &other) {
+        release();
+        controller_ = other.controller_;
+        bytes_ = other.bytes_;
+        class_ = other.class_;
+        status_ = other.status_;
+        other.controller_ = nullptr;
+    }
+    return *this;
+}
+
+void AdmissionTicket::release() {
+    if (controller_ && status_ == AdmissionStatus::ADMITTED) {
+        controller_->release(bytes_, class_);
+    }
+    controller_ = nullptr;
+}
+
+AdmissionController::AdmissionController(const AdmissionLimits& limits)
+    : limits_(limits), next_waiter_id_(0), inflight_bytes_(0), active_(0), small_active_(0) {
+    limits_.max_concurrent = std::max<size_t>(1, limits_.max_concurrent);
+}
+
+AdmissionTicket AdmissionController::admit(size_t bytes, RequestClass cls) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    std::deque<uint64_t>& waiters = queue_for(cls);
+
+    // SMALL requests only queue behind other SMALL ones; BULK behind both
+    auto at_front = [&](uint64_t id) {
+        return waiters.front() == id && (cls == RequestClass::SMALL || small_waiters_.empty());
+    };
+    auto grant = [&]() {
+        inflight_bytes_ += bytes;
+        active_++;
+        if (cls == RequestClass::SMALL) {
+            small_active_++;
+        }
+        admitted_total_.fetch_add(1, std::memory_order_relaxed);
+    };
+
+    // Fast path: capacity available and nobody ahead of us
+    if (waiters.empty() && (cls == RequestClass::SMALL || small_waiters_.empty()) && fits(bytes, cls)) {
+        grant();
+        return AdmissionTicket(this, bytes, cls, AdmissionStatus::ADMITTED);
+    }
+
+    if (small_waiters_.size() + bulk_waiters_.size() >= limits_.max_queue) {
+        rejected_queue_full_.fetch_add(1, std::memory_order_relaxed);
+        return AdmissionTicket(this, 0, cls, AdmissionStatus::QUEUE_FULL);
+    }
+
+    uint64_t id = next_waiter_id_++;
+    waiters.push_back(id);
+    Metrics::instance().queue_entered();
+
+    auto deadline = std::chrono::steady_clock::now() + limits_.queue_timeout;
+    bool granted = available_.wait_until(lock, deadline, [&] {
+        return at_front(id) && fits(bytes, cls);
+    });
+
+    waiters.erase(std::find(waiters.begin(), waiters.end(), id));
+    Metrics::instance().queue_left();
+
+    if (!granted) {
+        // Our departure may unblock whoever was queued behind us
+        lock.unlock();
+        available_.notify_all();
+        rejected_timeout_.fetch_add(1, std::memory_order_relaxed);
+        return AdmissionTicket(this, 0, cls, AdmissionStatus::TIMED_OUT);
+    }
+
+    grant();
+    lock.unlock();
+    available_.notify_all();
+
+    return AdmissionTicket(this, bytes, cls, AdmissionStatus::ADMITTED);
+}
+
+void AdmissionController::release(size_t bytes, RequestClass cls) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        inflight_bytes_ -= bytes;
+        active_--;
+        if (cls == RequestClass::SMALL) {
+            small_active_--;
+        }
+    }
+    available_.notify_all();
+}
+
+size_t AdmissionController::inflight_bytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return inflight_bytes_;
+}
+
+size_t AdmissionController::active() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return active_;
+}
+
+size_t AdmissionController::waiting() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return small_waiters_.size() + bulk_waiters_.size();
+}
+
+std::string AdmissionController::to_prometheus() const {
+    std::ostringstream oss;
+
+    oss << "# HELP compressor_admission_inflight_bytes Estimated memory charged to admitted requests.\n";
+    oss << "# TYPE compressor_admission_inflight_bytes gauge\n";
+    oss << "compressor_admission_inflight_bytes " << inflight_bytes() << "\n";
+
+    oss << "# HELP compressor_admission_limit_bytes Admission memory budget.\n";
+    oss << "# TYPE compressor_admission_limit_bytes gauge\n";
+    oss << "compressor_admission_limit_bytes " << limits_.max_inflight_bytes << "\n";
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        oss << "# HELP compressor_admission_active Admitted requests by latency class.\n";
+        oss << "# TYPE compressor_admission_active gauge\n";
+        oss << "compressor_admission_active{class=\"small\"} " << small_active_ << "\n";
+        oss << "compressor_admission_active{class=\"bulk\"} " << active_ - small_active_ << "\n";
+        oss << "# HELP compressor_admission_waiting Requests queued for admission by latency class.\n";
+        oss << "# TYPE compressor_admission_waiting gauge\n";
+        oss << "compressor_admission_waiting{class=\"small\"} " << small_waiters_.size() << "\n";
+        oss << "compressor_admission_waiting{class=\"bulk\"} " << bulk_waiters_.size() << "\n";
+    }
+
+    oss << "# HELP compressor_admission_decisions_total Admission outcomes.\n";
+    oss << "# TYPE compressor_admission_decisions_total counter\n";
+    oss << "compressor_admission_decisions_total{result=\"admitted\"} "
+        << admitted_total_.load(std::memory_order_relaxed) << "\n";
+    oss << "compressor_admission_decisions_total{result=\"queue_full\"} "
+        << rejected_queue_full_.load(std::memory_order_relaxed) << "\n";
+    oss << "compressor_admission_decisions_total{result=\"timeout\"} "
+        << rejected_timeout_.load(std::memory_order_relaxed) << "\n";
+
+    return oss.str();
+}
+
+} // namespace server
+} // namespace compressor
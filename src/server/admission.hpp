@@ -0,0 +1,136 @@
+#ifndef COMPRESSOR_SERVER_ADMISSION_HPP
+#define COMPRESSOR_SERVER_ADMISSION_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+
+namespace compressor {
+namespace server {
+
+// Admission limits for codec work
+struct AdmissionLimits {
+    size_t max_inflight_bytes;   // Estimated memory of all admitted requests
+    size_t max_concurrent;       // Requests allowed to run at once
+    size_t max_queue;            // Requests allowed to wait for a slot
+    std::chrono::milliseconds queue_timeout;
+    size_t small_request_bytes;  // Declared bodies up to this size are SMALL
+    size_t reserved_small;       // Extra slots only SMALL requests may take
+
+    AdmissionLimits()
+        : max_inflight_bytes(512 * 1024 * 1024), max_concurrent(4), max_queue(64)
+        , queue_timeout(2000), small_request_bytes(64 * 1024), reserved_small(1) {}
+};
+
+// Latency class of a request, from its declared or observed size
+enum class RequestClass {
+    SMALL,
+    BULK
+};
+
+enum class AdmissionStatus {
+    ADMITTED,
+    QUEUE_FULL,   // Rejected immediately, wait queue at capacity
+    TIMED_OUT     // Waited for the full queue timeout without getting a slot
+};
+
+class AdmissionController;
+
+// Holds an admitted request's share of the budget until destroyed
+class AdmissionTicket {
+public:
+    AdmissionTicket()
+        : controller_(nullptr), bytes_(0), class_(RequestClass::BULK), status_(AdmissionStatus::QUEUE_FULL) {}
+    AdmissionTicket(AdmissionTicket&& other) noexcept;
+    AdmissionTicket& operator=(AdmissionTicket&& other) noexcept;
+    ~AdmissionTicket() { release(); }
+
+    AdmissionTicket(const AdmissionTicket&) = delete;
+    AdmissionTicket& operator=(const AdmissionTicket&) = delete;
+
+    bool admitted() const { return status_ == AdmissionStatus::ADMITTED; }
+    AdmissionStatus status() const { return status_; }
+    RequestClass request_class() const { return class_; }
+    void release();
+
+private:
+    friend class AdmissionController;
+    AdmissionTicket(AdmissionController* controller, size_t bytes, RequestClass cls, AdmissionStatus status)
+        : controller_(controller), bytes_(bytes), class_(cls), status_(status) {}
+
+    AdmissionController* controller_;
+    size_t bytes_;
+    RequestClass class_;
+    AdmissionStatus status_;
+};
+
+// Bounds concurrent codec work by count and by estimated memory.
+//
+// Requests that do not fit wait in a FIFO queue until capacity frees up or
+// their deadline passes; once the queue itself is full new requests are
+// rejected immediately so the caller can answer 503 without buffering them.
+//
+// SMALL and BULK requests queue separately and SMALL waiters are always
+// served first. BULK requests are capped at `max_concurrent`, while SMALL
+// requests may also take `reserved_small` extra slots (exempt from the
+// memory budget, which their size bounds anyway), so a 2 KB request never
+// waits behind a row of 20 MB compressions.
+class AdmissionController {
+public:
+    explicit AdmissionController(const AdmissionLimits& limits);
+
+    RequestClass classify(size_t declared_bytes) const {
+        return declared_bytes <= limits_.small_request_bytes ? RequestClass::SMALL : RequestClass::BULK;
+    }
+
+    AdmissionTicket admit(size_t bytes, RequestClass cls = RequestClass::BULK);
+
+    size_t inflight_bytes() const;
+    size_t active() const;
+    size_t waiting() const;
+
+    std::string to_prometheus() const;
+
+private:
+    friend class AdmissionTicket;
+    void release(size_t bytes, RequestClass cls);
+
+    // A request larger than the whole budget still runs, but only alone
+    bool fits(size_t bytes, RequestClass cls) const {
+        bool memory = inflight_bytes_ + bytes <= limits_.max_inflight_bytes || inflight_bytes_ == 0;
+        if (cls == RequestClass::SMALL) {
+            return active_ < limits_.max_concurrent + limits_.reserved_small &&
+                   (memory || small_active_ < limits_.reserved_small);
+        }
+        return active_ - small_active_ < limits_.max_concurrent &&
+               active_ < limits_.max_concurrent + limits_.reserved_small && memory;
+    }
+
+    std::deque<uint64_t>& queue_for(RequestClass cls) {
+        return cls == RequestClass::SMALL ? small_waiters_ : bulk_waiters_;
+    }
+
+    AdmissionLimits limits_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable available_;
+    std::deque<uint64_t> small_waiters_;
+    std::deque<uint64_t> bulk_waiters_;
+    uint64_t next_waiter_id_;
+    size_t inflight_bytes_;
+    size_t active_;
+    size_t small_active_;
+
+    std::atomic<uint64_t> admitted_total_{0};
+    std::atomic<uint64_t> rejected_queue_full_{0};
+    std::atomic<uint64_t> rejected_timeout_{0};
+};
+
+} // namespace server
+} // namespace compressor
+
+#endif // COMPRESSOR_SERVER_ADMISSION_HPP
@@ -0,0 +1,168 @@
+#include "server/batch.hpp"
+#include "utils/crc.hpp"
+#include "utils/tracing.hpp"
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+
+namespace compressor {
+namespace server {
+
+static uint32_t read_u32(const uint8_t* data) {
+    return (static_cast<uint32_t>(data[0]) << 24) |
+           (static_cast<uint32_t>(data[1]) << 16) |
+           (static_cast<uint32_t>(data[2]) << 8) |
+           static_cast<uint32_t>(data[3]);
+}
+
+static void append_u32(std::string& out, uint32_t value) {
+    out.push_back(static_cast<char>((value >> 24) & 0xFF));
+    out.push_back(static_cast<char>((value >> 16) & 0xFF));
+    out.push_back(static_cast<char>((value >> 8) & 0xFF));
+    out.push_back(static_cast<char>(value & 0xFF));
+}
+
+std::vector<BatchItem> BatchBundle::parse(const uint8_t* data, size_t size) {
+    if (size < 4) {
+        throw std::invalid_argument("Bundle too short");
+    }
+
+    uint32_t count = read_u32(data);
+    if (count > MAX_ITEMS) {
+        throw std::invalid_argument("Bundle has too many items");
+    }
+
+    std::vector<BatchItem> items;
+    items.reserve(count);
+
+    size_t pos = 4;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (size - pos < 4) {
+            throw std::invalid_argument("Truncated item header");
+        }
+        uint32_t length = read_u32(data + pos);
+        pos += 4;
+
+        if (size - pos < length) {
+            throw std::invalid_argument("Truncated item data");
+        }
+        items.push_back(BatchItem{data + pos, length});
+        pos += length;
+    }
+
+    if (pos != size) {
+        throw std::invalid_argument("Trailing bytes after last item");
+    }
+
+    return items;
+}
+
+std::string BatchBundle::serialize(const std::vector<BatchItemResult>& results) {
+    size_t total = 4;
+    for (const auto& result : results) {
+        total += 9 + (result.success ? result.output->size() : result.error.size());
+    }
+
+    std::string out;
+    out.reserve(total);
+    append_u32(out, static_cast<uint32_t>(results.size()));
+
+    for (const auto& result : results) {
+        out.push_back(result.success ? 0 : 1);
+        append_u32(out, static_cast<uint32_t>(result.original_size));
+        if (result.success) {
+            append_u32(out, static_cast<uint32_t>(result.output->size()));
+            out.append(reinterpret_cast<const char*>(result.output->data()), result.output->size());
+        } else {
+            append_u32(out, static_cast<uint32_t>(result.error.size()));
+            out.append(result.error);
+        }
+    }
+
+    return out;
+}
+
+BatchProcessor::BatchProcessor(utils::ThreadPool& pool, CodecPool& codecs, Verifier& verifier)
+    : pool_(pool), codecs_(codecs), verifier_(verifier) {}
+
+std::vector<BatchItemResult> BatchProcessor::run(JobOperation operation, const std::string& algorithm,
+                                                 const std::vector<BatchItem>& items,
+                                                 const CompressionConfig& config,
+                                                 utils::ThreadPool::Priority priority) {
+    std::vector<BatchItemResult> results(items.size());
+    if (items.empty()) {
+        return results;
+    }
+
+    size_t ranges = std::min(pool_.size(), items.size());
+    size_t per_range = (items.size() + ranges - 1) / ranges;
+
+    std::vector<std::future<void>> pending;
+    pending.reserve(ranges);
+    for (size_t begin = 0; begin < items.size(); begin += per_range) {
+        size_t end = std::min(begin + per_range, items.size());
+        pending.push_back(pool_.submit([this, operation, &algorithm, &config, &items, begin, end, &results]() {
+            process_range(operation, algorithm, config, items, begin, end, results);
+        }, priority));
+    }
+
+    for (auto& future : pending) {
+        future.get();
+    }
+
+    return results;
+}
+
+void BatchProcessor::process_range(JobOperation operation, const std::string& algorithm,
+                                   const CompressionConfig& config, const std::vector<BatchItem>& items, size_t begin, size_t end,
+                                   std::vector<BatchItemResult>& results) {
+    utils::TraceSpan span("batch.range", "server");
+    span.arg("items", end - begin);
+    auto codec = codecs_.acquire(algorithm);
+
+    for (size_t i = begin; i < end; ++i) {
+        BatchItemResult& result = results[i];
+        if (!codec) {
+            result.error = "Invalid algorithm: " + algorithm;
+            continue;
+        }
+
+        try {
+            ByteVector input(items[i].data, items[i].data + items[i].size);
+            auto start = std::chrono::high_resolution_clock::now();
+            auto outcome = operation == JobOperation::COMPRESS ? codec->compress(input, config)
+                                                               : codec->decompress(input, config);
+            auto finish = std::chrono::high_resolution_clock::now();
+
+            result.duration_ms = std::chrono::duration<double, std::milli>(finish - start).count();
+            if (!outcome.is_success()) {
+                result.error = outcome.message();
+                continue;
+            }
+
+            result.original_size = operation == JobOperation::COMPRESS ? input.size() : outcome.data().size();
+            result.output = std::make_shared<const ByteVector>(std::move(outcome.data()));
+
+            if (operation == JobOperation::COMPRESS) {
+                uint32_t checksum = outcome.stats().checksum;
+                if (checksum == 0) {
+                    checksum = utils::CRC32::calculate(input);
+                }
+                if (verifier_.verify(algorithm, result.output, input.size(), checksum) ==
+                    VerificationOutcome::FAILED) {
+                    result.output.reset();
+                    result.error = "Verification failed";
+                    continue;
+                }
+            }
+
+            result.success = true;
+        } catch (const std::exception& e) {
+            result.error = e.what();
+        }
+    }
+}
+
+} // namespace server
+} // namespace compressor
@@ -0,0 +1,73 @@
+#ifndef COMPRESSOR_SERVER_BATCH_HPP
+#define COMPRESSOR_SERVER_BATCH_HPP
+
+#include "core/common.hpp"
+#include "server/codec_pool.hpp"
+#include "server/job_manager.hpp"
+#include "server/verifier.hpp"
+#include "utils/thread_pool.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace compressor {
+namespace server {
+
+// One payload of a request bundle; points into the request buffer
+struct BatchItem {
+    const uint8_t* data;
+    size_t size;
+};
+
+struct BatchItemResult {
+    bool success;
+    size_t original_size;
+    std::shared_ptr<const ByteVector> output;
+    std::string error;
+    double duration_ms;
+
+    BatchItemResult() : success(false), original_size(0), duration_ms(0.0) {}
+};
+
+// Binary bundles exchanged with POST /batch. All integers are big-endian.
+//
+// Request:  item count (u32), then per item: length (u32) | bytes
+// Response: item count (u32), then per item:
+//           status (u8, 0 = ok, 1 = error) | original size (u32) | length (u32) | bytes
+// For failed items the bytes carry the error message.
+class BatchBundle {
+public:
+    static constexpr size_t MAX_ITEMS = 1 << 20;
+
+    // Throws std::invalid_argument on a malformed bundle
+    static std::vector<BatchItem> parse(const uint8_t* data, size_t size);
+
+    static std::string serialize(const std::vector<BatchItemResult>& results);
+};
+
+// Runs the items of a bundle in parallel on the shared worker pool. Items
+// are split into contiguous ranges, one per worker, and each range reuses a
+// single codec instance. Small bundles are queued in the pool's HIGH lane.
+class BatchProcessor {
+public:
+    BatchProcessor(utils::ThreadPool& pool, CodecPool& codecs, Verifier& verifier);
+
+    std::vector<BatchItemResult> run(JobOperation operation, const std::string& algorithm,
+                                     const std::vector<BatchItem>& items,
+                                     const CompressionConfig& config = CompressionConfig(),
+                                     utils::ThreadPool::Priority priority = utils::ThreadPool::Priority::NORMAL);
+
+private:
+    void process_range(JobOperation operation, const std::string& algorithm, const CompressionConfig& config,
+                       const std::vector<BatchItem>& items, size_t begin, size_t end,
+                       std::vector<BatchItemResult>& results);
+
+    utils::ThreadPool& pool_;
+    CodecPool& codecs_;
+    Verifier& verifier_;
+};
+
+} // namespace server
+} // namespace compressor
+
+#endif // COMPRESSOR_SERVER_BATCH_HPP
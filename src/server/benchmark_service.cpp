@@ -0,0 +1,135 @@
+#include "server/benchmark_service.hpp"
+#include "utils/hash.hpp"
+#include <pthread.h>
+#include <sched.h>
+#include <sstream>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace compressor {
+namespace server {
+
+std::string BenchmarkStatus::to_json() const {
+    std::ostringstream oss;
+    oss << "{";
+    oss << "\"id\": \"" << id << "\",";
+    oss << "\"status\": \"" << (finished ? "completed" : "running") << "\",";
+    oss << "\"completed\": " << completed << ",";
+    oss << "\"total\": " << total;
+    oss << "}";
+    return oss.str();
+}
+
+BenchmarkService::BenchmarkService(size_t num_threads, size_t max_active, std::chrono::seconds ttl)
+    : max_active_(max_active), ttl_(ttl), active_(0), pool_(num_threads) {}
+
+void BenchmarkService::lower_thread_priority() {
+    thread_local bool lowered = false;
+    if (lowered) return;
+    lowered = true;
+
+#ifdef SCHED_IDLE
+    sched_param param{};
+    if (pthread_setschedparam(pthread_self(), SCHED_IDLE, &param) == 0) {
+        return;
+    }
+#endif
+    // On Linux the nice value is per thread
+    setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), 19);
+}
+
+bool BenchmarkService::start(std::shared_ptr<const ByteVector> data, const benchmark::BenchmarkConfig& config,
+                             std::string& id) {
+    auto run = std::make_shared<Run>();
+    run->data = std::move(data);
+    run->config = config;
+    if (run->config.algorithms.empty()) {
+        run->config.algorithms = AlgorithmFactory::list_algorithms();
+    }
+    for (const auto& name : run->config.algorithms) {
+        run->results.emplace_back(name);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        prune_locked();
+        if (active_ >= max_active_) {
+            return false;
+        }
+        active_++;
+        id = utils::Hash128::random().to_hex();
+        runs_[id] = run;
+    }
+
+    // One task per algorithm so a run spreads across the pool
+    for (size_t i = 0; i < run->results.size(); ++i) {
+        pool_.post([this, run, i]() { run_algorithm(run, i); });
+    }
+    return true;
+}
+
+void BenchmarkService::run_algorithm(std::shared_ptr<Run> run, size_t index) {
+    lower_thread_priority();
+
+    benchmark::BenchmarkConfig config = run->config;
+    config.algorithms = {run->config.algorithms[index]};
+    config.compression_config.verbose = false;
+
+    benchmark::BenchmarkRunner runner;
+    benchmark::BenchmarkResult partial = runner.run_benchmark(*run->data, config);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!partial.get_results().empty()) {
+        run->results[index] = partial.get_results().front();
+    }
+
+    if (++run->completed == run->results.size()) {
+        benchmark::BenchmarkResult merged;
+        for (auto& result : run->results) {
+            merged.add_result(std::move(result));
+        }
+        run->result_json = merged.to_json();
+        run->results.clear();
+        run->data.reset();
+        run->finished_at = std::chrono::steady_clock::now();
+        active_--;
+    }
+}
+
+bool BenchmarkService::get(const std::string& id, BenchmarkStatus& status) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = runs_.find(id);
+    if (it == runs_.end()) {
+        return false;
+    }
+
+    const Run& run = *it->second;
+    status.id = id;
+    status.total = run.config.algorithms.size();
+    status.completed = run.completed;
+    status.finished = run.completed == status.total;
+    status.result_json = run.result_json;
+    return true;
+}
+
+size_t BenchmarkService::active() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return active_;
+}
+
+void BenchmarkService::prune_locked() {
+    auto now = std::chrono::steady_clock::now();
+    for (auto it = runs_.begin(); it != runs_.end();) {
+        const Run& run = *it->second;
+        bool finished = run.completed == run.config.algorithms.size();
+        if (finished && now - run.finished_at > ttl_) {
+            it = runs_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+} // namespace server
+} // namespace compressor
@@ -0,0 +1,75 @@
+#ifndef COMPRESSOR_SERVER_BENCHMARK_SERVICE_HPP
+#define COMPRESSOR_SERVER_BENCHMARK_SERVICE_HPP
+
+#include "benchmark/benchmark.hpp"
+#include "core/common.hpp"
+#include "utils/thread_pool.hpp"
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace compressor {
+namespace server {
+
+// Snapshot of a benchmark run for status responses
+struct BenchmarkStatus {
+    std::string id;
+    bool finished;
+    size_t completed;     // Algorithms benchmarked so far
+    size_t total;
+    std::string result_json;  // BenchmarkResult::to_json() once finished
+
+    BenchmarkStatus() : finished(false), completed(0), total(0) {}
+
+    std::string to_json() const;
+};
+
+// Runs BenchmarkRunner on uploaded data in the background.
+//
+// Each algorithm of a run is benchmarked as its own task on a dedicated pool
+// whose threads drop to the lowest scheduling priority, so comparisons use
+// idle CPU and never compete with interactive requests or jobs.
+class BenchmarkService {
+public:
+    BenchmarkService(size_t num_threads, size_t max_active, std::chrono::seconds ttl);
+
+    // Queue a run; returns false when too many runs are active
+    bool start(std::shared_ptr<const ByteVector> data, const benchmark::BenchmarkConfig& config,
+               std::string& id);
+
+    bool get(const std::string& id, BenchmarkStatus& status) const;
+
+    // Runs queued or in progress
+    size_t active() const;
+
+private:
+    struct Run {
+        std::shared_ptr<const ByteVector> data;
+        benchmark::BenchmarkConfig config;
+        std::vector<benchmark::AlgorithmBenchmark> results;
+        size_t completed = 0;
+        std::string result_json;
+        std::chrono::steady_clock::time_point finished_at;
+    };
+
+    void run_algorithm(std::shared_ptr<Run> run, size_t index);
+    void prune_locked();
+    static void lower_thread_priority();
+
+    size_t max_active_;
+    std::chrono::seconds ttl_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::shared_ptr<Run>> runs_;
+    size_t active_;
+
+    utils::ThreadPool pool_;
+};
+
+} // namespace server
+} // namespace compressor
+
+#endif // COMPRESSOR_SERVER_BENCHMARK_SERVICE_HPP
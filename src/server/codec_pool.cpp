@@ -0,0 +1,113 @@
+#include "server/codec_pool.hpp"
+#include <algorithm>
+#include <sstream>
+
+namespace compressor {
+namespace server {
+
+CodecPool::Lease::Lease(CodecPool* pool, std::string name, std::unique_ptr<Algorithm> codec)
+    : pool_(pool), name_(std::move(name)), codec_(std::move(codec)) {}
+
+CodecPool::Lease::Lease(Lease&& other) noexcept
+    : pool_(other.pool_), name_(std::move(other.name_)), codec_(std::move(other.codec_)) {
+    other.pool_ = nullptr;
+}
+
+CodecPool::Lease& CodecPool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        release();
+        pool_ = other.pool_;
+        name_ = std::move(other.name_);
+        codec_ = std::move(other.codec_);
+        other.pool_ = nullptr;
+    }
+    return *this;
+}
+
+CodecPool::Lease::~Lease() {
+    release();
+}
+
+void CodecPool::Lease::release() {
+    if (pool_ && codec_) {
+        pool_->give_back(name_, std::move(codec_));
+    }
+    pool_ = nullptr;
+}
+
+CodecPool::CodecPool(size_t warm_per_algorithm)
+    : max_idle_(std::max<size_t>(warm_per_algorithm * 2, 1)), hits_(0), misses_(0) {
+    for (const auto& name : AlgorithmFactory::list_algorithms()) {
+        auto codec = AlgorithmFactory::create(name);
+        infos_.push_back(codec->get_info());
+        // Report the registered name; some codecs use a display name
+        infos_.back().name = name;
+
+        auto& idle = idle_[name];
+        if (warm_per_algorithm > 0) {
+            idle.push_back(std::move(codec));
+        }
+        while (idle.size() < warm_per_algorithm) {
+            idle.push_back(AlgorithmFactory::create(name));
+        }
+    }
+
+    std::sort(infos_.begin(), infos_.end(),
+              [](const AlgorithmInfo& a, const AlgorithmInfo& b) { return a.name < b.name; });
+}
+
+CodecPool::Lease CodecPool::acquire(const std::string& name) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = idle_.find(name);
+        if (it == idle_.end()) {
+            // Names outside the warm set, such as "shuffle+lz77", get their
+            // idle list on first use
+            if (!AlgorithmFactory::is_available(name)) {
+                return Lease();
+            }
+            it = idle_.emplace(name, std::vector<std::unique_ptr<Algorithm>>()).first;
+        }
+        if (!it->second.empty()) {
+            std::unique_ptr<Algorithm> codec = std::move(it->second.back());
+            it->second.pop_back();
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return Lease(this, name, std::move(codec));
+        }
+    }
+
+    // Every warm instance is busy; build one outside the lock
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return Lease(this, name, AlgorithmFactory::create(name));
+}
+
+void CodecPool::give_back(const std::string& name, std::unique_ptr<Algorithm> codec) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& idle = idle_[name];
+    if (idle.size() < max_idle_) {
+        idle.push_back(std::move(codec));
+    }
+}
+
+std::string CodecPool::to_prometheus() const {
+    std::ostringstream oss;
+
+    oss << "# HELP compressor_codec_pool_leases_total Codec leases served from warm instances or newly built.\n";
+    oss << "# TYPE compressor_codec_pool_leases_total counter\n";
+    oss << "compressor_codec_pool_leases_total{result=\"warm\"} " << hits_.load(std::memory_order_relaxed) << "\n";
+    oss << "compressor_codec_pool_leases_total{result=\"built\"} " << misses_.load(std::memory_order_relaxed) << "\n";
+
+    oss << "# HELP compressor_codec_pool_idle Idle codec instances per algorithm.\n";
+    oss << "# TYPE compressor_codec_pool_idle gauge\n";
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& info : infos_) {
+        auto it = idle_.find(info.name);
+        oss << "compressor_codec_pool_idle{algorithm=\"" << info.name << "\"} "
+            << (it == idle_.end() ? 0 : it->second.size()) << "\n";
+    }
+
+    return oss.str();
+}
+
+} // namespace server
+} // namespace compressor
@@ -0,0 +1,76 @@
+#ifndef COMPRESSOR_SERVER_CODEC_POOL_HPP
+#define COMPRESSOR_SERVER_CODEC_POOL_HPP
+
+#include "core/algorithm.hpp"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace compressor {
+namespace server {
+
+// Warm, reusable codec instances.
+//
+// Codecs keep no state between calls, so an instance can serve any number
+// of requests one at a time. The pool builds `warm_per_algorithm` instances
+// of every registered algorithm up front and hands them out as leases that
+// return the instance when they go out of scope; requests therefore never
+// pay for constructing a codec (and the sub-codecs hybrid builds) on the
+// hot path. Connections run on short-lived threads, so instances are kept
+// in one shared free list rather than per thread.
+class CodecPool {
+public:
+    class Lease {
+    public:
+        Lease() : pool_(nullptr) {}
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&& other) noexcept;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease();
+
+        Algorithm* get() const { return codec_.get(); }
+        Algorithm* operator->() const { return codec_.get(); }
+        explicit operator bool() const { return codec_ != nullptr; }
+
+    private:
+        friend class CodecPool;
+        Lease(CodecPool* pool, std::string name, std::unique_ptr<Algorithm> codec);
+        void release();
+
+        CodecPool* pool_;
+        std::string name_;
+        std::unique_ptr<Algorithm> codec_;
+    };
+
+    explicit CodecPool(size_t warm_per_algorithm);
+
+    // Empty lease if the factory does not know the algorithm
+    Lease acquire(const std::string& name);
+
+    // Metadata of every registered algorithm, sorted by name
+    const std::vector<AlgorithmInfo>& algorithms() const { return infos_; }
+
+    std::string to_prometheus() const;
+
+private:
+    void give_back(const std::string& name, std::unique_ptr<Algorithm> codec);
+
+    // Idle instances kept per algorithm beyond the warm set
+    size_t max_idle_;
+    std::vector<AlgorithmInfo> infos_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::vector<std::unique_ptr<Algorithm>>> idle_;
+
+    std::atomic<uint64_t> hits_;
+    std::atomic<uint64_t> misses_;
+};
+
+} // namespace server
+} // namespace compressor
+
+#endif // COMPRESSOR_SERVER_CODEC_POOL_HPP
@@ -0,0 +1,134 @@
+#include "server/gzip_encoding.hpp"
+#include "server/http.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <sstream>
+#include <vector>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace compressor {
+namespace server {
+
+namespace {
+
+std::string trim_lower(const std::string& value) {
+    size_t begin = value.find_first_not_of(" \t");
+    size_t end = value.find_last_not_of(" \t");
+    if (begin == std::string::npos) return "";
+
+    std::string result = value.substr(begin, end - begin + 1);
+    std::transform(result.begin(), result.end(), result.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return result;
+}
+
+#ifdef HAVE_ZLIB
+bool send_chunk(int socket, const unsigned char* data, size_t size) {
+    char header[24];
+    int length = std::snprintf(header, sizeof(header), "%zx\r\n", size);
+    return Http::send_all(socket, header, static_cast<size_t>(length)) &&
+           Http::send_all(socket, reinterpret_cast<const char*>(data), size) &&
+           Http::send_all(socket, "\r\n", 2);
+}
+#endif
+
+} // namespace
+
+bool GzipEncoding::available() {
+#ifdef HAVE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool GzipEncoding::accepted(const std::string& accept_encoding) {
+    std::stringstream ss(accept_encoding);
+    std::string item;
+
+    // An explicit gzip entry overrides "*" wherever it appears (RFC 9110)
+    double gzip_quality = -1.0;
+    double wildcard_quality = -1.0;
+
+    while (std::getline(ss, item, ',')) {
+        size_t semicolon = item.find(';');
+        std::string coding = trim_lower(item.substr(0, semicolon));
+        if (coding != "gzip" && coding != "*") continue;
+
+        double quality = 1.0;
+        if (semicolon != std::string::npos) {
+            std::string param = trim_lower(item.substr(semicolon + 1));
+            if (param.compare(0, 2, "q=") == 0) {
+                try {
+                    quality = std::stod(param.substr(2));
+                } catch (const std::exception&) {
+                    quality = 0.0;
+                }
+            }
+        }
+        (coding == "gzip" ? gzip_quality : wildcard_quality) = quality;
+    }
+
+    double quality = gzip_quality >= 0.0 ? gzip_quality : wildcard_quality;
+    return quality > 0.0;
+}
+
+bool GzipEncoding::compressible(const std::string& content_type) {
+    return content_type.compare(0, 5, "text/") == 0 ||
+           content_type.compare(0, 16, "application/json") == 0 ||
+           content_type.compare(0, 22, "application/javascript") == 0;
+}
+
+bool GzipEncoding::send_chunked(int socket, const char* data, size_t size, int level) {
+#ifdef HAVE_ZLIB
+    z_stream stream{};
+    // 15 window bits + 16 selects the gzip wrapper
+    if (deflateInit2(&stream, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return false;
+    }
+
+    const size_t SLICE = 64 * 1024;
+    std::vector<unsigned char> out(SLICE);
+    bool ok = true;
+    size_t offset = 0;
+    int flush = Z_NO_FLUSH;
+
+    while (ok && flush != Z_FINISH) {
+        size_t slice = std::min(SLICE, size - offset);
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data + offset));
+        stream.avail_in = static_cast<uInt>(slice);
+        offset += slice;
+        flush = offset == size ? Z_FINISH : Z_NO_FLUSH;
+
+        do {
+            stream.next_out = out.data();
+            stream.avail_out = static_cast<uInt>(out.size());
+            if (deflate(&stream, flush) == Z_STREAM_ERROR) {
+                ok = false;
+                break;
+            }
+            size_t produced = out.size() - stream.avail_out;
+            if (produced > 0 && !send_chunk(socket, out.data(), produced)) {
+                ok = false;
+                break;
+            }
+        } while (stream.avail_out == 0);
+    }
+
+    deflateEnd(&stream);
+    return ok && Http::send_all(socket, "0\r\n\r\n", 5);
+#else
+    (void)socket;
+    (void)data;
+    (void)size;
+    (void)level;
+    return false;
+#endif
+}
+
+} // namespace server
+} // namespace compressor
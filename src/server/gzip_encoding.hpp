@@ -0,0 +1,34 @@
+#ifndef COMPRESSOR_SERVER_GZIP_ENCODING_HPP
+#define COMPRESSOR_SERVER_GZIP_ENCODING_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace compressor {
+namespace server {
+
+// gzip Content-Encoding for HTTP responses (requires zlib at build time).
+//
+// Bodies are deflated in slices and each piece of output is written to the
+// socket as an HTTP/1.1 chunk as soon as it is produced, so the compressed
+// body is never buffered in full and sending overlaps compression.
+class GzipEncoding {
+public:
+    // False when the server was built without zlib
+    static bool available();
+
+    // True if an Accept-Encoding value allows gzip ("gzip" or "*", q > 0)
+    static bool accepted(const std::string& accept_encoding);
+
+    // Worth compressing: JSON, JavaScript and text bodies
+    static bool compressible(const std::string& content_type);
+
+    // Send `data` gzip-compressed with chunked transfer encoding. The
+    // response headers must already have been sent.
+    static bool send_chunked(int socket, const char* data, size_t size, int level);
+};
+
+} // namespace server
+} // namespace compressor
+
+#endif // COMPRESSOR_SERVER_GZIP_ENCODING_HPP
@@ -0,0 +1,178 @@
+#include "server/http.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <sys/socket.h>
+
+namespace compressor {
+namespace server {
+
+std::string Http::split_target(const std::string& target, QueryParams& params) {
+    size_t query = target.find('?');
+    if (query == std::string::npos) {
+        return target;
+    }
+
+    size_t pos = query + 1;
+    while (pos <= target.size()) {
+        size_t amp = target.find('&', pos);
+        if (amp == std::string::npos) amp = target.size();
+
+        std::string pair = target.substr(pos, amp - pos);
+        if (!pair.empty()) {
+            size_t eq = pair.find('=');
+            if (eq == std::string::npos) {
+                params[url_decode(pair)] = "";
+            } else {
+                params[url_decode(pair.substr(0, eq))] = url_decode(pair.substr(eq + 1));
+            }
+        }
+        pos = amp + 1;
+    }
+
+    return target.substr(0, query);
+}
+
+std::string Http::header_value(const std::string& request, const std::string& name) {
+    size_t header_end = request.find("\r\n\r\n");
+    if (header_end == std::string::npos) header_end = request.size();
+
+    std::string lower_name = name;
+    std::transform(lower_name.begin(), lower_name.end(), lower_name.begin(), ::tolower);
+
+    // Skip the request line
+    size_t pos = request.find("\r\n");
+    while (pos != std::string::npos && pos < header_end) {
+        pos += 2;
+        size_t line_end = request.find("\r\n", pos);
+        if (line_end == std::string::npos || line_end > header_end) line_end = header_end;
+
+        size_t colon = request.find(':', pos);
+        if (colon != std::string::npos && colon < line_end && colon - pos == lower_name.size()) {
+            std::string key = request.substr(pos, colon - pos);
+            std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+            if (key == lower_name) {
+                size_t value_start = request.find_first_not_of(" \t", colon + 1);
+                if (value_start == std::string::npos || value_start > line_end) return "";
+                size_t value_end = line_end;
+                while (value_end > value_start && (request[value_end - 1] == ' ' || request[value_end - 1] == '\t')) {
+                    value_end--;
+                }
+                return request.substr(value_start, value_end - value_start);
+            }
+        }
+
+        if (line_end >= header_end) break;
+        pos = line_end;
+    }
+
+    return "";
+}
+
+std::vector<std::string> Http::path_segments(const std::string& path) {
+    std::vector<std::string> segments;
+    size_t pos = 0;
+    while (pos < path.size()) {
+        size_t slash = path.find('/', pos);
+        if (slash == std::string::npos) slash = path.size();
+        if (slash > pos) {
+            segments.push_back(path.substr(pos, slash - pos));
+        }
+        pos = slash + 1;
+    }
+    return segments;
+}
+
+std::string Http::url_decode(const std::string& value) {
+    std::string decoded;
+    decoded.reserve(value.size());
+
+    for (size_t i = 0; i < value.size(); ++i) {
+        if (value[i] == '+') {
+            decoded.push_back(' ');
+        } else if (value[i] == '%' && i + 2 < value.size() &&
+                   std::isxdigit(static_cast<unsigned char>(value[i + 1])) &&
+                   std::isxdigit(static_cast<unsigned char>(value[i + 2]))) {
+            decoded.push_back(static_cast<char>(std::stoi(value.substr(i + 1, 2), nullptr, 16)));
+            i += 2;
+        } else {
+            decoded.push_back(value[i]);
+        }
+    }
+
+    return decoded;
+}
+
+bool Http::parse_byte_range(const std::string& spec, size_t& first, size_t& last) {
+    size_t dash = spec.find('-');
+    if (dash == std::string::npos || dash == 0) {
+        return false;
+    }
+
+    std::string from = spec.substr(0, dash);
+    std::string to = spec.substr(dash + 1);
+    auto is_number = [](const std::string& text) {
+        return !text.empty() && text.size() <= 19 && std::all_of(text.begin(), text.end(), ::isdigit);
+    };
+
+    if (!is_number(from) || (!to.empty() && !is_number(to))) {
+        return false;
+    }
+
+    first = std::stoull(from);
+    last = to.empty() ? SIZE_MAX : std::stoull(to);
+    return first <= last;
+}
+
+bool Http::parse_content_length(const std::string& value, size_t& length) {
+    if (value.empty() || !std::isdigit(static_cast<unsigned char>(value[0]))) {
+        return false;
+    }
+    const char* end = value.data() + value.size();
+    auto parsed = std::from_chars(value.data(), end, length);
+    return parsed.ec == std::errc() && parsed.ptr == end;
+}
+
+std::string Http::json_escape(const std::string& value) {
+    std::string escaped;
+    escaped.reserve(value.size() + 8);
+
+    for (char c : value) {
+        switch (c) {
+            case '"': escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\r': escaped += "\\r"; break;
+            case '\t': escaped += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    escaped += buf;
+                } else {
+                    escaped.push_back(c);
+                }
+        }
+    }
+
+    return escaped;
+}
+
+bool Http::send_all(int socket, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t sent = send(socket, data, length, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += sent;
+        length -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+} // namespace server
+} // namespace compressor
@@ -0,0 +1,43 @@
+#ifndef COMPRESSOR_SERVER_HTTP_HPP
+#define COMPRESSOR_SERVER_HTTP_HPP
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace compressor {
+namespace server {
+
+// Small helpers for the hand-rolled HTTP handling in the web server
+class Http {
+public:
+    using QueryParams = std::unordered_map<std::string, std::string>;
+
+    // Split "/path?a=1&b=2" into "/path" and its decoded parameters
+    static std::string split_target(const std::string& target, QueryParams& params);
+
+    // Case-insensitive header lookup within the header block of `request`
+    static std::string header_value(const std::string& request, const std::string& name);
+
+    // Split "/jobs/abc/result" into {"jobs", "abc", "result"}
+    static std::vector<std::string> path_segments(const std::string& path);
+
+    static std::string url_decode(const std::string& value);
+
+    // Parse "first-last" (inclusive) or "first-"; an open end yields SIZE_MAX
+    static bool parse_byte_range(const std::string& spec, size_t& first, size_t& last);
+
+    // Parse a Content-Length value: decimal digits only, no overflow
+    static bool parse_content_length(const std::string& value, size_t& length);
+
+    // Escape a string for embedding in a JSON string literal
+    static std::string json_escape(const std::string& value);
+
+    // Write all of `data` to a socket, retrying short writes
+    static bool send_all(int socket, const char* data, size_t length);
+};
+
+} // namespace server
+} // namespace compressor
+
+#endif // COMPRESSOR_SERVER_HTTP_HPP
@@ -0,0 +1,354 @@
+#include "server/ipc_service.hpp"
+#include "server/metrics.hpp"
+#include "utils/tracing.hpp"
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <poll.h>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace compressor {
+namespace server {
+
+namespace {
+
+// Peak memory of a call relative to its input: the input copy handed to the
+// codec and the codec's output
+constexpr size_t IPC_MEMORY_FACTOR = 3;
+
+const char* status_name(IpcStatus status) {
+    switch (status) {
+        case IpcStatus::OK: return "ok";
+        case IpcStatus::BAD_REQUEST: return "bad_request";
+        case IpcStatus::UNKNOWN_ALGORITHM: return "unknown_algorithm";
+        case IpcStatus::NO_SEGMENT: return "no_segment";
+        case IpcStatus::OUT_OF_RANGE: return "out_of_range";
+        case IpcStatus::OUTPUT_TOO_SMALL: return "output_too_small";
+        case IpcStatus::FAILED: return "failed";
+        case IpcStatus::BUSY: return "busy";
+    }
+    return "unknown";
+}
+
+// True if [offset, offset + size) fits in `limit` without overflowing
+bool region_fits(uint64_t offset, uint64_t size, uint64_t limit) {
+    return offset <= limit && size <= limit - offset;
+}
+
+// Mappings are kept across calls, so a segment the client could truncate
+// would fault the server on its next read; only growth is allowed
+bool shrink_sealed(int fd) {
+    int seals = fcntl(fd, F_GET_SEALS);
+    return seals >= 0 && (seals & F_SEAL_SHRINK);
+}
+
+} // namespace
+
+IpcService::Segment::~Segment() {
+    reset();
+}
+
+void IpcService::Segment::reset() {
+    if (data) {
+        munmap(data, size);
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+    fd = -1;
+    data = nullptr;
+    size = 0;
+    writable = false;
+}
+
+bool IpcService::Segment::ensure(size_t needed) {
+    if (fd < 0) {
+        return false;
+    }
+    if (data && size >= needed) {
+        return true;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<uint64_t>(st.st_size) < needed || st.st_size == 0) {
+        return false;
+    }
+
+    if (data) {
+        munmap(data, size);
+        data = nullptr;
+        size = 0;
+    }
+
+    int protection = writable ? PROT_READ | PROT_WRITE : PROT_READ;
+    void* mapped = mmap(nullptr, static_cast<size_t>(st.st_size), protection, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+    data = static_cast<uint8_t*>(mapped);
+    size = static_cast<size_t>(st.st_size);
+    return true;
+}
+
+IpcService::IpcService(CodecPool& codecs, AdmissionController& admission)
+    : codecs_(codecs), admission_(admission), listen_fd_(-1), running_(false), connections_(0) {
+    for (auto& counter : requests_) {
+        counter.store(0);
+    }
+}
+
+IpcService::~IpcService() {
+    stop();
+}
+
+bool IpcService::start(const std::string& path) {
+    sockaddr_un address{};
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Invalid IPC socket path: " << path << std::endl;
+        return false;
+    }
+
+    listen_fd_ = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        std::cerr << "Error creating IPC socket" << std::endl;
+        return false;
+    }
+
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    unlink(path.c_str());
+
+    if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        listen(listen_fd_, SOMAXCONN) < 0) {
+        std::cerr << "Error binding IPC socket " << path << std::endl;
+        close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    path_ = path;
+    running_ = true;
+    acceptor_ = std::thread(&IpcService::accept_loop, this);
+    std::cout << "IPC service listening on " << path << std::endl;
+    return true;
+}
+
+void IpcService::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    if (acceptor_.joinable()) {
+        acceptor_.join();
+    }
+    close(listen_fd_);
+    listen_fd_ = -1;
+    unlink(path_.c_str());
+
+    // Wake connections blocked in recvmsg; each finishes its current call
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (int fd : open_fds_) {
+            shutdown(fd, SHUT_RDWR);
+        }
+    }
+    while (connections_.load() > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+}
+
+void IpcService::accept_loop() {
+    while (running_) {
+        struct pollfd listener = {listen_fd_, POLLIN, 0};
+        if (poll(&listener, 1, 250) <= 0) {
+            continue;
+        }
+
+        int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            continue;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            open_fds_.insert(fd);
+        }
+        connections_.fetch_add(1);
+        std::thread([this, fd]() {
+            serve(fd);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                open_fds_.erase(fd);
+            }
+            close(fd);
+            connections_.fetch_sub(1);
+        }).detach();
+    }
+}
+
+void IpcService::serve(int fd) {
+    Segment input;
+    Segment output;
+    bool shared = true;  // One segment holds both regions
+
+    while (true) {
+        IpcRequest request;
+        iovec iov{&request, sizeof(request)};
+        alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * 2)];
+
+        msghdr message{};
+        message.msg_iov = &iov;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        ssize_t received = recvmsg(fd, &message, MSG_CMSG_CLOEXEC);
+        if (received <= 0) {
+            return;
+        }
+
+        int fds[2] = {-1, -1};
+        size_t fd_count = 0;
+        for (cmsghdr* header = CMSG_FIRSTHDR(&message); header; header = CMSG_NXTHDR(&message, header)) {
+            if (header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_RIGHTS) {
+                size_t count = (header->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+                const int* passed = reinterpret_cast<const int*>(CMSG_DATA(header));
+                for (size_t i = 0; i < count; ++i) {
+                    if (fd_count < 2) {
+                        std::memcpy(&fds[fd_count++], passed + i, sizeof(int));
+                    } else {
+                        int extra;
+                        std::memcpy(&extra, passed + i, sizeof(int));
+                        close(extra);
+                    }
+                }
+            }
+        }
+
+        IpcResponse response{};
+        response.magic = IPC_MAGIC;
+        IpcStatus status;
+
+        if (static_cast<size_t>(received) != sizeof(request) || (message.msg_flags & (MSG_TRUNC | MSG_CTRUNC))) {
+            for (size_t i = 0; i < fd_count; ++i) close(fds[i]);
+            status = IpcStatus::BAD_REQUEST;
+        } else {
+            // New descriptors replace the connection's segments
+            bool sealed = true;
+            for (size_t i = 0; i < fd_count; ++i) {
+                sealed = sealed && shrink_sealed(fds[i]);
+            }
+            if (fd_count > 0) {
+                input.reset();
+                output.reset();
+            }
+            if (!sealed) {
+                for (size_t i = 0; i < fd_count; ++i) close(fds[i]);
+                fd_count = 0;
+            } else if (fd_count > 0) {
+                shared = fd_count == 1;
+                input.fd = fds[0];
+                input.writable = shared;
+                if (!shared) {
+                    output.fd = fds[1];
+                    output.writable = true;
+                }
+            }
+            status = handle(request, input, shared ? input : output, response);
+        }
+
+        response.status = static_cast<int32_t>(status);
+        requests_[static_cast<size_t>(status)].fetch_add(1, std::memory_order_relaxed);
+        if (send(fd, &response, sizeof(response), MSG_NOSIGNAL) != static_cast<ssize_t>(sizeof(response))) {
+            return;
+        }
+    }
+}
+
+IpcStatus IpcService::handle(const IpcRequest& request, Segment& input, Segment& output, IpcResponse& response) {
+    utils::TraceSpan span("ipc.call", "server");
+    if (request.magic != IPC_MAGIC || request.version != IPC_VERSION || request.operation > 1) {
+        Metrics::instance().record_error(ErrorType::BAD_REQUEST);
+        return IpcStatus::BAD_REQUEST;
+    }
+    bool compress = request.operation == 0;
+
+    if (input.fd < 0 || output.fd < 0) {
+        return IpcStatus::NO_SEGMENT;
+    }
+    if (!region_fits(request.input_offset, request.input_size, UINT64_MAX - 1) ||
+        !region_fits(request.output_offset, request.output_capacity, UINT64_MAX - 1) ||
+        !input.ensure(request.input_offset + request.input_size) ||
+        !output.ensure(request.output_offset + request.output_capacity) || !output.writable) {
+        return IpcStatus::OUT_OF_RANGE;
+    }
+
+    AdmissionTicket ticket = admission_.admit(request.input_size * IPC_MEMORY_FACTOR,
+                                              admission_.classify(request.input_size));
+    if (!ticket.admitted()) {
+        Metrics::instance().record_error(ErrorType::OVERLOADED);
+        return IpcStatus::BUSY;
+    }
+
+    // Leased only once admitted, so refused calls do not hold a pooled codec
+    std::string algorithm(request.algorithm, strnlen(request.algorithm, sizeof(request.algorithm)));
+    auto codec = codecs_.acquire(algorithm);
+    if (!codec) {
+        Metrics::instance().record_error(ErrorType::INVALID_ALGORITHM);
+        return IpcStatus::UNKNOWN_ALGORITHM;
+    }
+
+    // Copied out before coding, so input and output regions may overlap
+    const uint8_t* source = input.data + request.input_offset;
+    ByteVector data(source, source + request.input_size);
+
+    auto start = std::chrono::steady_clock::now();
+    auto result = compress ? codec->compress(data) : codec->decompress(data);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    response.duration_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+
+    if (!result.is_success()) {
+        Metrics::instance().record_error(compress ? ErrorType::COMPRESSION_FAILED : ErrorType::DECOMPRESSION_FAILED);
+        return IpcStatus::FAILED;
+    }
+
+    const ByteVector& produced = result.data();
+    response.required_size = produced.size();
+    if (produced.size() > request.output_capacity) {
+        return IpcStatus::OUTPUT_TOO_SMALL;
+    }
+
+    std::memcpy(output.data + request.output_offset, produced.data(), produced.size());
+    response.output_size = produced.size();
+
+    Metrics::instance().record_operation(algorithm, compress ? Operation::COMPRESS : Operation::DECOMPRESS,
+                                         data.size(), produced.size(),
+                                         std::chrono::duration<double, std::milli>(elapsed).count());
+    return IpcStatus::OK;
+}
+
+std::string IpcService::to_prometheus() const {
+    std::ostringstream oss;
+
+    oss << "# HELP compressor_ipc_connections Open IPC client connections.\n";
+    oss << "# TYPE compressor_ipc_connections gauge\n";
+    oss << "compressor_ipc_connections " << connections_.load() << "\n";
+
+    oss << "# HELP compressor_ipc_requests_total IPC requests by result.\n";
+    oss << "# TYPE compressor_ipc_requests_total counter\n";
+    for (size_t i = 0; i < STATUS_COUNT; ++i) {
+        oss << "compressor_ipc_requests_total{status=\"" << status_name(static_cast<IpcStatus>(i)) << "\"} "
+            << requests_[i].load(std::memory_order_relaxed) << "\n";
+    }
+
+    return oss.str();
+}
+
+} // namespace server
+} // namespace compressor
@@ -0,0 +1,121 @@
+#ifndef COMPRESSOR_SERVER_IPC_SERVICE_HPP
+#define COMPRESSOR_SERVER_IPC_SERVICE_HPP
+
+#include "server/admission.hpp"
+#include "server/codec_pool.hpp"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+namespace compressor {
+namespace server {
+
+// Wire format of the local IPC service. Both ends share a host, so fields
+// are in native byte order and fixed-size; every message is one
+// SOCK_SEQPACKET record.
+constexpr uint32_t IPC_MAGIC = 0x43495043;  // "CIPC"
+constexpr uint16_t IPC_VERSION = 1;
+
+enum class IpcStatus : int32_t {
+    OK = 0,
+    BAD_REQUEST,         // Wrong size, magic, version or operation
+    UNKNOWN_ALGORITHM,
+    NO_SEGMENT,          // No usable shared memory: none passed yet, or not sealed
+                         // against shrinking
+    OUT_OF_RANGE,        // Input or output region exceeds its segment
+    OUTPUT_TOO_SMALL,    // `required_size` holds the capacity needed
+    FAILED,              // The codec rejected the input
+    BUSY                 // Refused by admission control
+};
+
+struct IpcRequest {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t operation;        // 0 = compress, 1 = decompress
+    uint8_t reserved;
+    char algorithm[32];       // NUL-terminated registry name
+    uint64_t input_offset;    // Region of the input segment to read
+    uint64_t input_size;
+    uint64_t output_offset;   // Region of the output segment to write
+    uint64_t output_capacity;
+};
+
+struct IpcResponse {
+    uint32_t magic;
+    int32_t status;           // IpcStatus
+    uint64_t output_size;     // Bytes written at output_offset
+    uint64_t required_size;   // Output size, also reported when it did not fit
+    uint64_t duration_ns;     // Codec time
+};
+
+// Compression sidecar on a Unix-domain socket for co-located processes.
+//
+// Clients keep a connection open and pass shared memory (typically a
+// memfd) as SCM_RIGHTS ancillary data: one descriptor holds both input and
+// output regions, two are taken as [input, output]. Each must carry
+// F_SEAL_SHRINK (memfd_create with MFD_ALLOW_SEALING, then F_ADD_SEALS);
+// unsealed descriptors are dropped and answered with NO_SEGMENT. The
+// server maps them once and keeps the mapping for the connection, so
+// later requests carry no descriptors and cost one small message each
+// way. Each request names regions by offset; the result is written
+// straight into the output region and only lengths and timing come back.
+// Work is charged to the HTTP server's admission controller and uses its
+// codec pool.
+class IpcService {
+public:
+    IpcService(CodecPool& codecs, AdmissionController& admission);
+    ~IpcService();
+
+    IpcService(const IpcService&) = delete;
+    IpcService& operator=(const IpcService&) = delete;
+
+    // Bind `path` (replacing a stale socket file) and start accepting
+    bool start(const std::string& path);
+
+    // Stop accepting, close open connections and wait for their threads
+    void stop();
+
+    size_t active_connections() const { return connections_.load(); }
+
+    std::string to_prometheus() const;
+
+private:
+    struct Segment {
+        int fd = -1;
+        uint8_t* data = nullptr;
+        size_t size = 0;
+        bool writable = false;
+
+        ~Segment();
+        void reset();
+        // Map (or remap after the client grew it) at least `needed` bytes
+        bool ensure(size_t needed);
+    };
+
+    void accept_loop();
+    void serve(int fd);
+    IpcStatus handle(const IpcRequest& request, Segment& input, Segment& output, IpcResponse& response);
+
+    CodecPool& codecs_;
+    AdmissionController& admission_;
+
+    std::string path_;
+    int listen_fd_;
+    std::atomic<bool> running_;
+    std::thread acceptor_;
+
+    mutable std::mutex mutex_;
+    std::set<int> open_fds_;
+    std::atomic<size_t> connections_;
+
+    static constexpr size_t STATUS_COUNT = static_cast<size_t>(IpcStatus::BUSY) + 1;
+    std::atomic<uint64_t> requests_[STATUS_COUNT];
+};
+
+} // namespace server
+} // namespace compressor
+
+#endif // COMPRESSOR_SERVER_IPC_SERVICE_HPP
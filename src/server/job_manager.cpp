@@ -0,0 +1,478 @@
+#include "server/job_manager.hpp"
+#include "core/algorithm.hpp"
+#include "server/http.hpp"
+#include "utils/block_container.hpp"
+#include "utils/file_utils.hpp"
+#include "utils/hash.hpp"
+#include "utils/tracing.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace compressor {
+namespace server {
+
+std::string JobInfo::to_json() const {
+    std::ostringstream oss;
+    oss << "{";
+    oss << "\"id\": \"" << id << "\",";
+    oss << "\"status\": \"" << JobManager::state_name(state) << "\",";
+    oss << "\"operation\": \"" << JobManager::operation_name(operation) << "\",";
+    oss << "\"algorithm\": \"" << Http::json_escape(algorithm) << "\",";
+    oss << "\"progress\": " << std::fixed << std::setprecision(4) << progress() << ",";
+    oss << "\"input_size\": " << input_size << ",";
+    oss << "\"bytes_processed\": " << bytes_processed << ",";
+    oss << "\"output_size\": " << output_size << ",";
+    if (state == JobState::COMPLETED && operation == JobOperation::COMPRESS && input_size > 0) {
+        oss << "\"compression_ratio\": " << std::setprecision(6)
+            << static_cast<double>(output_size) / input_size << ",";
+    }
+    oss << "\"elapsed_ms\": " << std::setprecision(3) << elapsed_ms;
+    if (!error.empty()) {
+        oss << ",\"error\": \"" << Http::json_escape(error) << "\"";
+    }
+    oss << "}";
+    return oss.str();
+}
+
+JobManager::JobManager(utils::ThreadPool& pool, CodecPool& codecs, const std::string& spool_dir,
+                       std::chrono::seconds ttl, size_t block_size)
+    : pool_(pool), codecs_(codecs), spool_dir_(spool_dir), ttl_(ttl), block_size_(block_size), stopping_(false) {
+    if (!utils::FileUtils::file_exists(spool_dir_) && !utils::FileUtils::create_directory(spool_dir_)) {
+        std::cerr << "Warning: cannot create job spool directory " << spool_dir_ << std::endl;
+    }
+    janitor_ = std::thread(&JobManager::janitor_loop, this);
+}
+
+JobManager::~JobManager() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    janitor_cv_.notify_all();
+    if (janitor_.joinable()) {
+        janitor_.join();
+    }
+}
+
+const char* JobManager::state_name(JobState state) {
+    switch (state) {
+        case JobState::RECEIVING: return "receiving";
+        case JobState::QUEUED: return "queued";
+        case JobState::RUNNING: return "running";
+        case JobState::COMPLETED: return "completed";
+        case JobState::FAILED: return "failed";
+    }
+    return "unknown";
+}
+
+const char* JobManager::operation_name(JobOperation operation) {
+    return operation == JobOperation::COMPRESS ? "compress" : "decompress";
+}
+
+std::string JobManager::create(JobOperation operation, const std::string& algorithm) {
+    auto job = std::make_shared<Job>();
+    job->info.id = utils::Hash128::random().to_hex();
+    job->info.operation = operation;
+    job->info.algorithm = algorithm;
+    job->info.state = JobState::RECEIVING;
+    job->created = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_[job->info.id] = job;
+    return job->info.id;
+}
+
+std::string JobManager::create_upload(const std::string& algorithm, size_t total_size) {
+    std::string id = create(JobOperation::COMPRESS, algorithm);
+
+    auto upload = std::make_unique<Upload>();
+    upload->original_sizes.assign(chunk_count(total_size), 0);
+    upload->in_flight.assign(upload->original_sizes.size(), false);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& job = *jobs_[id];
+    job.info.input_size = total_size;
+    job.upload = std::move(upload);
+    return id;
+}
+
+ChunkStatus JobManager::put_chunk(const std::string& id, size_t index, const uint8_t* data, size_t size,
+                                  size_t& compressed_size, std::string& error) {
+    std::shared_ptr<Job> job;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = jobs_.find(id);
+        if (it == jobs_.end() || !it->second->upload || it->second->info.state != JobState::RECEIVING) {
+            error = "Unknown upload";
+            return ChunkStatus::NOT_FOUND;
+        }
+        job = it->second;
+
+        Upload& upload = *job->upload;
+        if (index >= upload.original_sizes.size()) {
+            error = "Chunk index out of range";
+            return ChunkStatus::INVALID;
+        }
+        size_t expected = std::min(block_size_, job->info.input_size - index * block_size_);
+        if (size != expected) {
+            error = "Chunk " + std::to_string(index) + " must be " + std::to_string(expected) + " bytes";
+            return ChunkStatus::INVALID;
+        }
+        if (upload.in_flight[index]) {
+            error = "Chunk " + std::to_string(index) + " is already being uploaded";
+            return ChunkStatus::CONFLICT;
+        }
+        upload.in_flight[index] = true;
+        job->created = std::chrono::steady_clock::now();
+    }
+
+    ChunkStatus status = ChunkStatus::STORED;
+    try {
+        auto codec = codecs_.acquire(job->info.algorithm);
+        if (!codec) {
+            throw CompressionException("Invalid algorithm: " + job->info.algorithm);
+        }
+
+        auto result = codec->compress(ByteVector(data, data + size));
+        if (!result.is_success()) {
+            throw CompressionException("Chunk compression failed: " + result.message());
+        }
+
+        // Write beside the final name so a replaced chunk is never torn
+        std::string path = chunk_path(id, index);
+        if (!utils::FileUtils::write_file(path + ".part", result.data()) ||
+            std::rename((path + ".part").c_str(), path.c_str()) != 0) {
+            throw CompressionException("Failed writing chunk");
+        }
+        compressed_size = result.data().size();
+    } catch (const std::exception& e) {
+        error = e.what();
+        status = ChunkStatus::FAILED;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Upload& upload = *job->upload;
+    upload.in_flight[index] = false;
+    if (status == ChunkStatus::STORED && upload.original_sizes[index] == 0) {
+        upload.original_sizes[index] = static_cast<uint32_t>(size);
+        upload.received++;
+        job->bytes_processed.fetch_add(size, std::memory_order_relaxed);
+    }
+    return status;
+}
+
+bool JobManager::missing_chunks(const std::string& id, std::vector<size_t>& missing) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = jobs_.find(id);
+    if (it == jobs_.end() || !it->second->upload || it->second->info.state != JobState::RECEIVING) {
+        return false;
+    }
+
+    const Upload& upload = *it->second->upload;
+    missing.clear();
+    for (size_t i = 0; i < upload.original_sizes.size(); ++i) {
+        if (upload.original_sizes[i] == 0) {
+            missing.push_back(i);
+        }
+    }
+    return true;
+}
+
+bool JobManager::commit_upload(const std::string& id, std::string& error) {
+    std::shared_ptr<Job> job;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = jobs_.find(id);
+        if (it == jobs_.end() || !it->second->upload || it->second->info.state != JobState::RECEIVING) {
+            error = "Unknown upload";
+            return false;
+        }
+        job = it->second;
+
+        const Upload& upload = *job->upload;
+        size_t missing = upload.original_sizes.size() - upload.received;
+        if (missing > 0) {
+            error = std::to_string(missing) + " chunks missing";
+            return false;
+        }
+        for (bool busy : upload.in_flight) {
+            if (busy) {
+                error = "Chunks still uploading";
+                return false;
+            }
+        }
+        job->info.state = JobState::QUEUED;
+    }
+
+    pool_.post([this, job]() { run(job); });
+    return true;
+}
+
+std::string JobManager::chunk_path(const std::string& id, size_t index) const {
+    return spool_dir_ + "/" + id + "." + std::to_string(index);
+}
+
+std::string JobManager::input_path(const std::string& id) const {
+    return spool_dir_ + "/" + id + ".in";
+}
+
+std::string JobManager::output_path(const std::string& id) const {
+    return spool_dir_ + "/" + id + ".out";
+}
+
+bool JobManager::start(const std::string& id, size_t input_size) {
+    std::shared_ptr<Job> job;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = jobs_.find(id);
+        if (it == jobs_.end() || it->second->info.state != JobState::RECEIVING) {
+            return false;
+        }
+        job = it->second;
+        job->info.state = JobState::QUEUED;
+        job->info.input_size = input_size;
+    }
+
+    pool_.post([this, job]() { run(job); });
+    return true;
+}
+
+void JobManager::abandon(const std::string& id) {
+    size_t chunks = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = jobs_.find(id);
+        if (it != jobs_.end()) {
+            chunks = it->second->upload ? it->second->upload->original_sizes.size() : 0;
+            jobs_.erase(it);
+        }
+    }
+    remove_files(id, chunks);
+}
+
+bool JobManager::get(const std::string& id, JobInfo& info) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = jobs_.find(id);
+    if (it == jobs_.end()) {
+        return false;
+    }
+
+    const auto& job = *it->second;
+    info = job.info;
+    info.bytes_processed = job.bytes_processed.load(std::memory_order_relaxed);
+
+    if (job.info.state == JobState::RUNNING) {
+        info.elapsed_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - job.started).count();
+    }
+    return true;
+}
+
+size_t JobManager::active_jobs() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t active = 0;
+    for (const auto& entry : jobs_) {
+        JobState state = entry.second->info.state;
+        if (state == JobState::QUEUED || state == JobState::RUNNING) {
+            active++;
+        }
+    }
+    return active;
+}
+
+void JobManager::run(std::shared_ptr<Job> job) {
+    const std::string id = job->info.id;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job->info.state = JobState::RUNNING;
+        job->started = std::chrono::steady_clock::now();
+    }
+
+    std::string error;
+    try {
+        if (job->upload) {
+            run_assemble(*job, output_path(id));
+        } else if (job->info.operation == JobOperation::COMPRESS) {
+            run_compress(*job, input_path(id), output_path(id));
+        } else {
+            run_decompress(*job, input_path(id), output_path(id));
+        }
+    } catch (const std::exception& e) {
+        error = e.what();
+    }
+
+    // The input is no longer needed either way
+    std::remove(input_path(id).c_str());
+    if (job->upload) {
+        for (size_t i = 0; i < job->upload->original_sizes.size(); ++i) {
+            std::remove(chunk_path(id, i).c_str());
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    job->finished = std::chrono::steady_clock::now();
+    job->info.elapsed_ms = std::chrono::duration<double, std::milli>(job->finished - job->started).count();
+    job->info.bytes_processed = job->bytes_processed.load(std::memory_order_relaxed);
+
+    if (error.empty()) {
+        job->info.state = JobState::COMPLETED;
+        job->info.output_size = utils::FileUtils::get_file_size(output_path(id));
+    } else {
+        job->info.state = JobState::FAILED;
+        job->info.error = error;
+        std::remove(output_path(id).c_str());
+    }
+}
+
+void JobManager::run_compress(Job& job, const std::string& in_path, const std::string& out_path) {
+    utils::TraceSpan span("job.compress", "server");
+    auto algorithm = codecs_.acquire(job.info.algorithm);
+    if (!algorithm) {
+        throw CompressionException("Invalid algorithm: " + job.info.algorithm);
+    }
+
+    utils::FileUtils::FileReader reader(in_path, block_size_);
+    if (!reader.is_open()) {
+        throw CompressionException("Cannot open job input");
+    }
+
+    std::ofstream out(out_path, std::ios::binary);
+    if (!out) {
+        throw CompressionException("Cannot create job output");
+    }
+
+    utils::BlockContainer::write_header(out, utils::BlockContainerHeader(job.info.algorithm, block_size_));
+
+    while (reader.has_more()) {
+        ByteVector block = reader.read_chunk();
+        if (block.empty()) break;
+
+        auto result = algorithm->compress(block);
+        if (!result.is_success()) {
+            throw CompressionException("Block compression failed: " + result.message());
+        }
+
+        utils::BlockContainer::write_block(out, static_cast<uint32_t>(block.size()), result.data());
+        if (!out) {
+            throw CompressionException("Failed writing job output");
+        }
+
+        job.bytes_processed.fetch_add(block.size(), std::memory_order_relaxed);
+
+        // Jobs are bulk work: let queued small requests go first
+        pool_.run_pending_high();
+    }
+}
+
+void JobManager::run_decompress(Job& job, const std::string& in_path, const std::string& out_path) {
+    utils::TraceSpan span("job.decompress", "server");
+    std::ifstream in(in_path, std::ios::binary);
+    if (!in) {
+        throw DecompressionException("Cannot open job input");
+    }
+
+    auto header = utils::BlockContainer::read_header(in);
+    auto algorithm = codecs_.acquire(header.algorithm);
+    if (!algorithm) {
+        throw DecompressionException("Container uses unknown algorithm: " + header.algorithm);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job.info.algorithm = header.algorithm;
+    }
+    job.bytes_processed.fetch_add(static_cast<size_t>(in.tellg()), std::memory_order_relaxed);
+
+    std::ofstream out(out_path, std::ios::binary);
+    if (!out) {
+        throw DecompressionException("Cannot create job output");
+    }
+
+    uint32_t original_size = 0;
+    ByteVector compressed;
+    while (utils::BlockContainer::read_block(in, header.block_size, original_size, compressed)) {
+        auto result = algorithm->decompress(compressed);
+        if (!result.is_success()) {
+            throw DecompressionException("Block decompression failed: " + result.message());
+        }
+        if (result.data().size() != original_size) {
+            throw DecompressionException("Block size mismatch after decompression");
+        }
+
+        out.write(reinterpret_cast<const char*>(result.data().data()), result.data().size());
+        if (!out) {
+            throw DecompressionException("Failed writing job output");
+        }
+
+        job.bytes_processed.fetch_add(compressed.size() + 8, std::memory_order_relaxed);
+        pool_.run_pending_high();
+    }
+}
+
+void JobManager::run_assemble(Job& job, const std::string& out_path) {
+    std::ofstream out(out_path, std::ios::binary);
+    if (!out) {
+        throw CompressionException("Cannot create job output");
+    }
+
+    utils::BlockContainer::write_header(out, utils::BlockContainerHeader(job.info.algorithm, block_size_));
+
+    const Upload& upload = *job.upload;
+    for (size_t i = 0; i < upload.original_sizes.size(); ++i) {
+        ByteVector compressed = utils::FileUtils::read_file(chunk_path(job.info.id, i));
+        utils::BlockContainer::write_block(out, upload.original_sizes[i], compressed);
+        if (!out) {
+            throw CompressionException("Failed writing job output");
+        }
+    }
+}
+
+void JobManager::janitor_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (!stopping_) {
+        janitor_cv_.wait_for(lock, std::chrono::seconds(30), [this] { return stopping_; });
+        if (stopping_) break;
+
+        auto now = std::chrono::steady_clock::now();
+        std::vector<std::pair<std::string, size_t>> expired;
+
+        for (auto it = jobs_.begin(); it != jobs_.end();) {
+            const auto& job = *it->second;
+            bool finished = job.info.state == JobState::COMPLETED || job.info.state == JobState::FAILED;
+            // Uploads that stalled are reclaimed on the same schedule
+            auto reference = finished ? job.finished : job.created;
+            bool stale = finished || job.info.state == JobState::RECEIVING;
+
+            if (stale && now - reference > ttl_) {
+                expired.emplace_back(it->first, job.upload ? job.upload->original_sizes.size() : 0);
+                it = jobs_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        lock.unlock();
+        for (const auto& entry : expired) {
+            remove_files(entry.first, entry.second);
+        }
+        lock.lock();
+    }
+}
+
+void JobManager::remove_files(const std::string& id, size_t chunks) const {
+    std::remove(input_path(id).c_str());
+    std::remove(output_path(id).c_str());
+    for (size_t i = 0; i < chunks; ++i) {
+        std::remove(chunk_path(id, i).c_str());
+        std::remove((chunk_path(id, i) + ".part").c_str());
+    }
+}
+
+} // namespace server
+} // namespace compressor
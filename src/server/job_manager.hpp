@@ -0,0 +1,162 @@
+#ifndef COMPRESSOR_SERVER_JOB_MANAGER_HPP
+#define COMPRESSOR_SERVER_JOB_MANAGER_HPP
+
+#include "core/common.hpp"
+#include "server/codec_pool.hpp"
+#include "utils/thread_pool.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace compressor {
+namespace server {
+
+enum class JobState {
+    RECEIVING,   // Upload still being spooled to disk
+    QUEUED,
+    RUNNING,
+    COMPLETED,
+    FAILED
+};
+
+enum class JobOperation {
+    COMPRESS,    // Raw input -> block container
+    DECOMPRESS   // Block container -> raw output
+};
+
+enum class ChunkStatus {
+    STORED,
+    NOT_FOUND,   // No open upload with that id
+    INVALID,     // Index out of range or wrong chunk size
+    CONFLICT,    // The same chunk is being uploaded concurrently
+    FAILED       // Compression or spool I/O failed
+};
+
+// Snapshot of a job's state for status responses
+struct JobInfo {
+    std::string id;
+    JobOperation operation;
+    std::string algorithm;
+    JobState state;
+    size_t input_size;
+    size_t bytes_processed;
+    size_t output_size;
+    std::string error;
+    double elapsed_ms;
+
+    JobInfo() : operation(JobOperation::COMPRESS), state(JobState::RECEIVING)
+              , input_size(0), bytes_processed(0), output_size(0), elapsed_ms(0.0) {}
+
+    double progress() const {
+        return input_size > 0 ? static_cast<double>(bytes_processed) / input_size : 0.0;
+    }
+
+    std::string to_json() const;
+};
+
+// Asynchronous compression jobs backed by on-disk spool files.
+//
+// Inputs are streamed to `<spool>/<id>.in` by the request handler, processed
+// block by block on the shared worker pool into `<spool>/<id>.out`, and
+// removed by a janitor thread once the job is older than the TTL. Memory use
+// per job is bounded by the block size, not the input size.
+//
+// Upload jobs receive their input as numbered chunks of one block each, in
+// any order and over parallel connections. Every chunk is compressed as it
+// arrives and spooled as `<spool>/<id>.<index>`; committing stitches the
+// compressed chunks into the block container, so compression overlaps the
+// transfer and a dropped connection only costs the chunk in flight.
+class JobManager {
+public:
+    JobManager(utils::ThreadPool& pool, CodecPool& codecs, const std::string& spool_dir,
+               std::chrono::seconds ttl, size_t block_size);
+    ~JobManager();
+
+    // Register a job in RECEIVING state; returns its id
+    std::string create(JobOperation operation, const std::string& algorithm);
+
+    // Path the upload for `id` must be written to
+    std::string input_path(const std::string& id) const;
+    std::string output_path(const std::string& id) const;
+
+    // Upload finished: queue the job for processing
+    bool start(const std::string& id, size_t input_size);
+
+    // Upload failed: drop the job and its spool files
+    void abandon(const std::string& id);
+
+    bool get(const std::string& id, JobInfo& info) const;
+
+    // Register a chunked compression upload of `total_size` bytes
+    std::string create_upload(const std::string& algorithm, size_t total_size);
+
+    // Compress and spool chunk `index`; re-sending a chunk replaces it
+    ChunkStatus put_chunk(const std::string& id, size_t index, const uint8_t* data, size_t size,
+                          size_t& compressed_size, std::string& error);
+
+    // Indices not received yet; false if `id` is not an open upload
+    bool missing_chunks(const std::string& id, std::vector<size_t>& missing) const;
+
+    // All chunks received: queue assembly of the output container
+    bool commit_upload(const std::string& id, std::string& error);
+
+    // Chunk size of uploads (one container block)
+    size_t chunk_size() const { return block_size_; }
+    size_t chunk_count(size_t total_size) const { return (total_size + block_size_ - 1) / block_size_; }
+
+    size_t active_jobs() const;
+
+    static const char* state_name(JobState state);
+    static const char* operation_name(JobOperation operation);
+
+private:
+    // Chunk bookkeeping of an upload job
+    struct Upload {
+        std::vector<uint32_t> original_sizes;   // 0 until the chunk is stored
+        std::vector<bool> in_flight;
+        size_t received = 0;
+    };
+
+    struct Job {
+        JobInfo info;
+        std::atomic<size_t> bytes_processed{0};
+        std::unique_ptr<Upload> upload;
+        std::chrono::steady_clock::time_point created;   // Last upload activity while receiving
+        std::chrono::steady_clock::time_point started;
+        std::chrono::steady_clock::time_point finished;
+    };
+
+    void run(std::shared_ptr<Job> job);
+    void run_compress(Job& job, const std::string& in_path, const std::string& out_path);
+    void run_decompress(Job& job, const std::string& in_path, const std::string& out_path);
+    void run_assemble(Job& job, const std::string& out_path);
+
+    std::string chunk_path(const std::string& id, size_t index) const;
+
+    void janitor_loop();
+    void remove_files(const std::string& id, size_t chunks) const;
+
+    utils::ThreadPool& pool_;
+    CodecPool& codecs_;
+    std::string spool_dir_;
+    std::chrono::seconds ttl_;
+    size_t block_size_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::shared_ptr<Job>> jobs_;
+
+    std::thread janitor_;
+    std::condition_variable janitor_cv_;
+    bool stopping_;
+};
+
+} // namespace server
+} // namespace compressor
+
+#endif // COMPRESSOR_SERVER_JOB_MANAGER_HPP
@@ -0,0 +1,217 @@
+#include "server/metrics.hpp"
+#include "core/algorithm.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+namespace compressor {
+namespace server {
+
+constexpr std::array<uint64_t, 14> Metrics::LATENCY_BUCKETS_US;
+
+// Owns the calling thread's shard and hands it back on thread exit
+struct ShardHandle {
+    Metrics::ThreadShard* shard = nullptr;
+
+    ~ShardHandle() {
+        if (shard) {
+            Metrics::instance().release_shard(shard);
+        }
+    }
+};
+
+static const char* operation_name(size_t op) {
+    return op == static_cast<size_t>(Operation::COMPRESS) ? "compress" : "decompress";
+}
+
+Metrics& Metrics::instance() {
+    static Metrics metrics;
+    return metrics;
+}
+
+Metrics::Metrics() {
+    auto algorithms = AlgorithmFactory::list_algorithms();
+    std::sort(algorithms.begin(), algorithms.end());
+
+    for (const auto& name : algorithms) {
+        if (algorithm_names_.size() >= MAX_ALGORITHMS) break;
+        algorithm_slots_[name] = algorithm_names_.size();
+        algorithm_names_.push_back(name);
+    }
+}
+
+Metrics::ThreadShard& Metrics::local_shard() {
+    thread_local ShardHandle handle;
+
+    if (!handle.shard) {
+        std::lock_guard<std::mutex> lock(shards_mutex_);
+        if (!free_shards_.empty()) {
+            handle.shard = free_shards_.back();
+            free_shards_.pop_back();
+        } else {
+            shards_.push_back(std::make_unique<ThreadShard>());
+            handle.shard = shards_.back().get();
+        }
+    }
+
+    return *handle.shard;
+}
+
+void Metrics::release_shard(ThreadShard* shard) {
+    // Counters are kept: the next thread continues from where this one stopped
+    std::lock_guard<std::mutex> lock(shards_mutex_);
+    free_shards_.push_back(shard);
+}
+
+void Metrics::record_operation(const std::string& algorithm, Operation op,
+                               size_t bytes_in, size_t bytes_out, double duration_ms) {
+    auto slot = algorithm_slots_.find(algorithm);
+    if (slot == algorithm_slots_.end()) {
+        return;
+    }
+
+    auto& counters = local_shard().counters[slot->second][static_cast<size_t>(op)];
+    uint64_t duration_us = static_cast<uint64_t>(std::max(0.0, duration_ms) * 1000.0);
+
+    size_t bucket = std::lower_bound(LATENCY_BUCKETS_US.begin(), LATENCY_BUCKETS_US.end(), duration_us)
+                    - LATENCY_BUCKETS_US.begin();
+
+    bump(counters.requests, 1);
+    bump(counters.bytes_in, bytes_in);
+    bump(counters.bytes_out, bytes_out);
+    bump(counters.latency_sum_us, duration_us);
+    bump(counters.buckets[bucket], 1);
+}
+
+void Metrics::record_error(ErrorType type) {
+    errors_[static_cast<size_t>(type)].fetch_add(1, std::memory_order_relaxed);
+}
+
+const char* Metrics::error_type_name(ErrorType type) {
+    switch (type) {
+        case ErrorType::BAD_REQUEST: return "bad_request";
+        case ErrorType::INVALID_ALGORITHM: return "invalid_algorithm";
+        case ErrorType::COMPRESSION_FAILED: return "compression_failed";
+        case ErrorType::DECOMPRESSION_FAILED: return "decompression_failed";
+        case ErrorType::VERIFICATION_FAILED: return "verification_failed";
+        case ErrorType::NOT_FOUND: return "not_found";
+        case ErrorType::METHOD_NOT_ALLOWED: return "method_not_allowed";
+        case ErrorType::PAYLOAD_TOO_LARGE: return "payload_too_large";
+        case ErrorType::OVERLOADED: return "overloaded";
+        case ErrorType::INTERNAL: return "internal";
+        case ErrorType::COUNT: break;
+    }
+    return "unknown";
+}
+
+std::string Metrics::to_prometheus() const {
+    struct Snapshot {
+        uint64_t requests = 0;
+        uint64_t bytes_in = 0;
+        uint64_t bytes_out = 0;
+        uint64_t latency_sum_us = 0;
+        std::array<uint64_t, NUM_BUCKETS> buckets{};
+    };
+
+    // Merge all shards (live and recycled) into one snapshot per series
+    std::vector<std::array<Snapshot, NUM_OPERATIONS>> merged(algorithm_names_.size());
+    {
+        std::lock_guard<std::mutex> lock(shards_mutex_);
+        for (const auto& shard : shards_) {
+            for (size_t a = 0; a < algorithm_names_.size(); ++a) {
+                for (size_t op = 0; op < NUM_OPERATIONS; ++op) {
+                    const auto& src = shard->counters[a][op];
+                    auto& dst = merged[a][op];
+                    dst.requests += src.requests.load(std::memory_order_relaxed);
+                    dst.bytes_in += src.bytes_in.load(std::memory_order_relaxed);
+                    dst.bytes_out += src.bytes_out.load(std::memory_order_relaxed);
+                    dst.latency_sum_us += src.latency_sum_us.load(std::memory_order_relaxed);
+                    for (size_t b = 0; b < NUM_BUCKETS; ++b) {
+                        dst.buckets[b] += src.buckets[b].load(std::memory_order_relaxed);
+                    }
+                }
+            }
+        }
+    }
+
+    std::ostringstream oss;
+
+    auto labels = [&](size_t a, size_t op) {
+        return "algorithm=\"" + algorithm_names_[a] + "\",operation=\"" + operation_name(op) + "\"";
+    };
+
+    auto write_counter = [&](const char* name, const char* help, uint64_t Snapshot::*field) {
+        oss << "# HELP " << name << " " << help << "\n";
+        oss << "# TYPE " << name << " counter\n";
+        for (size_t a = 0; a < merged.size(); ++a) {
+            for (size_t op = 0; op < NUM_OPERATIONS; ++op) {
+                oss << name << "{" << labels(a, op) << "} " << merged[a][op].*field << "\n";
+            }
+        }
+    };
+
+    write_counter("compressor_requests_total",
+                  "Completed codec requests by algorithm and operation.", &Snapshot::requests);
+    write_counter("compressor_bytes_in_total",
+                  "Bytes received by the codec by algorithm and operation.", &Snapshot::bytes_in);
+    write_counter("compressor_bytes_out_total",
+                  "Bytes produced by the codec by algorithm and operation.", &Snapshot::bytes_out);
+
+    const char* histogram = "compressor_operation_duration_seconds";
+    oss << "# HELP " << histogram << " Codec latency by algorithm and operation.\n";
+    oss << "# TYPE " << histogram << " histogram\n";
+    for (size_t a = 0; a < merged.size(); ++a) {
+        for (size_t op = 0; op < NUM_OPERATIONS; ++op) {
+            const auto& snap = merged[a][op];
+            uint64_t cumulative = 0;
+            for (size_t b = 0; b < NUM_BUCKETS; ++b) {
+                cumulative += snap.buckets[b];
+                oss << histogram << "_bucket{" << labels(a, op) << ",le=\"";
+                if (b < LATENCY_BUCKETS_US.size()) {
+                    oss << std::defaultfloat << LATENCY_BUCKETS_US[b] / 1e6;
+                } else {
+                    oss << "+Inf";
+                }
+                oss << "\"} " << cumulative << "\n";
+            }
+            oss << histogram << "_sum{" << labels(a, op) << "} "
+                << std::fixed << std::setprecision(6) << snap.latency_sum_us / 1e6 << "\n";
+            oss << histogram << "_count{" << labels(a, op) << "} " << cumulative << "\n";
+        }
+    }
+
+    auto write_gauge = [&](const char* name, const char* help, int64_t value) {
+        oss << "# HELP " << name << " " << help << "\n";
+        oss << "# TYPE " << name << " gauge\n";
+        oss << name << " " << value << "\n";
+    };
+
+    write_gauge("compressor_queue_depth", "Requests waiting for admission.",
+                queue_depth_.load(std::memory_order_relaxed));
+    write_gauge("compressor_in_flight_requests", "Requests currently being processed.",
+                in_flight_.load(std::memory_order_relaxed));
+    write_gauge("compressor_active_connections", "Open client connections.",
+                active_connections_.load(std::memory_order_relaxed));
+
+    oss << "# HELP compressor_errors_total Failed requests by error type.\n";
+    oss << "# TYPE compressor_errors_total counter\n";
+    for (size_t e = 0; e < errors_.size(); ++e) {
+        oss << "compressor_errors_total{type=\"" << error_type_name(static_cast<ErrorType>(e)) << "\"} "
+            << errors_[e].load(std::memory_order_relaxed) << "\n";
+    }
+
+    HugePages::Stats pages = HugePages::stats();
+    oss << "# HELP compressor_large_allocations_total Buffer allocations of 2 MiB or more by backing.\n";
+    oss << "# TYPE compressor_large_allocations_total counter\n";
+    oss << "compressor_large_allocations_total{backing=\"hugetlb\"} " << pages.hugetlb_allocations << "\n";
+    oss << "compressor_large_allocations_total{backing=\"thp\"} " << pages.thp_allocations << "\n";
+    oss << "compressor_large_allocations_total{backing=\"plain\"} " << pages.plain_allocations << "\n";
+    oss << "compressor_large_allocations_total{backing=\"heap\"} " << pages.heap_allocations << "\n";
+    write_gauge("compressor_large_allocation_bytes", "Bytes currently mapped for large buffers.",
+                static_cast<int64_t>(pages.mapped_bytes));
+
+    return oss.str();
+}
+
+} // namespace server
+} // namespace compressor
@@ -0,0 +1,137 @@
+#ifndef COMPRESSOR_SERVER_METRICS_HPP
+#define COMPRESSOR_SERVER_METRICS_HPP
+
+#include "core/common.hpp"
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace compressor {
+namespace server {
+
+// Operations tracked per algorithm
+enum class Operation {
+    COMPRESS = 0,
+    DECOMPRESS = 1
+};
+
+// Error categories exported as compressor_errors_total{type=...}
+enum class ErrorType {
+    BAD_REQUEST = 0,       // Malformed request (boundary, missing fields)
+    INVALID_ALGORITHM,     // Unknown algorithm name
+    COMPRESSION_FAILED,    // Codec returned an unsuccessful result
+    DECOMPRESSION_FAILED,
+    VERIFICATION_FAILED,   // Round-trip check did not reproduce the input
+    NOT_FOUND,
+    METHOD_NOT_ALLOWED,
+    PAYLOAD_TOO_LARGE,     // Body above the configured request limit
+    OVERLOADED,            // Refused by admission control (503)
+    INTERNAL,              // Exception escaped a handler
+    COUNT
+};
+
+// Prometheus-style metrics registry for the web server.
+//
+// Hot-path updates never take a lock: each thread writes to its own shard
+// (single writer, relaxed atomics) and shards are merged on scrape. Shards
+// are recycled when a connection thread exits so the per-connection thread
+// model does not grow the shard list without bound.
+class Metrics {
+public:
+    static Metrics& instance();
+
+    // Upper bounds of the latency buckets in microseconds (+Inf is implicit)
+    static constexpr std::array<uint64_t, 14> LATENCY_BUCKETS_US = {
+        500, 1000, 2500, 5000, 10000, 25000, 50000,
+        100000, 250000, 500000, 1000000, 2500000, 5000000, 10000000
+    };
+
+    // Record a completed codec operation
+    void record_operation(const std::string& algorithm, Operation op,
+                          size_t bytes_in, size_t bytes_out, double duration_ms);
+
+    void record_error(ErrorType type);
+
+    // Gauges
+    void connection_opened() { active_connections_.fetch_add(1, std::memory_order_relaxed); }
+    void connection_closed() { active_connections_.fetch_sub(1, std::memory_order_relaxed); }
+    void request_started() { in_flight_.fetch_add(1, std::memory_order_relaxed); }
+    void request_finished() { in_flight_.fetch_sub(1, std::memory_order_relaxed); }
+    // Requests waiting in the admission queue
+    void queue_entered() { queue_depth_.fetch_add(1, std::memory_order_relaxed); }
+    void queue_left() { queue_depth_.fetch_sub(1, std::memory_order_relaxed); }
+
+    // Render all metrics in the Prometheus text exposition format
+    std::string to_prometheus() const;
+
+    static const char* error_type_name(ErrorType type);
+
+private:
+    Metrics();
+
+    static constexpr size_t MAX_ALGORITHMS = 16;
+    static constexpr size_t NUM_OPERATIONS = 2;
+    static constexpr size_t NUM_BUCKETS = LATENCY_BUCKETS_US.size() + 1;
+
+    struct OperationCounters {
+        std::atomic<uint64_t> requests{0};
+        std::atomic<uint64_t> bytes_in{0};
+        std::atomic<uint64_t> bytes_out{0};
+        std::atomic<uint64_t> latency_sum_us{0};
+        std::array<std::atomic<uint64_t>, NUM_BUCKETS> buckets{};
+    };
+
+    // Per-thread counters, padded to avoid false sharing between writers
+    struct alignas(64) ThreadShard {
+        std::array<std::array<OperationCounters, NUM_OPERATIONS>, MAX_ALGORITHMS> counters;
+    };
+
+    // Returns this thread's shard, acquiring one on first use
+    ThreadShard& local_shard();
+    void release_shard(ThreadShard* shard);
+
+    // Single-writer increment: only the owning thread modifies a shard
+    static void bump(std::atomic<uint64_t>& counter, uint64_t delta) {
+        counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+
+    // Algorithm name -> counter slot; immutable after construction
+    std::unordered_map<std::string, size_t> algorithm_slots_;
+    std::vector<std::string> algorithm_names_;
+
+    mutable std::mutex shards_mutex_;
+    std::vector<std::unique_ptr<ThreadShard>> shards_;
+    std::vector<ThreadShard*> free_shards_;
+
+    std::array<std::atomic<uint64_t>, static_cast<size_t>(ErrorType::COUNT)> errors_{};
+    std::atomic<int64_t> active_connections_{0};
+    std::atomic<int64_t> in_flight_{0};
+    std::atomic<int64_t> queue_depth_{0};
+
+    friend struct ShardHandle;
+};
+
+// RAII helper for gauge pairs (connection, in-flight, queue)
+class GaugeGuard {
+public:
+    using Hook = void (Metrics::*)();
+
+    GaugeGuard(Hook enter, Hook leave) : leave_(leave) {
+        (Metrics::instance().*enter)();
+    }
+    ~GaugeGuard() { (Metrics::instance().*leave_)(); }
+
+    GaugeGuard(const GaugeGuard&) = delete;
+    GaugeGuard& operator=(const GaugeGuard&) = delete;
+
+private:
+    Hook leave_;
+};
+
+} // namespace server
+} // namespace compressor
+
+#endif // COMPRESSOR_SERVER_METRICS_HPP
@@ -0,0 +1,139 @@
+#include "server/prefork.hpp"
+#include "utils/cpu_topology.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace compressor {
+namespace server {
+
+bool Prefork::parse_pin_mode(const std::string& name, PinMode& mode) {
+    if (name == "none") {
+        mode = PinMode::NONE;
+    } else if (name == "core") {
+        mode = PinMode::CORE;
+    } else if (name == "numa") {
+        mode = PinMode::NUMA;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool Prefork::pin_worker(PinMode pin, size_t worker_index) {
+    if (pin == PinMode::NONE) return true;
+
+    auto topology = utils::CpuTopology::detect();
+    std::vector<int> cpus;
+
+    if (pin == PinMode::CORE && !topology.cpus().empty()) {
+        cpus.push_back(topology.cpus()[worker_index % topology.cpus().size()]);
+    } else if (pin == PinMode::NUMA && !topology.nodes().empty()) {
+        cpus = topology.nodes()[worker_index % topology.nodes().size()];
+    }
+
+    return utils::CpuTopology::pin_current_thread(cpus);
+}
+
+int Prefork::run(size_t processes, PinMode pin, std::chrono::seconds grace,
+                 volatile std::sig_atomic_t& stop_flag, const WorkerMain& worker_main) {
+    using Clock = std::chrono::steady_clock;
+
+    // A worker that fails this quickly is misconfigured, not crashed
+    const auto min_uptime = std::chrono::seconds(1);
+
+    std::vector<pid_t> pids(processes, -1);
+    std::vector<Clock::time_point> started(processes);
+
+    auto spawn = [&](size_t index) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            if (!pin_worker(pin, index)) {
+                std::cerr << "Warning: could not pin worker " << index << std::endl;
+            }
+            std::exit(worker_main(index));
+        }
+        if (pid > 0) {
+            pids[index] = pid;
+            started[index] = Clock::now();
+        }
+        return pid > 0;
+    };
+
+    int exit_code = 0;
+    for (size_t i = 0; i < processes; ++i) {
+        if (!spawn(i)) {
+            std::cerr << "Error: fork failed for worker " << i << std::endl;
+            stop_flag = 1;
+            exit_code = 1;
+            break;
+        }
+    }
+
+    // Supervise: restart workers that die while we are serving
+    while (!stop_flag) {
+        int status = 0;
+        pid_t pid = waitpid(-1, &status, WNOHANG);
+        if (pid <= 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            continue;
+        }
+
+        for (size_t i = 0; i < processes; ++i) {
+            if (pids[i] != pid) continue;
+            pids[i] = -1;
+
+            if (Clock::now() - started[i] < min_uptime) {
+                std::cerr << "Worker " << i << " failed during startup, shutting down" << std::endl;
+                stop_flag = 1;
+                exit_code = 1;
+            } else {
+                std::cerr << "Worker " << i << " (pid " << pid << ") exited, restarting" << std::endl;
+                spawn(i);
+            }
+            break;
+        }
+    }
+
+    std::cout << "Draining " << processes << " workers..." << std::endl;
+    for (pid_t pid : pids) {
+        if (pid > 0) kill(pid, SIGTERM);
+    }
+
+    // Workers enforce the drain deadline themselves; allow a little extra
+    auto deadline = Clock::now() + grace + std::chrono::seconds(5);
+    size_t remaining = 0;
+    do {
+        remaining = 0;
+        for (pid_t& pid : pids) {
+            if (pid <= 0) continue;
+            int status = 0;
+            if (waitpid(pid, &status, WNOHANG) == pid) {
+                pid = -1;
+            } else {
+                remaining++;
+            }
+        }
+        if (remaining > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+    } while (remaining > 0 && Clock::now() < deadline);
+
+    for (pid_t pid : pids) {
+        if (pid > 0) {
+            std::cerr << "Killing unresponsive worker " << pid << std::endl;
+            kill(pid, SIGKILL);
+            waitpid(pid, nullptr, 0);
+        }
+    }
+
+    return exit_code;
+}
+
+} // namespace server
+} // namespace compressor
@@ -0,0 +1,41 @@
+#ifndef COMPRESSOR_SERVER_PREFORK_HPP
+#define COMPRESSOR_SERVER_PREFORK_HPP
+
+#include <chrono>
+#include <csignal>
+#include <functional>
+#include <string>
+
+namespace compressor {
+namespace server {
+
+enum class PinMode {
+    NONE,
+    CORE,   // Worker i runs on the i-th usable CPU
+    NUMA    // Worker i runs on all CPUs of NUMA node i (round robin)
+};
+
+// Multi-process supervisor for the web server.
+//
+// The parent forks one worker per process slot; each worker binds its own
+// SO_REUSEPORT listener so the kernel spreads connections across them.
+// Workers that die unexpectedly are restarted. When `stop_flag` is raised
+// (SIGTERM/SIGINT) the parent forwards SIGTERM, waits for the workers to
+// drain, and kills any still running after `grace`.
+class Prefork {
+public:
+    using WorkerMain = std::function<int(size_t worker_index)>;
+
+    static int run(size_t processes, PinMode pin, std::chrono::seconds grace,
+                   volatile std::sig_atomic_t& stop_flag, const WorkerMain& worker_main);
+
+    // Pin the calling process to the CPUs assigned to `worker_index`
+    static bool pin_worker(PinMode pin, size_t worker_index);
+
+    static bool parse_pin_mode(const std::string& name, PinMode& mode);
+};
+
+} // namespace server
+} // namespace compressor
+
+#endif // COMPRESSOR_SERVER_PREFORK_HPP
@@ -0,0 +1,126 @@
+#include "server/result_cache.hpp"
+#include <sstream>
+
+namespace compressor {
+namespace server {
+
+ResultCache::ResultCache(size_t max_bytes)
+    : max_bytes_(max_bytes), shard_budget_(max_bytes / NUM_SHARDS) {
+}
+
+size_t ResultCache::entry_charge(const CacheKey& key, const CachedResult& result) {
+    // Payload plus a rough allowance for list/map nodes and the key
+    return (result.compressed ? result.compressed->size() : 0) + key.algorithm.size() + 128;
+}
+
+bool ResultCache::lookup(const CacheKey& key, CachedResult& out) {
+    if (!enabled()) {
+        return false;
+    }
+
+    auto& shard = shard_for(key);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.index.find(key);
+        if (it != shard.index.end()) {
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+            out = it->second->result;
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void ResultCache::insert(const CacheKey& key, const CachedResult& result) {
+    if (!enabled() || !result.compressed) {
+        return;
+    }
+
+    size_t charge = entry_charge(key, result);
+    if (charge > shard_budget_) {
+        return; // Would evict the whole shard for a single entry
+    }
+
+    auto& shard = shard_for(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto existing = shard.index.find(key);
+    if (existing != shard.index.end()) {
+        shard.bytes -= existing->second->charge;
+        shard.lru.erase(existing->second);
+        shard.index.erase(existing);
+    }
+
+    while (!shard.lru.empty() && shard.bytes + charge > shard_budget_) {
+        auto& victim = shard.lru.back();
+        shard.bytes -= victim.charge;
+        shard.index.erase(victim.key);
+        shard.lru.pop_back();
+        evictions_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    shard.lru.push_front(Entry{key, result, charge});
+    shard.index[key] = shard.lru.begin();
+    shard.bytes += charge;
+    insertions_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ResultCache::clear() {
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.index.clear();
+        shard.lru.clear();
+        shard.bytes = 0;
+    }
+}
+
+size_t ResultCache::size_bytes() const {
+    size_t total = 0;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.bytes;
+    }
+    return total;
+}
+
+size_t ResultCache::entry_count() const {
+    size_t total = 0;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.index.size();
+    }
+    return total;
+}
+
+std::string ResultCache::to_prometheus() const {
+    std::ostringstream oss;
+
+    oss << "# HELP compressor_cache_lookups_total Result cache lookups by outcome.\n";
+    oss << "# TYPE compressor_cache_lookups_total counter\n";
+    oss << "compressor_cache_lookups_total{result=\"hit\"} " << hits() << "\n";
+    oss << "compressor_cache_lookups_total{result=\"miss\"} " << misses() << "\n";
+
+    oss << "# HELP compressor_cache_insertions_total Results stored in the cache.\n";
+    oss << "# TYPE compressor_cache_insertions_total counter\n";
+    oss << "compressor_cache_insertions_total " << insertions_.load(std::memory_order_relaxed) << "\n";
+
+    oss << "# HELP compressor_cache_evictions_total Results evicted to stay within the byte budget.\n";
+    oss << "# TYPE compressor_cache_evictions_total counter\n";
+    oss << "compressor_cache_evictions_total " << evictions() << "\n";
+
+    oss << "# HELP compressor_cache_bytes Bytes currently charged to the cache.\n";
+    oss << "# TYPE compressor_cache_bytes gauge\n";
+    oss << "compressor_cache_bytes " << size_bytes() << "\n";
+
+    oss << "# HELP compressor_cache_entries Results currently cached.\n";
+    oss << "# TYPE compressor_cache_entries gauge\n";
+    oss << "compressor_cache_entries " << entry_count() << "\n";
+
+    return oss.str();
+}
+
+} // namespace server
+} // namespace compressor
@@ -0,0 +1,109 @@
+#ifndef COMPRESSOR_SERVER_RESULT_CACHE_HPP
+#define COMPRESSOR_SERVER_RESULT_CACHE_HPP
+
+#include "core/common.hpp"
+#include "utils/hash.hpp"
+#include <array>
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace compressor {
+namespace server {
+
+// Identifies one compression: input content + codec + codec settings
+struct CacheKey {
+    utils::Hash128 content_hash;
+    size_t original_size;
+    std::string algorithm;
+    size_t block_size;
+    uint32_t dictionary_id;
+
+    bool operator==(const CacheKey& other) const {
+        return content_hash == other.content_hash && original_size == other.original_size &&
+               algorithm == other.algorithm && block_size == other.block_size &&
+               dictionary_id == other.dictionary_id;
+    }
+};
+
+struct CacheKeyHasher {
+    size_t operator()(const CacheKey& key) const noexcept {
+        size_t h = std::hash<utils::Hash128>()(key.content_hash);
+        h ^= std::hash<std::string>()(key.algorithm) + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+        h ^= key.block_size + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+        h ^= key.dictionary_id + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+        return h;
+    }
+};
+
+// Cached outcome of a compress request
+struct CachedResult {
+    std::shared_ptr<const ByteVector> compressed;
+    CompressionStats stats;
+    bool verified;
+
+    CachedResult() : verified(false) {}
+};
+
+// Memory-bounded LRU cache of compression results keyed by content hash.
+//
+// The key space is split across independently locked shards so concurrent
+// requests for different content rarely contend. Each shard enforces an
+// equal share of the total byte budget.
+class ResultCache {
+public:
+    explicit ResultCache(size_t max_bytes);
+
+    bool enabled() const { return max_bytes_ > 0; }
+
+    // Returns true and fills `out` on a hit
+    bool lookup(const CacheKey& key, CachedResult& out);
+    void insert(const CacheKey& key, const CachedResult& result);
+    void clear();
+
+    uint64_t hits() const { return hits_.load(std::memory_order_relaxed); }
+    uint64_t misses() const { return misses_.load(std::memory_order_relaxed); }
+    uint64_t evictions() const { return evictions_.load(std::memory_order_relaxed); }
+    size_t size_bytes() const;
+    size_t entry_count() const;
+
+    std::string to_prometheus() const;
+
+private:
+    static constexpr size_t NUM_SHARDS = 16;
+
+    struct Entry {
+        CacheKey key;
+        CachedResult result;
+        size_t charge;
+    };
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::list<Entry> lru;  // Front is most recently used
+        std::unordered_map<CacheKey, std::list<Entry>::iterator, CacheKeyHasher> index;
+        size_t bytes = 0;
+    };
+
+    Shard& shard_for(const CacheKey& key) {
+        return shards_[key.content_hash.high % NUM_SHARDS];
+    }
+
+    static size_t entry_charge(const CacheKey& key, const CachedResult& result);
+
+    size_t max_bytes_;
+    size_t shard_budget_;
+    std::array<Shard, NUM_SHARDS> shards_;
+
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> insertions_{0};
+    std::atomic<uint64_t> evictions_{0};
+};
+
+} // namespace server
+} // namespace compressor
+
+#endif // COMPRESSOR_SERVER_RESULT_CACHE_HPP
@@ -0,0 +1,219 @@
+#include "server/server_config.hpp"
+#include "utils/cpu_topology.hpp"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+namespace compressor {
+namespace server {
+
+ServerConfig::ServerConfig()
+    : port(8080), cache_max_bytes(64 * 1024 * 1024), max_request_bytes(20 * 1024 * 1024)
+    , retry_after_seconds(1), spool_dir("/tmp/compressor-jobs"), job_ttl(3600)
+    , job_block_size(4 * 1024 * 1024), max_job_bytes(16ULL * 1024 * 1024 * 1024), benchmark_threads(2)
+    , processes(1), async_endpoints(true), pin(PinMode::NONE), numa_pool(false)
+    , huge_pages(HugePages::mode()), drain_timeout(30)
+    , gzip_min_bytes(1024), gzip_level(1), trace_sample_rate(0.0), help(false) {
+    // Affinity mask and cgroup quota, not the host's core count
+    size_t cores = utils::CpuTopology::detect().usable_cpus();
+    admission.max_concurrent = cores;
+    worker_threads = cores;
+}
+
+ServerConfig ServerConfig::from_args(int argc, char* argv[]) {
+    ServerConfig config;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "-h" || arg == "--help") {
+            config.help = true;
+        } else if (arg == "-p" || arg == "--port") {
+            if (i + 1 < argc) {
+                config.port = std::stoi(argv[++i]);
+            }
+        } else if (arg == "--cache-mb") {
+            if (i + 1 < argc) {
+                config.cache_max_bytes = std::stoul(argv[++i]) * 1024 * 1024;
+            }
+        } else if (arg == "--max-request-mb") {
+            if (i + 1 < argc) {
+                config.max_request_bytes = std::stoul(argv[++i]) * 1024 * 1024;
+            }
+        } else if (arg == "--max-inflight-mb") {
+            if (i + 1 < argc) {
+                config.admission.max_inflight_bytes = std::stoul(argv[++i]) * 1024 * 1024;
+            }
+        } else if (arg == "--max-concurrent") {
+            if (i + 1 < argc) {
+                config.admission.max_concurrent = std::stoul(argv[++i]);
+            }
+        } else if (arg == "--max-queue") {
+            if (i + 1 < argc) {
+                config.admission.max_queue = std::stoul(argv[++i]);
+            }
+        } else if (arg == "--queue-timeout-ms") {
+            if (i + 1 < argc) {
+                config.admission.queue_timeout = std::chrono::milliseconds(std::stoul(argv[++i]));
+            }
+        } else if (arg == "--small-request-kb") {
+            if (i + 1 < argc) {
+                config.admission.small_request_bytes = std::stoul(argv[++i]) * 1024;
+            }
+        } else if (arg == "--reserved-small") {
+            if (i + 1 < argc) {
+                config.admission.reserved_small = std::stoul(argv[++i]);
+            }
+        } else if (arg == "--verify") {
+            if (i + 1 < argc) {
+                std::string mode = argv[++i];
+                if (!VerificationPolicy::parse_mode(mode, config.verification.mode)) {
+                    throw std::invalid_argument("Unknown verification mode: " + mode);
+                }
+            }
+        } else if (arg == "--verify-sample-rate") {
+            if (i + 1 < argc) {
+                config.verification.sample_rate = std::stod(argv[++i]);
+            }
+        } else if (arg == "--workers") {
+            if (i + 1 < argc) {
+                config.worker_threads = std::stoul(argv[++i]);
+            }
+        } else if (arg == "--spool-dir") {
+            if (i + 1 < argc) {
+                config.spool_dir = argv[++i];
+            }
+        } else if (arg == "--job-ttl-s") {
+            if (i + 1 < argc) {
+                config.job_ttl = std::chrono::seconds(std::stoul(argv[++i]));
+            }
+        } else if (arg == "--job-block-mb") {
+            if (i + 1 < argc) {
+                config.job_block_size = std::stoul(argv[++i]) * 1024 * 1024;
+            }
+        } else if (arg == "--max-job-mb") {
+            if (i + 1 < argc) {
+                config.max_job_bytes = std::stoull(argv[++i]) * 1024 * 1024;
+            }
+        } else if (arg == "--benchmark-threads") {
+            if (i + 1 < argc) {
+                config.benchmark_threads = std::stoul(argv[++i]);
+            }
+        } else if (arg == "--processes") {
+            if (i + 1 < argc) {
+                config.processes = std::max<size_t>(1, std::stoul(argv[++i]));
+            }
+        } else if (arg == "--no-async") {
+            config.async_endpoints = false;
+        } else if (arg == "--pin") {
+            if (i + 1 < argc) {
+                std::string mode = argv[++i];
+                if (!Prefork::parse_pin_mode(mode, config.pin)) {
+                    throw std::invalid_argument("Unknown pin mode: " + mode);
+                }
+            }
+        } else if (arg == "--numa-pool") {
+            config.numa_pool = true;
+        } else if (arg == "--huge-pages") {
+            if (i + 1 < argc) {
+                std::string mode = argv[++i];
+                if (!HugePages::parse_mode(mode, config.huge_pages)) {
+                    throw std::invalid_argument("Unknown huge page mode: " + mode);
+                }
+            }
+        } else if (arg == "--drain-timeout-s") {
+            if (i + 1 < argc) {
+                config.drain_timeout = std::chrono::seconds(std::stoul(argv[++i]));
+            }
+        } else if (arg == "--gzip-min-bytes") {
+            if (i + 1 < argc) {
+                config.gzip_min_bytes = std::stoul(argv[++i]);
+            }
+        } else if (arg == "--gzip-level") {
+            if (i + 1 < argc) {
+                config.gzip_level = std::min(9, std::max(0, std::stoi(argv[++i])));
+            }
+        } else if (arg == "--trace-file") {
+            if (i + 1 < argc) {
+                config.trace_file = argv[++i];
+            }
+        } else if (arg == "--trace-sample-rate") {
+            if (i + 1 < argc) {
+                config.trace_sample_rate = std::stod(argv[++i]);
+            }
+        } else if (arg == "--span-trace") {
+            if (i + 1 < argc) {
+                config.span_trace_file = argv[++i];
+            }
+        } else if (arg == "--ipc-socket") {
+            if (i + 1 < argc) {
+                config.ipc_socket = argv[++i];
+            }
+        } else if (arg == "--dict-dir") {
+            if (i + 1 < argc) {
+                config.dictionary_dir = argv[++i];
+            }
+        } else {
+            throw std::invalid_argument("Unknown option: " + arg);
+        }
+    }
+
+    // Each upload chunk is one job block sent as a single request body
+    if (config.job_block_size > config.max_request_bytes) {
+        throw std::invalid_argument("--job-block-mb (" + std::to_string(config.job_block_size >> 20) +
+                                    ") exceeds --max-request-mb (" +
+                                    std::to_string(config.max_request_bytes >> 20) +
+                                    "), so no upload chunk could be accepted");
+    }
+
+    // Job, upload and benchmark state is held by the worker that created it,
+    // and follow-up requests may land on any other
+    if (config.processes > 1 && config.async_endpoints) {
+        throw std::invalid_argument("--processes above 1 requires --no-async: jobs, uploads and benchmark "
+                                    "runs are kept by one worker and other workers would answer 404");
+    }
+
+    return config;
+}
+
+void ServerConfig::print_usage(const std::string& program_name) {
+    std::cout << "Compressor Web Server\n\n";
+    std::cout << "Usage: " << program_name << " [options]\n\n";
+    std::cout << "Options:\n";
+    std::cout << "  -p, --port <port>        Listen port (default 8080)\n";
+    std::cout << "  --cache-mb <mb>          Result cache size in MB, 0 disables (default 64)\n";
+    std::cout << "  --max-request-mb <mb>    Largest accepted request body (default 20)\n";
+    std::cout << "  --max-inflight-mb <mb>   Memory budget for admitted requests (default 512)\n";
+    std::cout << "  --max-concurrent <num>   Concurrent compress/decompress requests (default: usable CPUs)\n";
+    std::cout << "  --max-queue <num>        Requests allowed to wait for admission (default 64)\n";
+    std::cout << "  --queue-timeout-ms <ms>  Longest admission wait before 503 (default 2000)\n";
+    std::cout << "  --small-request-kb <kb>  Bodies up to this size use the small-request lane (default 64)\n";
+    std::cout << "  --reserved-small <num>   Admission slots and workers kept for small requests (default 1)\n";
+    std::cout << "  --verify <mode>          Round-trip verification: always, sampled, async (default always)\n";
+    std::cout << "  --verify-sample-rate <r> Fraction verified in sampled/async modes (default 0.05)\n";
+    std::cout << "  --workers <num>          Background job worker threads (default: usable CPUs)\n";
+    std::cout << "  --spool-dir <path>       Job spool directory (default /tmp/compressor-jobs)\n";
+    std::cout << "  --job-ttl-s <seconds>    How long finished job results are kept (default 3600)\n";
+    std::cout << "  --job-block-mb <mb>      Block size used by background jobs and upload chunks;\n";
+    std::cout << "                           at most --max-request-mb (default 4)\n";
+    std::cout << "  --max-job-mb <mb>        Largest accepted job upload (default 16384)\n";
+    std::cout << "  --benchmark-threads <n>  Low-priority threads for /benchmark runs (default 2)\n";
+    std::cout << "  --processes <n>          Pre-forked worker processes sharing the port (default 1);\n";
+    std::cout << "                           above 1 requires --no-async\n";
+    std::cout << "  --no-async               Disable /jobs, /uploads and /benchmark runs\n";
+    std::cout << "  --pin <mode>             Pin workers: none, core, numa (default none)\n";
+    std::cout << "  --numa-pool              Pin pool threads per NUMA node and keep their work node-local\n";
+    std::cout << "  --huge-pages <mode>      Large buffers: off, thp, hugetlb (default thp)\n";
+    std::cout << "  --drain-timeout-s <s>    Time allowed for in-flight requests on SIGTERM (default 30)\n";
+    std::cout << "  --gzip-min-bytes <n>     Smallest response gzip-encoded for clients that accept it (default 1024)\n";
+    std::cout << "  --gzip-level <0-9>       zlib level for gzip responses, 0 disables (default 1)\n";
+    std::cout << "  --trace-file <path>      Record codec requests for replay with loadgen\n";
+    std::cout << "  --trace-sample-rate <r>  Fraction of traced requests whose body is saved (default 0)\n";
+    std::cout << "  --span-trace <path>      Record timing spans; written as Chrome trace JSON on shutdown\n";
+    std::cout << "  --ipc-socket <path>      Also serve the shared-memory IPC protocol on this Unix socket\n";
+    std::cout << "  --dict-dir <dir>         Preload trained dictionaries (*.dict) for the dictionary parameter\n";
+    std::cout << "  -h, --help               Show help message\n";
+}
+
+} // namespace server
+} // namespace compressor
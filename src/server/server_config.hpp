@@ -0,0 +1,53 @@
+#ifndef COMPRESSOR_SERVER_CONFIG_HPP
+#define COMPRESSOR_SERVER_CONFIG_HPP
+
+#include "core/huge_pages.hpp"
+#include "server/admission.hpp"
+#include "server/prefork.hpp"
+#include "server/verifier.hpp"
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+namespace compressor {
+namespace server {
+
+// Runtime settings for the web server, populated from the command line
+struct ServerConfig {
+    int port;
+    size_t cache_max_bytes;   // Result cache budget; 0 disables caching
+    size_t max_request_bytes; // Larger bodies are refused with 413
+    AdmissionLimits admission;
+    VerificationPolicy verification;
+    int retry_after_seconds;  // Advertised to clients rejected with 503
+    size_t worker_threads;    // Shared pool for background jobs
+    std::string spool_dir;    // Job inputs and results live here
+    std::chrono::seconds job_ttl;
+    size_t job_block_size;    // Jobs are processed in blocks of this size
+    size_t max_job_bytes;     // Largest accepted job upload
+    size_t benchmark_threads; // Low-priority pool for /benchmark runs
+    size_t processes;         // Pre-forked workers; 1 serves from this process
+    bool async_endpoints;     // Jobs, uploads and /benchmark runs; require processes == 1
+    PinMode pin;
+    bool numa_pool;           // Pin pool workers per NUMA node with node-local queues
+    HugePages::Mode huge_pages; // Backing for buffers of HugePages::THRESHOLD or more
+    std::chrono::seconds drain_timeout; // In-flight requests get this long on SIGTERM
+    size_t gzip_min_bytes;    // Smaller response bodies are sent uncompressed
+    int gzip_level;           // zlib level for gzip responses; 0 disables
+    std::string trace_file;   // Codec requests are recorded here when set
+    double trace_sample_rate; // Fraction of traced requests whose body is kept
+    std::string span_trace_file; // Timing spans are written here on shutdown when set
+    std::string ipc_socket;   // Unix socket of the shared-memory IPC service
+    std::string dictionary_dir; // "*.dict" files here are loaded at startup
+    bool help;
+
+    ServerConfig();
+
+    static ServerConfig from_args(int argc, char* argv[]);
+    static void print_usage(const std::string& program_name);
+};
+
+} // namespace server
+} // namespace compressor
+
+#endif // COMPRESSOR_SERVER_CONFIG_HPP
@@ -0,0 +1,136 @@
+#include "server/trace_recorder.hpp"
+#include "server/http.hpp"
+#include "utils/file_utils.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fcntl.h>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <unistd.h>
+
+namespace compressor {
+namespace server {
+
+TraceRecorder::TraceRecorder(const std::string& path, double payload_sample_rate)
+    : payload_sample_rate_(payload_sample_rate), fd_(-1), sequence_(0) {
+    if (path.empty()) {
+        return;
+    }
+
+    fd_ = open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        std::cerr << "Cannot open trace file " << path << "; tracing disabled" << std::endl;
+        return;
+    }
+
+    if (payload_sample_rate_ > 0.0) {
+        payload_dir_ = path + ".payloads";
+        if (!utils::FileUtils::file_exists(payload_dir_) && !utils::FileUtils::create_directory(payload_dir_)) {
+            std::cerr << "Cannot create " << payload_dir_ << "; payloads will not be sampled" << std::endl;
+            payload_dir_.clear();
+        }
+    }
+}
+
+TraceRecorder::~TraceRecorder() {
+    if (fd_ >= 0) {
+        close(fd_);
+    }
+}
+
+bool TraceRecorder::should_sample() const {
+    if (payload_dir_.empty() || payload_sample_rate_ <= 0.0) return false;
+    if (payload_sample_rate_ >= 1.0) return true;
+
+    thread_local std::minstd_rand rng(std::random_device{}());
+    return std::uniform_real_distribution<double>(0.0, 1.0)(rng) < payload_sample_rate_;
+}
+
+const char* TraceRecorder::content_class(const uint8_t* data, size_t size) {
+    if (size == 0) {
+        return "empty";
+    }
+
+    size_t sample = std::min<size_t>(size, 64 * 1024);
+    size_t counts[256] = {0};
+    size_t printable = 0;
+    for (size_t i = 0; i < sample; ++i) {
+        uint8_t byte = data[i];
+        counts[byte]++;
+        if ((byte >= 0x20 && byte < 0x7F) || byte == '\n' || byte == '\r' || byte == '\t') {
+            printable++;
+        }
+    }
+
+    if (printable >= sample * 95 / 100) {
+        return "text";
+    }
+
+    double entropy = 0.0;
+    for (size_t count : counts) {
+        if (count == 0) continue;
+        double p = static_cast<double>(count) / sample;
+        entropy -= p * std::log2(p);
+    }
+    // Short samples cannot reach 8 bits, so scale the bar with the sample
+    double ceiling = std::min(8.0, std::log2(static_cast<double>(sample)));
+    return entropy >= ceiling * 0.95 ? "random" : "binary";
+}
+
+void TraceRecorder::record(const TraceRecord& record, std::chrono::system_clock::time_point arrival,
+                           const uint8_t* body, size_t body_size) {
+    if (fd_ < 0) {
+        return;
+    }
+
+    uint64_t sequence;
+    double gap_ms;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sequence = sequence_++;
+        // Requests finish out of order; overlapping arrivals get a zero gap
+        gap_ms = sequence == 0 || arrival <= last_arrival_
+            ? 0.0 : std::chrono::duration<double, std::milli>(arrival - last_arrival_).count();
+        if (arrival > last_arrival_) {
+            last_arrival_ = arrival;
+        }
+    }
+
+    std::string payload;
+    if (body_size > 0 && should_sample()) {
+        std::string name = std::to_string(getpid()) + "-" + std::to_string(sequence) + ".bin";
+        if (utils::FileUtils::write_file(payload_dir_ + "/" + name, ByteVector(body, body + body_size))) {
+            // Relative to the trace file's directory
+            size_t slash = payload_dir_.find_last_of('/');
+            payload = (slash == std::string::npos ? payload_dir_ : payload_dir_.substr(slash + 1)) + "/" + name;
+        }
+    }
+
+    auto ts_us = std::chrono::duration_cast<std::chrono::microseconds>(arrival.time_since_epoch()).count();
+
+    std::ostringstream line;
+    line << "{\"ts_us\":" << ts_us
+         << ",\"gap_ms\":" << gap_ms
+         << ",\"method\":\"" << Http::json_escape(record.method) << "\""
+         << ",\"endpoint\":\"" << Http::json_escape(record.endpoint) << "\""
+         << ",\"query\":\"" << Http::json_escape(record.query) << "\""
+         << ",\"algorithm\":\"" << Http::json_escape(record.algorithm) << "\""
+         << ",\"content_type\":\"" << Http::json_escape(record.content_type) << "\""
+         << ",\"size\":" << record.size
+         << ",\"content_class\":\"" << content_class(body, body_size) << "\""
+         << ",\"status\":" << record.status
+         << ",\"latency_ms\":" << record.latency_ms;
+    if (!payload.empty()) {
+        line << ",\"payload\":\"" << Http::json_escape(payload) << "\"";
+    }
+    line << "}\n";
+
+    std::string text = line.str();
+    ssize_t written = write(fd_, text.data(), text.size());
+    (void)written;
+}
+
+} // namespace server
+} // namespace compressor
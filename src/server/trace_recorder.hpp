@@ -0,0 +1,69 @@
+#ifndef COMPRESSOR_SERVER_TRACE_RECORDER_HPP
+#define COMPRESSOR_SERVER_TRACE_RECORDER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace compressor {
+namespace server {
+
+// Metadata of one served codec request
+struct TraceRecord {
+    std::string method;
+    std::string endpoint;       // Route without the query string
+    std::string query;          // Raw query string, replayed as-is
+    std::string algorithm;
+    std::string content_type;   // Request Content-Type header
+    size_t size;                // Request body bytes
+    int status;
+    double latency_ms;          // Time from headers read to response built
+
+    TraceRecord() : size(0), status(0), latency_ms(0.0) {}
+};
+
+// Appends request metadata to a JSON-lines trace file for later replay
+// with the loadgen tool.
+//
+// Each line carries the wall-clock arrival time, the gap since the previous
+// captured request, the body size and a coarse content class. A
+// `payload_sample_rate` fraction of requests also has its raw body saved
+// next to the trace (`<trace>.payloads/<pid>-<seq>.bin`) so replays can use
+// real data; the rest are replayed with synthetic bodies of the same size
+// and class. Lines are written with a single O_APPEND write, so pre-forked
+// workers can share one trace file.
+class TraceRecorder {
+public:
+    TraceRecorder(const std::string& path, double payload_sample_rate);
+    ~TraceRecorder();
+
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    bool enabled() const { return fd_ >= 0; }
+
+    // `arrival` is when the request headers were read
+    void record(const TraceRecord& record, std::chrono::system_clock::time_point arrival,
+                const uint8_t* body, size_t body_size);
+
+    // "empty", "text", "binary" or "random" (incompressible), judged from
+    // printable ratio and byte entropy of the first 64 KB
+    static const char* content_class(const uint8_t* data, size_t size);
+
+private:
+    bool should_sample() const;
+
+    std::string payload_dir_;
+    double payload_sample_rate_;
+    int fd_;
+
+    std::mutex mutex_;
+    uint64_t sequence_;
+    std::chrono::system_clock::time_point last_arrival_;
+};
+
+} // namespace server
+} // namespace compressor
+
+#endif // COMPRESSOR_SERVER_TRACE_RECORDER_HPP
@@ -0,0 +1,158 @@
+#include "server/verifier.hpp"
+#include "server/metrics.hpp"
+#include "utils/crc.hpp"
+#include <iostream>
+#include <random>
+#include <sstream>
+
+namespace compressor {
+namespace server {
+
+bool VerificationPolicy::parse_mode(const std::string& name, VerificationMode& mode) {
+    if (name == "always") {
+        mode = VerificationMode::ALWAYS;
+    } else if (name == "sampled") {
+        mode = VerificationMode::SAMPLED;
+    } else if (name == "async") {
+        mode = VerificationMode::ASYNC;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* VerificationPolicy::mode_name(VerificationMode mode) {
+    switch (mode) {
+        case VerificationMode::ALWAYS: return "always";
+        case VerificationMode::SAMPLED: return "sampled";
+        case VerificationMode::ASYNC: return "async";
+    }
+    return "unknown";
+}
+
+Verifier::Verifier(const VerificationPolicy& policy, utils::ThreadPool& pool, CodecPool& codecs)
+    : policy_(policy), pool_(pool), codecs_(codecs), passed_(0), failed_(0), skipped_(0), pending_(0) {}
+
+const char* Verifier::outcome_name(VerificationOutcome outcome) {
+    switch (outcome) {
+        case VerificationOutcome::PASSED: return "passed";
+        case VerificationOutcome::FAILED: return "failed";
+        case VerificationOutcome::SKIPPED: return "skipped";
+        case VerificationOutcome::PENDING: return "pending";
+    }
+    return "unknown";
+}
+
+bool Verifier::should_sample() const {
+    if (policy_.sample_rate >= 1.0) return true;
+    if (policy_.sample_rate <= 0.0) return false;
+
+    thread_local std::minstd_rand rng(std::random_device{}());
+    return std::uniform_real_distribution<double>(0.0, 1.0)(rng) < policy_.sample_rate;
+}
+
+bool Verifier::check(const std::string& algorithm, const ByteVector& compressed,
+                     size_t original_size, uint32_t checksum) {
+    try {
+        auto codec = codecs_.acquire(algorithm);
+        if (!codec) {
+            return false;
+        }
+
+        auto result = codec->decompress(compressed);
+        if (!result.is_success() || result.data().size() != original_size) {
+            return false;
+        }
+
+        // Codecs record the CRC of their output; fall back to computing it
+        uint32_t actual = result.stats().checksum;
+        if (actual == 0) {
+            actual = utils::CRC32::calculate(result.data());
+        }
+        return actual == checksum;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+VerificationOutcome Verifier::verify(const std::string& algorithm,
+                                     std::shared_ptr<const ByteVector> compressed,
+                                     size_t original_size, uint32_t checksum,
+                                     Callback on_passed) {
+    bool sampled = policy_.mode == VerificationMode::ALWAYS || should_sample();
+    if (!sampled) {
+        record(VerificationOutcome::SKIPPED, algorithm, original_size);
+        return VerificationOutcome::SKIPPED;
+    }
+
+    if (policy_.mode == VerificationMode::ASYNC) {
+        // Shed verification rather than let the backlog grow without bound
+        if (pending_.fetch_add(1, std::memory_order_relaxed) >= policy_.max_pending) {
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+            record(VerificationOutcome::SKIPPED, algorithm, original_size);
+            return VerificationOutcome::SKIPPED;
+        }
+
+        try {
+            pool_.post([this, algorithm, compressed, original_size, checksum, on_passed]() {
+                bool ok = check(algorithm, *compressed, original_size, checksum);
+                pending_.fetch_sub(1, std::memory_order_relaxed);
+                record(ok ? VerificationOutcome::PASSED : VerificationOutcome::FAILED, algorithm, original_size);
+                if (ok && on_passed) {
+                    on_passed();
+                }
+            });
+        } catch (const std::exception&) {
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+            record(VerificationOutcome::SKIPPED, algorithm, original_size);
+            return VerificationOutcome::SKIPPED;
+        }
+        return VerificationOutcome::PENDING;
+    }
+
+    bool ok = check(algorithm, *compressed, original_size, checksum);
+    VerificationOutcome outcome = ok ? VerificationOutcome::PASSED : VerificationOutcome::FAILED;
+    record(outcome, algorithm, original_size);
+    if (ok && on_passed) {
+        on_passed();
+    }
+    return outcome;
+}
+
+void Verifier::record(VerificationOutcome outcome, const std::string& algorithm, size_t original_size) {
+    switch (outcome) {
+        case VerificationOutcome::PASSED:
+            passed_.fetch_add(1, std::memory_order_relaxed);
+            break;
+        case VerificationOutcome::FAILED:
+            failed_.fetch_add(1, std::memory_order_relaxed);
+            Metrics::instance().record_error(ErrorType::VERIFICATION_FAILED);
+            std::cerr << "ALERT: round-trip verification failed for " << algorithm
+                      << " (" << original_size << " bytes)" << std::endl;
+            break;
+        case VerificationOutcome::SKIPPED:
+            skipped_.fetch_add(1, std::memory_order_relaxed);
+            break;
+        case VerificationOutcome::PENDING:
+            break;
+    }
+}
+
+std::string Verifier::to_prometheus() const {
+    std::ostringstream oss;
+
+    oss << "# HELP compressor_verifications_total Round-trip verification outcomes.\n";
+    oss << "# TYPE compressor_verifications_total counter\n";
+    oss << "compressor_verifications_total{result=\"passed\"} " << passed_.load(std::memory_order_relaxed) << "\n";
+    oss << "compressor_verifications_total{result=\"failed\"} " << failed_.load(std::memory_order_relaxed) << "\n";
+    oss << "compressor_verifications_total{result=\"skipped\"} " << skipped_.load(std::memory_order_relaxed) << "\n";
+
+    oss << "# HELP compressor_verification_pending Async verifications waiting on the worker pool.\n";
+    oss << "# TYPE compressor_verification_pending gauge\n";
+    oss << "compressor_verification_pending " << pending_.load(std::memory_order_relaxed) << "\n";
+
+    return oss.str();
+}
+
+} // namespace server
+} // namespace compressor
@@ -0,0 +1,85 @@
+#ifndef COMPRESSOR_SERVER_VERIFIER_HPP
+#define COMPRESSOR_SERVER_VERIFIER_HPP
+
+#include "core/common.hpp"
+#include "server/codec_pool.hpp"
+#include "utils/thread_pool.hpp"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace compressor {
+namespace server {
+
+enum class VerificationMode {
+    ALWAYS,    // Verify every result before responding
+    SAMPLED,   // Verify a fraction of results before responding
+    ASYNC      // Verify a fraction of results on the worker pool after responding
+};
+
+enum class VerificationOutcome {
+    PASSED,
+    FAILED,
+    SKIPPED,   // Not sampled, or the async backlog was full
+    PENDING    // Handed to the worker pool
+};
+
+struct VerificationPolicy {
+    VerificationMode mode;
+    double sample_rate;    // Fraction verified in SAMPLED and ASYNC modes
+    size_t max_pending;    // Async verifications allowed to queue up
+
+    VerificationPolicy() : mode(VerificationMode::ALWAYS), sample_rate(0.05), max_pending(256) {}
+
+    static bool parse_mode(const std::string& name, VerificationMode& mode);
+    static const char* mode_name(VerificationMode mode);
+};
+
+// Round-trip verification of compression results.
+//
+// A result is checked by decompressing it and comparing the size and CRC32
+// of the output with the checksum the codec recorded while compressing, so
+// the original input does not have to be kept around for async checks.
+// Mismatches are logged as alerts and counted in /metrics.
+class Verifier {
+public:
+    using Callback = std::function<void()>;
+
+    Verifier(const VerificationPolicy& policy, utils::ThreadPool& pool, CodecPool& codecs);
+
+    // Apply the policy to a fresh result. `on_passed` runs once the result
+    // is known to be good: inline for PASSED, on a worker for PENDING.
+    VerificationOutcome verify(const std::string& algorithm,
+                               std::shared_ptr<const ByteVector> compressed,
+                               size_t original_size, uint32_t checksum,
+                               Callback on_passed = Callback());
+
+    // Decompress and compare against the recorded size and checksum
+    bool check(const std::string& algorithm, const ByteVector& compressed,
+               size_t original_size, uint32_t checksum);
+
+    const VerificationPolicy& policy() const { return policy_; }
+
+    std::string to_prometheus() const;
+
+    static const char* outcome_name(VerificationOutcome outcome);
+
+private:
+    bool should_sample() const;
+    void record(VerificationOutcome outcome, const std::string& algorithm, size_t original_size);
+
+    VerificationPolicy policy_;
+    utils::ThreadPool& pool_;
+    CodecPool& codecs_;
+
+    std::atomic<uint64_t> passed_;
+    std::atomic<uint64_t> failed_;
+    std::atomic<uint64_t> skipped_;
+    std::atomic<size_t> pending_;
+};
+
+} // namespace server
+} // namespace compressor
+
+#endif // COMPRESSOR_SERVER_VERIFIER_HPP
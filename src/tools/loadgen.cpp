@@ -0,0 +1,705 @@
+// Load generator for the web server.
+//
+// Replays a trace captured with `web_server --trace-file`, or drives a
+// synthetic open-loop arrival process, against a running server and reports
+// throughput and latency percentiles. Requests are issued at their scheduled
+// time regardless of how many are still outstanding; latency is measured
+// from that scheduled time, so queueing inside the generator (when every
+// connection slot is busy) counts against the server instead of hiding it.
+
+#include "utils/base64.hpp"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <netdb.h>
+#include <random>
+#include <sstream>
+#include <string>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using compressor::utils::Base64;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string host = "127.0.0.1";
+    std::string port = "8080";
+    size_t concurrency = 16;
+    int timeout_s = 60;
+
+    // Trace replay
+    std::string trace_file;
+    double speed = 1.0;
+
+    // Synthetic open-loop load
+    double rate = 0.0;              // Requests per second
+    double duration_s = 10.0;
+    std::string arrival = "poisson";
+    std::string endpoint = "/compress";
+    std::string algorithm = "lz77";
+    std::string content = "text";
+    std::vector<std::pair<size_t, double>> sizes{{4096, 1.0}};  // size, weight
+
+    size_t small_bytes = 64 * 1024;  // Report boundary between small and bulk
+    bool help = false;
+};
+
+// One request to issue; bodies are shared between identical requests
+struct RequestSpec {
+    double offset_ms = 0.0;
+    std::string method = "POST";
+    std::string endpoint;
+    std::string query;
+    std::string algorithm;
+    std::string content_type;
+    std::string content_class = "text";
+    size_t size = 0;
+    std::string payload;  // Sampled body file, relative to the trace
+    std::shared_ptr<const std::string> body;
+};
+
+struct Sample {
+    double latency_ms;   // From scheduled arrival to complete response
+    double service_ms;   // From connect to complete response
+    int status;          // 0 when the connection failed
+    size_t bytes;
+    std::string group;
+};
+
+void print_usage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n\n"
+              << "Replay a captured trace:\n"
+              << "  --trace <file>          Trace written by web_server --trace-file\n"
+              << "  --speed <x>             Replay time scale, 2 = twice as fast (default 1)\n\n"
+              << "Or generate open-loop load:\n"
+              << "  --rate <req/s>          Mean arrival rate\n"
+              << "  --duration-s <s>        Length of the run (default 10)\n"
+              << "  --arrival <kind>        poisson or uniform inter-arrival times (default poisson)\n"
+              << "  --endpoint <path>       /compress, /decompress or /batch (default /compress)\n"
+              << "  --algorithm <name>      Codec to request (default lz77)\n"
+              << "  --content <class>       text, binary or random payloads (default text)\n"
+              << "  --sizes <list>          Payload sizes with weights, e.g. 2048:9,20971520:1 (default 4096)\n\n"
+              << "Common:\n"
+              << "  --host <addr>           Server address (default 127.0.0.1)\n"
+              << "  -p, --port <port>       Server port (default 8080)\n"
+              << "  -c, --concurrency <n>   Requests in flight at once (default 16)\n"
+              << "  --timeout-s <s>         Per-request socket timeout (default 60)\n"
+              << "  --small-bytes <n>       Report requests up to this size as small (default 65536)\n"
+              << "  -h, --help              Show help message\n";
+}
+
+std::vector<std::pair<size_t, double>> parse_sizes(const std::string& spec) {
+    std::vector<std::pair<size_t, double>> sizes;
+    std::stringstream ss(spec);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        size_t colon = item.find(':');
+        size_t size = std::stoull(item.substr(0, colon));
+        double weight = colon == std::string::npos ? 1.0 : std::stod(item.substr(colon + 1));
+        sizes.emplace_back(size, weight);
+    }
+    if (sizes.empty()) {
+        throw std::invalid_argument("Empty --sizes list");
+    }
+    return sizes;
+}
+
+Options parse_args(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("Missing value for " + arg);
+            }
+            return argv[++i];
+        };
+
+        if (arg == "-h" || arg == "--help") {
+            options.help = true;
+        } else if (arg == "--host") {
+            options.host = value();
+        } else if (arg == "-p" || arg == "--port") {
+            options.port = value();
+        } else if (arg == "-c" || arg == "--concurrency") {
+            options.concurrency = std::max<size_t>(1, std::stoul(value()));
+        } else if (arg == "--timeout-s") {
+            options.timeout_s = std::stoi(value());
+        } else if (arg == "--trace") {
+            options.trace_file = value();
+        } else if (arg == "--speed") {
+            options.speed = std::stod(value());
+        } else if (arg == "--rate") {
+            options.rate = std::stod(value());
+        } else if (arg == "--duration-s") {
+            options.duration_s = std::stod(value());
+        } else if (arg == "--arrival") {
+            options.arrival = value();
+        } else if (arg == "--endpoint") {
+            options.endpoint = value();
+        } else if (arg == "--algorithm") {
+            options.algorithm = value();
+        } else if (arg == "--content") {
+            options.content = value();
+        } else if (arg == "--sizes") {
+            options.sizes = parse_sizes(value());
+        } else if (arg == "--small-bytes") {
+            options.small_bytes = std::stoull(value());
+        } else {
+            throw std::invalid_argument("Unknown option: " + arg);
+        }
+    }
+
+    if (!options.help && options.trace_file.empty() && options.rate <= 0.0) {
+        throw std::invalid_argument("Either --trace or --rate is required");
+    }
+    if (options.speed <= 0.0) {
+        throw std::invalid_argument("--speed must be positive");
+    }
+    if (options.arrival != "poisson" && options.arrival != "uniform") {
+        throw std::invalid_argument("Unknown arrival process: " + options.arrival);
+    }
+    return options;
+}
+
+// Values of a flat JSON object as written by TraceRecorder: strings and
+// numbers only, no nesting
+std::map<std::string, std::string> parse_flat_json(const std::string& line) {
+    std::map<std::string, std::string> fields;
+    size_t pos = 0;
+
+    auto read_string = [&](std::string& out) {
+        out.clear();
+        for (++pos; pos < line.size() && line[pos] != '"'; ++pos) {
+            if (line[pos] == '\\' && pos + 1 < line.size()) {
+                char escaped = line[++pos];
+                switch (escaped) {
+                    case 'n': out += '\n'; break;
+                    case 'r': out += '\r'; break;
+                    case 't': out += '\t'; break;
+                    case 'u': pos += 4; out += '?'; break;
+                    default: out += escaped; break;
+                }
+            } else {
+                out += line[pos];
+            }
+        }
+        ++pos;
+    };
+
+    while ((pos = line.find('"', pos)) != std::string::npos) {
+        std::string key;
+        read_string(key);
+        pos = line.find(':', pos);
+        if (pos == std::string::npos) break;
+        pos = line.find_first_not_of(" \t", pos + 1);
+        if (pos == std::string::npos) break;
+
+        std::string value;
+        if (line[pos] == '"') {
+            read_string(value);
+        } else {
+            size_t end = line.find_first_of(",}", pos);
+            value = line.substr(pos, end - pos);
+            pos = end;
+        }
+        fields[key] = value;
+    }
+    return fields;
+}
+
+std::vector<RequestSpec> load_trace(const std::string& path, double speed) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Cannot open trace " + path);
+    }
+
+    struct Timed {
+        long long ts_us;
+        RequestSpec spec;
+    };
+    std::vector<Timed> entries;
+
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty()) continue;
+        auto fields = parse_flat_json(line);
+
+        Timed entry;
+        entry.ts_us = std::stoll(fields["ts_us"]);
+        entry.spec.method = fields["method"];
+        entry.spec.endpoint = fields["endpoint"];
+        entry.spec.query = fields["query"];
+        entry.spec.algorithm = fields["algorithm"];
+        entry.spec.content_type = fields["content_type"];
+        entry.spec.content_class = fields["content_class"];
+        entry.spec.size = std::stoull(fields["size"]);
+        entry.spec.payload = fields["payload"];
+        entries.push_back(std::move(entry));
+    }
+
+    // Pre-forked workers append to one trace, so order by arrival time
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const Timed& a, const Timed& b) { return a.ts_us < b.ts_us; });
+
+    std::vector<RequestSpec> specs;
+    specs.reserve(entries.size());
+    for (auto& entry : entries) {
+        entry.spec.offset_ms = (entry.ts_us - entries.front().ts_us) / 1000.0 / speed;
+        specs.push_back(std::move(entry.spec));
+    }
+    return specs;
+}
+
+std::vector<RequestSpec> synthesize(const Options& options) {
+    std::mt19937_64 rng(42);
+    std::exponential_distribution<double> exponential(options.rate);
+
+    std::vector<double> weights;
+    for (const auto& size : options.sizes) weights.push_back(size.second);
+    std::discrete_distribution<size_t> pick(weights.begin(), weights.end());
+
+    std::vector<RequestSpec> specs;
+    double t = 0.0;
+    while (true) {
+        t += options.arrival == "poisson" ? exponential(rng) : 1.0 / options.rate;
+        if (t >= options.duration_s) break;
+
+        RequestSpec spec;
+        spec.offset_ms = t * 1000.0;
+        spec.endpoint = options.endpoint;
+        spec.algorithm = options.algorithm;
+        spec.content_class = options.content;
+        spec.size = options.sizes[pick(rng)].first;
+        if (spec.endpoint == "/batch") {
+            spec.query = "algorithm=" + options.algorithm;
+        }
+        specs.push_back(std::move(spec));
+    }
+    return specs;
+}
+
+// Deterministic data resembling the captured content class
+std::string make_data(const std::string& content_class, size_t size, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::string data;
+    data.reserve(size);
+
+    if (content_class == "random") {
+        while (data.size() < size) {
+            uint64_t word = rng();
+            data.append(reinterpret_cast<const char*>(&word), std::min<size_t>(8, size - data.size()));
+        }
+    } else if (content_class == "binary") {
+        // Slowly varying little-endian records with noisy low bytes
+        uint32_t value = 0;
+        while (data.size() < size) {
+            value += static_cast<uint32_t>(rng() % 16);
+            uint32_t record = value ^ static_cast<uint32_t>(rng() % 4);
+            data.append(reinterpret_cast<const char*>(&record), std::min<size_t>(4, size - data.size()));
+        }
+    } else {
+        static const char* words[] = {"the", "compression", "of", "data", "server", "request", "block",
+                                      "and", "stream", "latency", "with", "a", "for", "bytes", "window"};
+        std::uniform_int_distribution<size_t> word(0, sizeof(words) / sizeof(words[0]) - 1);
+        size_t line = 0;
+        while (data.size() < size) {
+            const char* w = words[word(rng)];
+            data += w;
+            line += std::strlen(w) + 1;
+            if (line > 72) {
+                data += '\n';
+                line = 0;
+            } else {
+                data += ' ';
+            }
+        }
+        data.resize(size);
+    }
+    return data;
+}
+
+std::string make_multipart(const std::string& boundary, const std::string& algorithm, const std::string& data) {
+    std::string body;
+    body.reserve(data.size() + 256);
+    body += "--" + boundary + "\r\nContent-Disposition: form-data; name=\"algorithm\"\r\n\r\n" + algorithm + "\r\n";
+    body += "--" + boundary + "\r\nContent-Disposition: form-data; name=\"file\"; filename=\"data.bin\"\r\n";
+    body += "Content-Type: application/octet-stream\r\n\r\n";
+    body += data;
+    body += "\r\n--" + boundary + "--\r\n";
+    return body;
+}
+
+std::string make_bundle(const std::string& data, size_t item_size) {
+    std::string body;
+    size_t count = (data.size() + item_size - 1) / item_size;
+    auto append_u32 = [&body](uint32_t value) {
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            body.push_back(static_cast<char>((value >> shift) & 0xFF));
+        }
+    };
+
+    append_u32(static_cast<uint32_t>(count));
+    for (size_t pos = 0; pos < data.size(); pos += item_size) {
+        size_t length = std::min(item_size, data.size() - pos);
+        append_u32(static_cast<uint32_t>(length));
+        body.append(data, pos, length);
+    }
+    return body;
+}
+
+class HttpClient {
+public:
+    HttpClient(const Options& options) : options_(options) {
+        addrinfo hints{};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        if (getaddrinfo(options.host.c_str(), options.port.c_str(), &hints, &address_) != 0) {
+            throw std::runtime_error("Cannot resolve " + options.host);
+        }
+    }
+
+    ~HttpClient() {
+        freeaddrinfo(address_);
+    }
+
+    // Returns the status code (0 if the exchange failed) and fills `body`
+    int request(const RequestSpec& spec, std::string* response_body = nullptr) const {
+        int fd = socket(address_->ai_family, address_->ai_socktype, address_->ai_protocol);
+        if (fd < 0) return 0;
+
+        timeval timeout{};
+        timeout.tv_sec = options_.timeout_s;
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+        if (connect(fd, address_->ai_addr, address_->ai_addrlen) != 0) {
+            close(fd);
+            return 0;
+        }
+
+        const std::string& body = *spec.body;
+        std::string target = spec.endpoint + (spec.query.empty() ? "" : "?" + spec.query);
+        std::string head = spec.method + " " + target + " HTTP/1.1\r\nHost: " + options_.host + "\r\n";
+        if (!spec.content_type.empty()) {
+            head += "Content-Type: " + spec.content_type + "\r\n";
+        }
+        head += "Content-Length: " + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n";
+
+        bool sent = send_all(fd, head.data(), head.size()) && send_all(fd, body.data(), body.size());
+        std::string response;
+        char buffer[65536];
+        ssize_t n;
+        while (sent && (n = read(fd, buffer, sizeof(buffer))) > 0) {
+            response.append(buffer, static_cast<size_t>(n));
+        }
+        close(fd);
+
+        if (response.compare(0, 5, "HTTP/") != 0 || response.size() < 12) {
+            return 0;
+        }
+        if (response_body) {
+            size_t header_end = response.find("\r\n\r\n");
+            *response_body = header_end == std::string::npos ? "" : response.substr(header_end + 4);
+        }
+        return std::atoi(response.c_str() + 9);
+    }
+
+private:
+    static bool send_all(int fd, const char* data, size_t length) {
+        while (length > 0) {
+            ssize_t n = send(fd, data, length, MSG_NOSIGNAL);
+            if (n <= 0) return false;
+            data += n;
+            length -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    const Options& options_;
+    addrinfo* address_ = nullptr;
+};
+
+// Builds request bodies before the run so generation never skews timing.
+// Sampled payloads are sent verbatim; everything else gets synthetic data
+// of the recorded size and class. Returns false for requests that cannot
+// be reproduced without their payload.
+class BodyFactory {
+public:
+    BodyFactory(const HttpClient& client, const std::string& trace_dir) : client_(client), trace_dir_(trace_dir) {}
+
+    bool prepare(RequestSpec& spec) {
+        if (!spec.payload.empty()) {
+            std::ifstream in(trace_dir_ + spec.payload, std::ios::binary);
+            if (in) {
+                spec.body = std::make_shared<const std::string>((std::istreambuf_iterator<char>(in)),
+                                                                std::istreambuf_iterator<char>());
+                return true;
+            }
+        }
+
+        std::string key = spec.endpoint + "|" + spec.query + "|" + spec.algorithm + "|" +
+                          spec.content_class + "|" + std::to_string(spec.size);
+        auto it = cache_.find(key);
+        if (it != cache_.end()) {
+            spec.body = it->second.first;
+            spec.content_type = it->second.second;
+            return spec.body != nullptr;
+        }
+
+        std::shared_ptr<const std::string> body;
+        std::string content_type;
+        const std::string boundary = "loadgen" + std::to_string(cache_.size());
+        bool decompress = spec.query.find("operation=decompress") != std::string::npos;
+
+        if (spec.method == "POST" && spec.endpoint == "/compress") {
+            // The size covers the multipart framing; aim for the same body size
+            size_t overhead = make_multipart(boundary, spec.algorithm, "").size();
+            std::string data = make_data(spec.content_class, spec.size > overhead ? spec.size - overhead : 1,
+                                         cache_.size());
+            body = std::make_shared<const std::string>(make_multipart(boundary, spec.algorithm, data));
+            content_type = "multipart/form-data; boundary=" + boundary;
+        } else if (spec.method == "POST" && spec.endpoint == "/decompress") {
+            std::string compressed;
+            if (compress_remotely(spec, compressed)) {
+                body = std::make_shared<const std::string>(make_multipart(boundary, spec.algorithm, compressed));
+                content_type = "multipart/form-data; boundary=" + boundary;
+            }
+        } else if (spec.method == "POST" && spec.endpoint == "/batch" && !decompress) {
+            std::string data = make_data(spec.content_class, spec.size, cache_.size());
+            body = std::make_shared<const std::string>(make_bundle(data, 4096));
+            content_type = "application/octet-stream";
+        }
+
+        cache_[key] = {body, content_type};
+        spec.body = body;
+        spec.content_type = content_type;
+        return body != nullptr;
+    }
+
+private:
+    // Obtain a valid compressed payload of roughly the recorded size
+    bool compress_remotely(const RequestSpec& spec, std::string& compressed) {
+        RequestSpec setup;
+        setup.endpoint = "/compress";
+        setup.algorithm = spec.algorithm;
+        setup.content_type = "multipart/form-data; boundary=loadgen-setup";
+        setup.body = std::make_shared<const std::string>(
+            make_multipart("loadgen-setup", spec.algorithm, make_data(spec.content_class, spec.size, 7)));
+
+        std::string response;
+        if (client_.request(setup, &response) != 200) {
+            return false;
+        }
+
+        const std::string field = "\"compressed_data\":";
+        size_t start = response.find(field);
+        if (start == std::string::npos) return false;
+        start = response.find('"', start + field.size());
+        if (start == std::string::npos) return false;
+        start++;
+        size_t end = response.find('"', start);
+        if (end == std::string::npos) return false;
+
+        compressor::ByteVector bytes;
+        if (!Base64::decode(response.data() + start, end - start, bytes)) return false;
+        compressed.assign(bytes.begin(), bytes.end());
+        return true;
+    }
+
+    const HttpClient& client_;
+    std::string trace_dir_;
+    std::map<std::string, std::pair<std::shared_ptr<const std::string>, std::string>> cache_;
+};
+
+double percentile(std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    size_t index = static_cast<size_t>(p / 100.0 * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+void print_latency_row(const std::string& label, std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    std::cout << "  " << std::left << std::setw(24) << label << std::right << std::setw(8) << values.size()
+              << std::fixed << std::setprecision(2)
+              << std::setw(10) << percentile(values, 50) << std::setw(10) << percentile(values, 90)
+              << std::setw(10) << percentile(values, 99) << std::setw(10) << percentile(values, 99.9)
+              << std::setw(10) << (values.empty() ? 0.0 : values.back()) << "\n";
+}
+
+void report(const std::vector<Sample>& samples, size_t skipped, double elapsed_s) {
+    size_t ok = 0;
+    size_t bytes = 0;
+    std::map<int, size_t> statuses;
+    std::vector<double> latencies, services;
+    std::map<std::string, std::vector<double>> groups;
+
+    for (const auto& sample : samples) {
+        statuses[sample.status]++;
+        if (sample.status >= 200 && sample.status < 300) {
+            ok++;
+            bytes += sample.bytes;
+        }
+        latencies.push_back(sample.latency_ms);
+        services.push_back(sample.service_ms);
+        groups[sample.group].push_back(sample.latency_ms);
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "\nRequests: " << samples.size() << " sent, " << ok << " succeeded, "
+              << samples.size() - ok << " failed, " << skipped << " skipped\n";
+    std::cout << "Elapsed: " << elapsed_s << " s\n";
+    std::cout << "Throughput: " << (elapsed_s > 0 ? ok / elapsed_s : 0.0) << " req/s, "
+              << (elapsed_s > 0 ? bytes / elapsed_s / (1024.0 * 1024.0) : 0.0) << " MB/s uploaded\n";
+
+    std::cout << "Status:";
+    for (const auto& status : statuses) {
+        std::cout << " " << (status.first == 0 ? std::string("error") : std::to_string(status.first))
+                  << "=" << status.second;
+    }
+    std::cout << "\n\nLatency (ms)                  count       p50       p90       p99     p99.9       max\n";
+    print_latency_row("all (from arrival)", latencies);
+    print_latency_row("all (service time)", services);
+    for (const auto& group : groups) {
+        print_latency_row(group.first, group.second);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        options = parse_args(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n\n";
+        print_usage(argv[0]);
+        return 1;
+    }
+    if (options.help) {
+        print_usage(argv[0]);
+        return 0;
+    }
+
+    std::vector<RequestSpec> specs;
+    std::string trace_dir;
+    try {
+        if (!options.trace_file.empty()) {
+            specs = load_trace(options.trace_file, options.speed);
+            size_t slash = options.trace_file.find_last_of('/');
+            trace_dir = slash == std::string::npos ? "" : options.trace_file.substr(0, slash + 1);
+        } else {
+            specs = synthesize(options);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::unique_ptr<HttpClient> client;
+    try {
+        client = std::make_unique<HttpClient>(options);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    BodyFactory bodies(*client, trace_dir);
+
+    std::vector<const RequestSpec*> runnable;
+    size_t skipped = 0;
+    for (auto& spec : specs) {
+        if (bodies.prepare(spec)) {
+            runnable.push_back(&spec);
+        } else {
+            skipped++;
+        }
+    }
+    std::cout << "Prepared " << runnable.size() << " requests (" << skipped << " skipped), concurrency "
+              << options.concurrency << std::endl;
+
+    struct Scheduled {
+        const RequestSpec* spec;
+        Clock::time_point due;
+    };
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<Scheduled> queue;
+    bool done = false;
+
+    std::vector<Sample> samples;
+    samples.reserve(runnable.size());
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < options.concurrency; ++i) {
+        workers.emplace_back([&]() {
+            std::vector<Sample> local;
+            while (true) {
+                Scheduled item;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    ready.wait(lock, [&] { return done || !queue.empty(); });
+                    if (queue.empty()) break;
+                    item = queue.front();
+                    queue.pop_front();
+                }
+
+                auto begin = Clock::now();
+                int status = client->request(*item.spec);
+                auto end = Clock::now();
+
+                Sample sample;
+                sample.latency_ms = std::chrono::duration<double, std::milli>(end - item.due).count();
+                sample.service_ms = std::chrono::duration<double, std::milli>(end - begin).count();
+                sample.status = status;
+                sample.bytes = item.spec->body->size();
+                sample.group = item.spec->endpoint +
+                               (item.spec->size <= options.small_bytes ? " small" : " bulk");
+                local.push_back(std::move(sample));
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            samples.insert(samples.end(), local.begin(), local.end());
+        });
+    }
+
+    // Open loop: release each request at its arrival time
+    auto start = Clock::now();
+    for (const RequestSpec* spec : runnable) {
+        auto due = start + std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double, std::milli>(spec->offset_ms));
+        std::this_thread::sleep_until(due);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.push_back(Scheduled{spec, due});
+        }
+        ready.notify_one();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+    }
+    ready.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double elapsed_s = std::chrono::duration<double>(Clock::now() - start).count();
+
+    report(samples, skipped, elapsed_s);
+    return 0;
+}
@@ -0,0 +1,312 @@
+#include "utils/base64.hpp"
+#include "utils/cpu_features.hpp"
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define COMPRESSOR_BASE64_SSSE3 1
+#include <immintrin.h>
+#endif
+
+namespace compressor {
+namespace utils {
+
+namespace {
+
+const char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+constexpr int8_t INVALID = -1;
+constexpr int8_t SPACE = -2;
+constexpr int8_t PAD = -3;
+
+struct DecodeTable {
+    int8_t values[256];
+
+    DecodeTable() {
+        std::memset(values, INVALID, sizeof(values));
+        for (int i = 0; i < 64; ++i) {
+            values[static_cast<uint8_t>(ALPHABET[i])] = static_cast<int8_t>(i);
+        }
+        values[static_cast<uint8_t>(' ')] = SPACE;
+        values[static_cast<uint8_t>('\t')] = SPACE;
+        values[static_cast<uint8_t>('\r')] = SPACE;
+        values[static_cast<uint8_t>('\n')] = SPACE;
+        values['='] = PAD;
+    }
+};
+
+const DecodeTable decode_table;
+
+#ifdef COMPRESSOR_BASE64_SSSE3
+
+// Encodes 12 input bytes per 16 output characters; reads 16 bytes at a
+// time, so it stops while fewer than 16 remain. Returns bytes consumed.
+__attribute__((target("ssse3")))
+size_t encode_ssse3(const uint8_t* data, size_t size, char* out) {
+    size_t i = 0;
+    for (; i + 16 <= size; i += 12, out += 16) {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+
+        // Spread each 3-byte group over a 32-bit lane and split it into
+        // four 6-bit indices, one per byte
+        in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+        __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+        __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+        __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+        __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+        __m128i indices = _mm_or_si128(t1, t3);
+
+        // Map indices to ASCII by adding a per-range offset:
+        // 0..25 -> 13 ('A'), 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12
+        const __m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                              '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                              '/' - 63, 'A', 0, 0);
+        __m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+        __m128i upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+        range = _mm_or_si128(range, _mm_and_si128(upper, _mm_set1_epi8(13)));
+        __m128i ascii = _mm_add_epi8(indices, _mm_shuffle_epi8(offsets, range));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), ascii);
+    }
+    return i;
+}
+
+// Decodes groups of 16 characters into 12 bytes until a group contains
+// anything outside the alphabet (padding, whitespace, garbage), which is
+// left to the scalar decoder. Returns characters consumed.
+__attribute__((target("ssse3")))
+size_t decode_ssse3(const char* data, size_t size, uint8_t* out) {
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16, out += 12) {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+
+        auto between = [&in](char lo, char hi) {
+            return _mm_and_si128(_mm_cmpgt_epi8(in, _mm_set1_epi8(static_cast<char>(lo - 1))),
+                                 _mm_cmplt_epi8(in, _mm_set1_epi8(static_cast<char>(hi + 1))));
+        };
+        __m128i upper = between('A', 'Z');
+        __m128i lower = between('a', 'z');
+        __m128i digit = between('0', '9');
+        __m128i plus = _mm_cmpeq_epi8(in, _mm_set1_epi8('+'));
+        __m128i slash = _mm_cmpeq_epi8(in, _mm_set1_epi8('/'));
+
+        __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, _mm_or_si128(plus, slash)));
+        if (_mm_movemask_epi8(valid) != 0xFFFF) {
+            break;
+        }
+
+        __m128i shift = _mm_and_si128(upper, _mm_set1_epi8(-'A'));
+        shift = _mm_or_si128(shift, _mm_and_si128(lower, _mm_set1_epi8(26 - 'a')));
+        shift = _mm_or_si128(shift, _mm_and_si128(digit, _mm_set1_epi8(52 - '0')));
+        shift = _mm_or_si128(shift, _mm_and_si128(plus, _mm_set1_epi8(62 - '+')));
+        shift = _mm_or_si128(shift, _mm_and_si128(slash, _mm_set1_epi8(63 - '/')));
+        __m128i values = _mm_add_epi8(in, shift);
+
+        // Merge four 6-bit values per lane into 24 bits, then drop every
+        // fourth byte and restore big-endian byte order
+        __m128i pairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+        __m128i merged = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+        __m128i packed = _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12,
+                                                                 -1, -1, -1, -1));
+
+        alignas(16) uint8_t buffer[16];
+        _mm_store_si128(reinterpret_cast<__m128i*>(buffer), packed);
+        std::memcpy(out, buffer, 12);
+    }
+    return i;
+}
+
+// Same steps as encode_ssse3 on two 12-byte groups per 256-bit register;
+// all shuffles stay within 128-bit lanes. Reads 28 bytes per 24 consumed.
+__attribute__((target("avx2")))
+size_t encode_avx2(const uint8_t* data, size_t size, char* out) {
+    size_t i = 0;
+    for (; i + 28 <= size; i += 24, out += 32) {
+        __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 12));
+        __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+
+        in = _mm256_shuffle_epi8(in, _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+                                                      1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+        __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+        __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+        __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        __m256i indices = _mm256_or_si256(t1, t3);
+
+        const __m256i offsets = _mm256_setr_epi8(
+            'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+            'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+        __m256i range = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        __m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+        range = _mm256_or_si256(range, _mm256_and_si256(upper, _mm256_set1_epi8(13)));
+        __m256i ascii = _mm256_add_epi8(indices, _mm256_shuffle_epi8(offsets, range));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), ascii);
+    }
+    return i + encode_ssse3(data + i, size - i, out);
+}
+
+__attribute__((target("avx2")))
+inline __m256i between_avx2(__m256i in, char lo, char hi) {
+    return _mm256_and_si256(_mm256_cmpgt_epi8(in, _mm256_set1_epi8(static_cast<char>(lo - 1))),
+                            _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(hi + 1)), in));
+}
+
+// Same steps as decode_ssse3 on 32 characters at a time
+__attribute__((target("avx2")))
+size_t decode_avx2(const char* data, size_t size, uint8_t* out) {
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32, out += 24) {
+        __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+
+        __m256i upper = between_avx2(in, 'A', 'Z');
+        __m256i lower = between_avx2(in, 'a', 'z');
+        __m256i digit = between_avx2(in, '0', '9');
+        __m256i plus = _mm256_cmpeq_epi8(in, _mm256_set1_epi8('+'));
+        __m256i slash = _mm256_cmpeq_epi8(in, _mm256_set1_epi8('/'));
+
+        __m256i valid = _mm256_or_si256(_mm256_or_si256(upper, lower), _mm256_or_si256(digit, _mm256_or_si256(plus, slash)));
+        if (static_cast<uint32_t>(_mm256_movemask_epi8(valid)) != 0xFFFFFFFFu) {
+            break;
+        }
+
+        __m256i shift = _mm256_and_si256(upper, _mm256_set1_epi8(-'A'));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(lower, _mm256_set1_epi8(26 - 'a')));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(digit, _mm256_set1_epi8(52 - '0')));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(plus, _mm256_set1_epi8(62 - '+')));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(slash, _mm256_set1_epi8(63 - '/')));
+        __m256i values = _mm256_add_epi8(in, shift);
+
+        __m256i pairs = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        __m256i merged = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+        __m256i packed = _mm256_shuffle_epi8(merged, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                                                      2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+
+        alignas(32) uint8_t buffer[32];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(buffer), packed);
+        std::memcpy(out, buffer, 12);
+        std::memcpy(out + 12, buffer + 16, 12);
+    }
+    return i + decode_ssse3(data + i, size - i, out);
+}
+
+#endif
+
+struct Codec {
+    size_t (*encode)(const uint8_t*, size_t, char*);
+    size_t (*decode)(const char*, size_t, uint8_t*);
+    const char* name;
+};
+
+const Codec& vector_codec() {
+    static const Codec codec = [] {
+#ifdef COMPRESSOR_BASE64_SSSE3
+        const CpuFeatures& cpu = CpuFeatures::get();
+        if (cpu.avx2) return Codec{encode_avx2, decode_avx2, "avx2"};
+        if (cpu.ssse3) return Codec{encode_ssse3, decode_ssse3, "ssse3"};
+#endif
+        return Codec{nullptr, nullptr, "portable"};
+    }();
+    return codec;
+}
+
+} // namespace
+
+const char* Base64::implementation() {
+    return vector_codec().name;
+}
+
+void Base64::encode(const uint8_t* data, size_t size, char* out) {
+    size_t i = 0;
+    const Codec& codec = vector_codec();
+    if (codec.encode) {
+        i = codec.encode(data, size, out);
+        out += i / 3 * 4;
+    }
+
+    for (; i + 3 <= size; i += 3) {
+        uint32_t group = (static_cast<uint32_t>(data[i]) << 16) |
+                         (static_cast<uint32_t>(data[i + 1]) << 8) |
+                         static_cast<uint32_t>(data[i + 2]);
+        *out++ = ALPHABET[(group >> 18) & 0x3F];
+        *out++ = ALPHABET[(group >> 12) & 0x3F];
+        *out++ = ALPHABET[(group >> 6) & 0x3F];
+        *out++ = ALPHABET[group & 0x3F];
+    }
+
+    size_t remaining = size - i;
+    if (remaining > 0) {
+        uint32_t group = static_cast<uint32_t>(data[i]) << 16;
+        if (remaining == 2) {
+            group |= static_cast<uint32_t>(data[i + 1]) << 8;
+        }
+        *out++ = ALPHABET[(group >> 18) & 0x3F];
+        *out++ = ALPHABET[(group >> 12) & 0x3F];
+        *out++ = remaining == 2 ? ALPHABET[(group >> 6) & 0x3F] : '=';
+        *out++ = '=';
+    }
+}
+
+std::string Base64::encode(const ByteVector& data) {
+    std::string result(encoded_size(data.size()), '\0');
+    encode(data.data(), data.size(), &result[0]);
+    return result;
+}
+
+bool Base64::decode(const char* data, size_t size, ByteVector& out) {
+    out.resize(size / 4 * 3 + 3);
+    uint8_t* dst = out.data();
+
+    uint32_t group = 0;
+    int pending = 0;   // Characters of the current 4-character group
+    size_t i = 0;
+    const Codec& codec = vector_codec();
+
+    while (i < size) {
+        if (pending == 0 && codec.decode) {
+            size_t consumed = codec.decode(data + i, size - i, dst);
+            i += consumed;
+            dst += consumed / 4 * 3;
+            if (i >= size) break;
+        }
+
+        int8_t value = decode_table.values[static_cast<uint8_t>(data[i++])];
+        if (value == SPACE) continue;
+        if (value == INVALID) return false;
+
+        if (value == PAD) {
+            // Only padding and whitespace may follow
+            for (; i < size; ++i) {
+                int8_t rest = decode_table.values[static_cast<uint8_t>(data[i])];
+                if (rest != PAD && rest != SPACE) return false;
+            }
+            break;
+        }
+
+        group = (group << 6) | static_cast<uint32_t>(value);
+        if (++pending == 4) {
+            *dst++ = static_cast<uint8_t>(group >> 16);
+            *dst++ = static_cast<uint8_t>(group >> 8);
+            *dst++ = static_cast<uint8_t>(group);
+            group = 0;
+            pending = 0;
+        }
+    }
+
+    // A trailing partial group carries one or two bytes
+    if (pending == 1) return false;
+    if (pending == 2) {
+        *dst++ = static_cast<uint8_t>(group >> 4);
+    } else if (pending == 3) {
+        *dst++ = static_cast<uint8_t>(group >> 10);
+        *dst++ = static_cast<uint8_t>(group >> 2);
+    }
+
+    out.resize(static_cast<size_t>(dst - out.data()));
+    return true;
+}
+
+} // namespace utils
+} // namespace compressor
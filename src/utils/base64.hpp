@@ -0,0 +1,37 @@
+#ifndef COMPRESSOR_BASE64_HPP
+#define COMPRESSOR_BASE64_HPP
+
+#include "core/common.hpp"
+#include <cstdint>
+#include <string>
+
+namespace compressor {
+namespace utils {
+
+// Standard base64 (RFC 4648, padded). On x86 CPUs with AVX2 or SSSE3 full
+// groups are encoded and decoded with byte shuffles, chosen at runtime;
+// the remainder and any irregular input go through the scalar tables.
+class Base64 {
+public:
+    // Vector path in use: "avx2", "ssse3" or "portable"
+    static const char* implementation();
+
+    // Exact number of characters produced for `size` input bytes
+    static size_t encoded_size(size_t size) { return (size + 2) / 3 * 4; }
+
+    // Writes exactly encoded_size(size) characters to `out`
+    static void encode(const uint8_t* data, size_t size, char* out);
+    static std::string encode(const ByteVector& data);
+
+    // Whitespace is skipped and trailing padding is optional. Returns false
+    // on any other character outside the alphabet or misplaced padding.
+    static bool decode(const char* data, size_t size, ByteVector& out);
+    static bool decode(const std::string& data, ByteVector& out) {
+        return decode(data.data(), data.size(), out);
+    }
+};
+
+} // namespace utils
+} // namespace compressor
+
+#endif // COMPRESSOR_BASE64_HPP
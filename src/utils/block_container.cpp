@@ -0,0 +1,98 @@
+#include "utils/block_container.hpp"
+
+namespace compressor {
+namespace utils {
+
+static void write_u32(std::ostream& out, uint32_t value) {
+    char bytes[4] = {
+        static_cast<char>((value >> 24) & 0xFF),
+        static_cast<char>((value >> 16) & 0xFF),
+        static_cast<char>((value >> 8) & 0xFF),
+        static_cast<char>(value & 0xFF)
+    };
+    out.write(bytes, 4);
+}
+
+static bool read_u32(std::istream& in, uint32_t& value) {
+    unsigned char bytes[4];
+    in.read(reinterpret_cast<char*>(bytes), 4);
+    if (in.gcount() != 4) {
+        return false;
+    }
+    value = (static_cast<uint32_t>(bytes[0]) << 24) |
+            (static_cast<uint32_t>(bytes[1]) << 16) |
+            (static_cast<uint32_t>(bytes[2]) << 8) |
+            static_cast<uint32_t>(bytes[3]);
+    return true;
+}
+
+void BlockContainer::write_header(std::ostream& out, const BlockContainerHeader& header) {
+    out.write("CBLK", 4);
+    out.put(static_cast<char>(VERSION));
+    out.put(static_cast<char>(header.algorithm.size()));
+    out.write(header.algorithm.data(), header.algorithm.size());
+    write_u32(out, header.block_size);
+}
+
+void BlockContainer::write_block(std::ostream& out, uint32_t original_size, const ByteVector& compressed) {
+    write_u32(out, original_size);
+    write_u32(out, static_cast<uint32_t>(compressed.size()));
+    out.write(reinterpret_cast<const char*>(compressed.data()), compressed.size());
+}
+
+BlockContainerHeader BlockContainer::read_header(std::istream& in) {
+    char magic[4];
+    in.read(magic, 4);
+    if (in.gcount() != 4 || magic[0] != 'C' || magic[1] != 'B' || magic[2] != 'L' || magic[3] != 'K') {
+        throw DecompressionException("Invalid block container signature");
+    }
+
+    int version = in.get();
+    if (version != VERSION) {
+        throw DecompressionException("Unsupported block container version");
+    }
+
+    int name_length = in.get();
+    if (name_length == std::char_traits<char>::eof()) {
+        throw DecompressionException("Truncated block container header");
+    }
+
+    BlockContainerHeader header;
+    header.algorithm.resize(name_length);
+    in.read(&header.algorithm[0], name_length);
+    if (in.gcount() != name_length || !read_u32(in, header.block_size)) {
+        throw DecompressionException("Truncated block container header");
+    }
+
+    return header;
+}
+
+bool BlockContainer::read_block(std::istream& in, uint32_t block_size, uint32_t& original_size,
+                                ByteVector& compressed) {
+    if (in.peek() == std::char_traits<char>::eof()) {
+        return false;
+    }
+
+    uint32_t compressed_size = 0;
+    if (!read_u32(in, original_size) || !read_u32(in, compressed_size)) {
+        throw DecompressionException("Truncated block frame header");
+    }
+    if (!frame_fits(block_size, original_size, compressed_size)) {
+        throw DecompressionException("Block frame sizes exceed the container block size");
+    }
+
+    compressed.resize(compressed_size);
+    in.read(reinterpret_cast<char*>(compressed.data()), compressed_size);
+    if (static_cast<uint32_t>(in.gcount()) != compressed_size) {
+        throw DecompressionException("Truncated block frame data");
+    }
+
+    return true;
+}
+
+bool BlockContainer::is_container(const ByteVector& data) {
+    return data.size() >= 4 && data[0] == 'C' && data[1] == 'B' && data[2] == 'L' && data[3] == 'K';
+}
+
+} // namespace utils
+} // namespace compressor
@@ -0,0 +1,55 @@
+#ifndef COMPRESSOR_BLOCK_CONTAINER_HPP
+#define COMPRESSOR_BLOCK_CONTAINER_HPP
+
+#include "core/common.hpp"
+#include <istream>
+#include <ostream>
+#include <string>
+
+namespace compressor {
+namespace utils {
+
+// Header of a block container stream
+struct BlockContainerHeader {
+    std::string algorithm;
+    uint32_t block_size;
+
+    BlockContainerHeader() : block_size(0) {}
+    BlockContainerHeader(const std::string& algo, uint32_t size) : algorithm(algo), block_size(size) {}
+};
+
+// Framed stream of independently compressed blocks.
+//
+// Layout: "CBLK" | version | algorithm name length | name | block size (u32),
+// then one frame per block: original size (u32) | compressed size (u32) | data.
+// Blocks are self-contained, so inputs of any size can be processed with
+// memory bounded by the block size.
+class BlockContainer {
+public:
+    static constexpr uint8_t VERSION = 1;
+
+    static void write_header(std::ostream& out, const BlockContainerHeader& header);
+    static void write_block(std::ostream& out, uint32_t original_size, const ByteVector& compressed);
+
+    // Throws DecompressionException on a malformed header
+    static BlockContainerHeader read_header(std::istream& in);
+
+    // Returns false at a clean end of stream; throws on truncated frames and
+    // on sizes frame_fits() rejects, before allocating for the data
+    static bool read_block(std::istream& in, uint32_t block_size, uint32_t& original_size,
+                           ByteVector& compressed);
+
+    // Guard against absurd sizes from corrupt frames: a block holds at most
+    // `block_size` bytes, and no codec expands it more than eightfold
+    static bool frame_fits(uint32_t block_size, uint32_t original_size, uint32_t compressed_size) {
+        return original_size <= block_size && compressed_size <= block_size * 8ULL + 1024;
+    }
+
+    // Check whether a buffer starts with a container header
+    static bool is_container(const ByteVector& data);
+};
+
+} // namespace utils
+} // namespace compressor
+
+#endif // COMPRESSOR_BLOCK_CONTAINER_HPP
@@ -0,0 +1,62 @@
+#include "utils/cpu_features.hpp"
+#include <cstdlib>
+
+namespace compressor {
+namespace utils {
+
+namespace {
+
+CpuFeatures detect() {
+    CpuFeatures features;
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    // May run from a static initializer, before libgcc has filled its cache
+    __builtin_cpu_init();
+    features.sse2 = __builtin_cpu_supports("sse2");
+    features.ssse3 = __builtin_cpu_supports("ssse3");
+    features.sse42 = __builtin_cpu_supports("sse4.2");
+    features.pclmul = __builtin_cpu_supports("pclmul");
+    features.avx2 = __builtin_cpu_supports("avx2");
+    features.bmi2 = __builtin_cpu_supports("bmi2");
+    features.avx512bw = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#endif
+
+    const char* cap = std::getenv("COMPRESSOR_SIMD");
+    if (cap) {
+        std::string level(cap);
+        if (level == "scalar") {
+            features = CpuFeatures();
+        } else if (level == "sse4.2") {
+            features.avx2 = features.bmi2 = features.avx512bw = false;
+        } else if (level == "avx2") {
+            features.avx512bw = false;
+        }
+    }
+    return features;
+}
+
+} // namespace
+
+const CpuFeatures& CpuFeatures::get() {
+    static const CpuFeatures features = detect();
+    return features;
+}
+
+std::string CpuFeatures::describe() const {
+    std::string result;
+    auto add = [&result](bool present, const char* name) {
+        if (!present) return;
+        if (!result.empty()) result += ' ';
+        result += name;
+    };
+    add(sse2, "sse2");
+    add(ssse3, "ssse3");
+    add(sse42, "sse4.2");
+    add(pclmul, "pclmul");
+    add(avx2, "avx2");
+    add(bmi2, "bmi2");
+    add(avx512bw, "avx512bw");
+    return result.empty() ? "none" : result;
+}
+
+} // namespace utils
+} // namespace compressor
@@ -0,0 +1,35 @@
+#ifndef COMPRESSOR_CPU_FEATURES_HPP
+#define COMPRESSOR_CPU_FEATURES_HPP
+
+#include <string>
+
+namespace compressor {
+namespace utils {
+
+// Instruction set extensions usable by this process, detected once at
+// startup. Detection goes through the compiler's cpuid support, which also
+// checks that the OS saves the wider AVX registers. Everything is false on
+// non-x86 targets.
+//
+// The COMPRESSOR_SIMD environment variable caps the level for testing and
+// for working around a misbehaving kernel: "scalar", "sse4.2", "avx2" or
+// "avx512". It can only remove features, never add them.
+struct CpuFeatures {
+    bool sse2 = false;
+    bool ssse3 = false;
+    bool sse42 = false;
+    bool pclmul = false;
+    bool avx2 = false;
+    bool bmi2 = false;
+    bool avx512bw = false;   // Together with AVX-512F
+
+    static const CpuFeatures& get();
+
+    // Space-separated list of detected features, e.g. "sse2 ssse3 avx2"
+    std::string describe() const;
+};
+
+} // namespace utils
+} // namespace compressor
+
+#endif // COMPRESSOR_CPU_FEATURES_HPP
@@ -0,0 +1,187 @@
+#include "utils/cpu_topology.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <fstream>
+#include <sched.h>
+#include <sstream>
+
+namespace compressor {
+namespace utils {
+
+std::vector<int> CpuTopology::parse_cpu_list(const std::string& list) {
+    std::vector<int> cpus;
+    std::stringstream ss(list);
+    std::string item;
+
+    while (std::getline(ss, item, ',')) {
+        if (item.empty() || !std::isdigit(static_cast<unsigned char>(item[0]))) continue;
+
+        size_t dash = item.find('-');
+        try {
+            int first = std::stoi(item.substr(0, dash));
+            int last = dash == std::string::npos ? first : std::stoi(item.substr(dash + 1));
+            for (int cpu = first; cpu <= last; ++cpu) {
+                cpus.push_back(cpu);
+            }
+        } catch (const std::exception&) {
+            // Ignore malformed entries
+        }
+    }
+
+    return cpus;
+}
+
+namespace {
+
+// Smaller of `current` and `quota`, where 0 means unlimited
+double tighter(double current, double quota) {
+    if (quota <= 0.0) return current;
+    return current <= 0.0 ? quota : std::min(current, quota);
+}
+
+// cgroup v2: "max 100000" or "<quota> <period>"
+double read_cpu_max(const std::string& path) {
+    std::ifstream file(path);
+    std::string quota;
+    double period = 0.0;
+    if (!(file >> quota >> period) || quota == "max" || period <= 0.0) {
+        return 0.0;
+    }
+    try {
+        return std::stod(quota) / period;
+    } catch (const std::exception&) {
+        return 0.0;
+    }
+}
+
+// cgroup v1: cpu.cfs_quota_us is -1 when unlimited
+double read_cfs_quota(const std::string& dir) {
+    std::ifstream quota_file(dir + "/cpu.cfs_quota_us");
+    std::ifstream period_file(dir + "/cpu.cfs_period_us");
+    double quota = 0.0;
+    double period = 0.0;
+    if (!(quota_file >> quota) || !(period_file >> period) || quota <= 0.0 || period <= 0.0) {
+        return 0.0;
+    }
+    return quota / period;
+}
+
+std::string parent_path(const std::string& path) {
+    size_t slash = path.find_last_of('/');
+    return slash == 0 || slash == std::string::npos ? "/" : path.substr(0, slash);
+}
+
+} // namespace
+
+double CpuTopology::read_cgroup_quota() {
+    std::ifstream file("/proc/self/cgroup");
+    std::string line;
+    double quota = 0.0;
+
+    while (std::getline(file, line)) {
+        // hierarchy-id:controllers:path
+        size_t first = line.find(':');
+        size_t second = first == std::string::npos ? first : line.find(':', first + 1);
+        if (second == std::string::npos) continue;
+
+        std::string controllers = line.substr(first + 1, second - first - 1);
+        std::string path = line.substr(second + 1);
+        if (path.empty()) path = "/";
+
+        if (controllers.empty()) {
+            // cgroup v2: every ancestor's limit applies
+            for (std::string dir = path;; dir = parent_path(dir)) {
+                quota = tighter(quota, read_cpu_max("/sys/fs/cgroup" + (dir == "/" ? "" : dir) + "/cpu.max"));
+                if (dir == "/") break;
+            }
+        } else if (("," + controllers + ",").find(",cpu,") != std::string::npos) {
+            // cgroup v1. Inside a container the mount is usually already
+            // the container's own group, so also try the mount root.
+            for (const char* mount : {"/sys/fs/cgroup/cpu,cpuacct", "/sys/fs/cgroup/cpu"}) {
+                quota = tighter(quota, read_cfs_quota(mount + (path == "/" ? "" : path)));
+                quota = tighter(quota, read_cfs_quota(mount));
+            }
+        }
+    }
+
+    return quota;
+}
+
+int CpuTopology::node_of(int cpu) const {
+    for (size_t node = 0; node < nodes_.size(); ++node) {
+        if (std::find(nodes_[node].begin(), nodes_[node].end(), cpu) != nodes_[node].end()) {
+            return static_cast<int>(node);
+        }
+    }
+    return -1;
+}
+
+size_t CpuTopology::usable_cpus() const {
+    size_t count = std::max<size_t>(cpus_.size(), 1);
+    if (cpu_quota_ > 0.0) {
+        count = std::min(count, static_cast<size_t>(std::ceil(cpu_quota_)));
+    }
+    return std::max<size_t>(count, 1);
+}
+
+CpuTopology CpuTopology::detect() {
+    CpuTopology topology;
+
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &mask)) {
+                topology.cpus_.push_back(cpu);
+            }
+        }
+    }
+
+    // Node ids may be sparse (node0 and node2), so walk the online list
+    std::string online;
+    std::ifstream online_file("/sys/devices/system/node/online");
+    std::getline(online_file, online);
+
+    for (int node : parse_cpu_list(online)) {
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        if (!file) continue;
+
+        std::string list;
+        std::getline(file, list);
+
+        std::vector<int> node_cpus;
+        for (int cpu : parse_cpu_list(list)) {
+            if (std::find(topology.cpus_.begin(), topology.cpus_.end(), cpu) != topology.cpus_.end()) {
+                node_cpus.push_back(cpu);
+            }
+        }
+        if (!node_cpus.empty()) {
+            topology.nodes_.push_back(std::move(node_cpus));
+        }
+    }
+
+    if (topology.nodes_.empty() && !topology.cpus_.empty()) {
+        topology.nodes_.push_back(topology.cpus_);
+    }
+
+    topology.cpu_quota_ = read_cgroup_quota();
+
+    return topology;
+}
+
+bool CpuTopology::pin_current_thread(const std::vector<int>& cpus) {
+    if (cpus.empty()) return false;
+
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &mask);
+        }
+    }
+    return sched_setaffinity(0, sizeof(mask), &mask) == 0;
+}
+
+} // namespace utils
+} // namespace compressor
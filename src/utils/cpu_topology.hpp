@@ -0,0 +1,52 @@
+#ifndef COMPRESSOR_CPU_TOPOLOGY_HPP
+#define COMPRESSOR_CPU_TOPOLOGY_HPP
+
+#include <string>
+#include <vector>
+
+namespace compressor {
+namespace utils {
+
+// CPUs this process may run on, grouped by NUMA node.
+//
+// Node layout comes from /sys/devices/system/node; the usable set is
+// restricted to the scheduler affinity mask, which reflects taskset and
+// cgroup cpusets. Machines without NUMA information appear as one node.
+// A cgroup CPU quota (cpu.max, or cfs_quota_us under cgroup v1) further
+// caps how many threads are worth running.
+class CpuTopology {
+public:
+    static CpuTopology detect();
+
+    const std::vector<int>& cpus() const { return cpus_; }
+    const std::vector<std::vector<int>>& nodes() const { return nodes_; }
+
+    // Index into nodes() of the node holding `cpu`, or -1
+    int node_of(int cpu) const;
+
+    // CPUs' worth of time the cgroup quota allows; 0 when unlimited
+    double cpu_quota() const { return cpu_quota_; }
+
+    // Threads that can run at once: the affinity mask capped by the quota
+    // (rounded up), and never less than one
+    size_t usable_cpus() const;
+
+    // Pin the calling thread (or, before it spawns threads, the process)
+    static bool pin_current_thread(const std::vector<int>& cpus);
+
+    // Parse a kernel CPU list such as "0-3,8,10-11"
+    static std::vector<int> parse_cpu_list(const std::string& list);
+
+    // Quota of this process's cgroup and its ancestors, in CPUs; 0 if none
+    static double read_cgroup_quota();
+
+private:
+    std::vector<int> cpus_;
+    std::vector<std::vector<int>> nodes_;
+    double cpu_quota_ = 0.0;
+};
+
+} // namespace utils
+} // namespace compressor
+
+#endif // COMPRESSOR_CPU_TOPOLOGY_HPP
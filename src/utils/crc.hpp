@@ -7,6 +7,8 @@
 namespace compressor {
 namespace utils {
 
+// CRC-32 (IEEE 802.3). The byte loop is a runtime-dispatched kernel: PCLMUL
+// folding where available, slicing-by-8 elsewhere (see kernels.hpp).
 class CRC32 {
 public:
     CRC32();
@@ -22,10 +24,6 @@ public:
     uint32_t finalize() const;
     
 private:
-    static uint32_t crc_table_[256];
-    static bool table_initialized_;
-    static void init_table();
-    
     uint32_t crc_;
 };
 
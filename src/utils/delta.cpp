@@ -0,0 +1,274 @@
+#include "utils/delta.hpp"
+#include "utils/crc.hpp"
+#include "utils/kernels.hpp"
+#include "utils/tracing.hpp"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace compressor {
+namespace utils {
+
+namespace {
+
+constexpr uint8_t OP_END = 0;
+constexpr uint8_t OP_COPY = 1;
+constexpr uint8_t OP_INSERT = 2;
+
+constexpr size_t HEADER_SIZE = 4 + 1 + 8 + 4;
+
+// Longer operations are split so lengths fit in a u32
+constexpr size_t MAX_OP_LENGTH = size_t(1) << 30;
+
+// Polynomial rolling hash over WINDOW bytes
+constexpr uint64_t HASH_PRIME = 0x100000001B3ULL;
+
+uint64_t window_hash(const uint8_t* data) {
+    uint64_t hash = 0;
+    for (size_t i = 0; i < Delta::WINDOW; ++i) {
+        hash = hash * HASH_PRIME + data[i];
+    }
+    return hash;
+}
+
+// HASH_PRIME^WINDOW: the weight of the byte leaving the window
+uint64_t outgoing_weight() {
+    uint64_t weight = 1;
+    for (size_t i = 0; i < Delta::WINDOW; ++i) {
+        weight *= HASH_PRIME;
+    }
+    return weight;
+}
+
+// Hash table over the reference's WINDOW-aligned blocks. A slot holds
+// block number + 1 (0 = empty); the first block to claim a slot keeps it.
+class BlockIndex {
+public:
+    BlockIndex(const uint8_t* reference, size_t size) : bits_(16) {
+        size_t blocks = size / Delta::WINDOW;
+        if (blocks >= std::numeric_limits<uint32_t>::max()) {
+            throw std::invalid_argument("Reference is too large");
+        }
+        while (bits_ < 28 && (size_t(1) << bits_) < blocks) {
+            ++bits_;
+        }
+        table_.assign(size_t(1) << bits_, 0);
+        for (size_t block = 0; block < blocks; ++block) {
+            uint32_t& entry = table_[slot(window_hash(reference + block * Delta::WINDOW))];
+            if (entry == 0) {
+                entry = static_cast<uint32_t>(block + 1);
+            }
+        }
+    }
+
+    // Reference offset of a block with this hash, or SIZE_MAX
+    size_t find(uint64_t hash) const {
+        uint32_t entry = table_[slot(hash)];
+        return entry != 0 ? static_cast<size_t>(entry - 1) * Delta::WINDOW : SIZE_MAX;
+    }
+
+private:
+    size_t slot(uint64_t hash) const {
+        return static_cast<size_t>((hash * 0x9E3779B97F4A7C15ULL) >> (64 - bits_));
+    }
+
+    unsigned bits_;
+    // Up to 1 GiB, probed at random: one TLB entry per 2 MiB page helps
+    std::vector<uint32_t, HugePageAllocator<uint32_t>> table_;
+};
+
+void put_u32(std::ostream& out, uint32_t value) {
+    uint8_t bytes[4] = {static_cast<uint8_t>(value >> 24), static_cast<uint8_t>(value >> 16),
+                        static_cast<uint8_t>(value >> 8), static_cast<uint8_t>(value)};
+    out.write(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+}
+
+void put_u64(std::ostream& out, uint64_t value) {
+    put_u32(out, static_cast<uint32_t>(value >> 32));
+    put_u32(out, static_cast<uint32_t>(value));
+}
+
+uint32_t get_u32(const uint8_t* data) {
+    return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16) |
+           (static_cast<uint32_t>(data[2]) << 8) | static_cast<uint32_t>(data[3]);
+}
+
+uint64_t get_u64(const uint8_t* data) {
+    return (static_cast<uint64_t>(get_u32(data)) << 32) | get_u32(data + 4);
+}
+
+void read_exact(std::istream& in, uint8_t* data, size_t size) {
+    in.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(size));
+    if (static_cast<size_t>(in.gcount()) != size) {
+        throw DecompressionException("Truncated patch");
+    }
+}
+
+} // namespace
+
+DeltaStats Delta::diff(const uint8_t* reference, size_t reference_size,
+                       const uint8_t* target, size_t target_size, std::ostream& patch) {
+    TraceSpan span("delta.diff");
+    span.arg("bytes", target_size);
+
+    DeltaStats stats;
+    stats.target_size = target_size;
+
+    patch.write("CDLT", 4);
+    patch.put(static_cast<char>(VERSION));
+    put_u64(patch, reference_size);
+    put_u32(patch, CRC32::calculate(reference, reference_size));
+
+    std::unique_ptr<BlockIndex> index;
+    {
+        TraceSpan index_span("delta.index");
+        index_span.arg("bytes", reference_size);
+        index = std::make_unique<BlockIndex>(reference, reference_size);
+    }
+
+    auto emit_insert = [&](size_t from, size_t to) {
+        while (from < to) {
+            size_t length = std::min(to - from, MAX_OP_LENGTH);
+            patch.put(static_cast<char>(OP_INSERT));
+            put_u32(patch, static_cast<uint32_t>(length));
+            patch.write(reinterpret_cast<const char*>(target + from), static_cast<std::streamsize>(length));
+            stats.inserted_bytes += length;
+            stats.inserts++;
+            from += length;
+        }
+    };
+    auto emit_copy = [&](size_t offset, size_t length) {
+        while (length > 0) {
+            size_t part = std::min(length, MAX_OP_LENGTH);
+            patch.put(static_cast<char>(OP_COPY));
+            put_u64(patch, offset);
+            put_u32(patch, static_cast<uint32_t>(part));
+            stats.copied_bytes += part;
+            stats.copies++;
+            offset += part;
+            length -= part;
+        }
+    };
+
+    {
+        TraceSpan match_span("delta.match");
+        const uint64_t outgoing = outgoing_weight();
+        size_t literal_start = 0;
+        size_t pos = 0;
+        uint64_t hash = target_size >= WINDOW ? window_hash(target) : 0;
+
+        while (pos + WINDOW <= target_size) {
+            size_t ref_pos = index->find(hash);
+            if (ref_pos != SIZE_MAX && std::memcmp(reference + ref_pos, target + pos, WINDOW) == 0) {
+                // Grow the match backwards over pending literals, then forwards
+                size_t back = 0;
+                while (back < pos - literal_start && back < ref_pos &&
+                       reference[ref_pos - back - 1] == target[pos - back - 1]) {
+                    ++back;
+                }
+                size_t limit = std::min(reference_size - ref_pos, target_size - pos) - WINDOW;
+                size_t length = back + WINDOW +
+                    Kernels::match_length(reference + ref_pos + WINDOW, target + pos + WINDOW, limit);
+
+                emit_insert(literal_start, pos - back);
+                emit_copy(ref_pos - back, length);
+
+                pos = pos - back + length;
+                literal_start = pos;
+                if (pos + WINDOW <= target_size) {
+                    hash = window_hash(target + pos);
+                }
+                continue;
+            }
+
+            if (pos + WINDOW < target_size) {
+                hash = hash * HASH_PRIME + target[pos + WINDOW] - target[pos] * outgoing;
+            }
+            ++pos;
+        }
+        emit_insert(literal_start, target_size);
+    }
+
+    patch.put(static_cast<char>(OP_END));
+    put_u64(patch, target_size);
+    put_u32(patch, CRC32::calculate(target, target_size));
+
+    if (!patch) {
+        throw std::runtime_error("Failed to write patch");
+    }
+    return stats;
+}
+
+DeltaStats Delta::apply(const uint8_t* reference, size_t reference_size,
+                        std::istream& patch, std::ostream& out) {
+    TraceSpan span("delta.apply");
+
+    uint8_t header[HEADER_SIZE];
+    read_exact(patch, header, HEADER_SIZE);
+    if (std::memcmp(header, "CDLT", 4) != 0) {
+        throw DecompressionException("Not a patch file");
+    }
+    if (header[4] != VERSION) {
+        throw DecompressionException("Unsupported patch version " + std::to_string(header[4]));
+    }
+    if (get_u64(header + 5) != reference_size || get_u32(header + 13) != CRC32::calculate(reference, reference_size)) {
+        throw DecompressionException("Patch was made against a different reference");
+    }
+
+    DeltaStats stats;
+    CRC32 crc;
+    ByteVector buffer(64 * 1024);
+    uint8_t fields[12];
+
+    for (;;) {
+        int tag = patch.get();
+        if (tag == std::char_traits<char>::eof()) {
+            throw DecompressionException("Truncated patch");
+        }
+
+        if (tag == OP_COPY) {
+            read_exact(patch, fields, 12);
+            uint64_t offset = get_u64(fields);
+            uint32_t length = get_u32(fields + 8);
+            if (offset > reference_size || length > reference_size - offset) {
+                throw DecompressionException("Patch copies outside the reference");
+            }
+            out.write(reinterpret_cast<const char*>(reference + offset), length);
+            crc.update(reference + offset, length);
+            stats.copied_bytes += length;
+            stats.copies++;
+        } else if (tag == OP_INSERT) {
+            read_exact(patch, fields, 4);
+            size_t remaining = get_u32(fields);
+            stats.inserted_bytes += remaining;
+            stats.inserts++;
+            while (remaining > 0) {
+                size_t part = std::min(remaining, buffer.size());
+                read_exact(patch, buffer.data(), part);
+                out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(part));
+                crc.update(buffer.data(), part);
+                remaining -= part;
+            }
+        } else if (tag == OP_END) {
+            read_exact(patch, fields, 12);
+            stats.target_size = stats.copied_bytes + stats.inserted_bytes;
+            if (get_u64(fields) != stats.target_size || get_u32(fields + 8) != crc.finalize()) {
+                throw DecompressionException("Patched output does not match the target checksum");
+            }
+            break;
+        } else {
+            throw DecompressionException("Invalid patch operation");
+        }
+    }
+
+    if (!out) {
+        throw std::runtime_error("Failed to write patched output");
+    }
+    return stats;
+}
+
+} // namespace utils
+} // namespace compressor
@@ -0,0 +1,58 @@
+#ifndef COMPRESSOR_DELTA_HPP
+#define COMPRESSOR_DELTA_HPP
+
+#include "core/common.hpp"
+#include <cstdint>
+#include <istream>
+#include <ostream>
+
+namespace compressor {
+namespace utils {
+
+struct DeltaStats {
+    uint64_t target_size;
+    uint64_t copied_bytes;    // Taken from the reference
+    uint64_t inserted_bytes;  // Carried in the patch
+    uint64_t copies;
+    uint64_t inserts;
+
+    DeltaStats() : target_size(0), copied_bytes(0), inserted_bytes(0), copies(0), inserts(0) {}
+};
+
+// Patches that rebuild a target file from a reference file, for shipping a
+// new version of a large file as its differences from the old one.
+//
+// The reference acts as an LZ77 prefix dictionary of unbounded distance.
+// Every WINDOW-byte block of it is indexed by hash (a long-distance match
+// table, as in zstd's --long mode), and a rolling hash over the target
+// finds blocks it shares with the reference. Matches are extended in both
+// directions, so any unchanged run of 2 * WINDOW - 1 bytes or more is found
+// wherever it moved to.
+//
+// Layout: "CDLT" | version | reference size (u64) | reference CRC32 (u32),
+// then operations, each a tag byte:
+//   COPY   (1): reference offset (u64) | length (u32)
+//   INSERT (2): length (u32) | bytes
+//   END    (0): target size (u64) | target CRC32 (u32)
+// All integers are big-endian. Operations are written and applied in
+// target order, so both directions stream.
+class Delta {
+public:
+    static constexpr uint8_t VERSION = 1;
+    static constexpr size_t WINDOW = 32;
+
+    // Write a patch turning `reference` into `target`
+    static DeltaStats diff(const uint8_t* reference, size_t reference_size,
+                           const uint8_t* target, size_t target_size, std::ostream& patch);
+
+    // Write the target rebuilt from `reference` and `patch` to `out`.
+    // Throws DecompressionException if the patch is malformed, was made
+    // against a different reference, or does not reproduce its target.
+    static DeltaStats apply(const uint8_t* reference, size_t reference_size,
+                            std::istream& patch, std::ostream& out);
+};
+
+} // namespace utils
+} // namespace compressor
+
+#endif // COMPRESSOR_DELTA_HPP
@@ -0,0 +1,305 @@
+#include "utils/dictionary.hpp"
+#include "utils/file_utils.hpp"
+#include "utils/hash.hpp"
+#include "utils/kernels.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace compressor {
+namespace utils {
+
+namespace {
+
+constexpr uint8_t FORMAT_VERSION = 1;
+constexpr size_t HEADER_SIZE = 4 + 1 + 4 + 4 + 256 * 4;
+
+// Trainer parameters: d-gram length and segment length
+constexpr size_t DMER = 6;
+constexpr size_t SEGMENT = 64;
+
+void put_u32(ByteVector& out, uint32_t value) {
+    out.push_back((value >> 24) & 0xFF);
+    out.push_back((value >> 16) & 0xFF);
+    out.push_back((value >> 8) & 0xFF);
+    out.push_back(value & 0xFF);
+}
+
+uint32_t get_u32(const ByteVector& in, size_t offset) {
+    return (static_cast<uint32_t>(in[offset]) << 24) | (static_cast<uint32_t>(in[offset + 1]) << 16) |
+           (static_cast<uint32_t>(in[offset + 2]) << 8) | static_cast<uint32_t>(in[offset + 3]);
+}
+
+uint64_t dmer_at(const ByteVector& data, size_t pos) {
+    uint64_t key = 0;
+    for (size_t i = 0; i < DMER; ++i) {
+        key = (key << 8) | data[pos + i];
+    }
+    return key;
+}
+
+struct Segment {
+    uint64_t score = 0;
+    const ByteVector* sample = nullptr;
+    size_t begin = 0;
+    size_t length = 0;
+};
+
+// Best segment of `data[a, b)`, scored by the summed sample frequency of
+// the distinct d-grams it contains
+void best_segment(const ByteVector& data, size_t a, size_t b,
+                  const std::unordered_map<uint64_t, uint32_t>& frequency, Segment& best) {
+    if (b - a < DMER) return;
+    size_t length = std::min(SEGMENT, b - a);
+    size_t dmers = length - DMER + 1;
+
+    std::unordered_map<uint64_t, uint32_t> active;
+    uint64_t score = 0;
+    auto add = [&](uint64_t key) {
+        if (active[key]++ == 0) {
+            auto it = frequency.find(key);
+            if (it != frequency.end()) score += it->second;
+        }
+    };
+    auto remove = [&](uint64_t key) {
+        if (--active[key] == 0) {
+            auto it = frequency.find(key);
+            if (it != frequency.end()) score -= it->second;
+        }
+    };
+
+    for (size_t j = a; j < a + dmers; ++j) {
+        add(dmer_at(data, j));
+    }
+    for (size_t start = a;; ++start) {
+        if (score > best.score) {
+            best.score = score;
+            best.sample = &data;
+            best.begin = start;
+            best.length = length;
+        }
+        if (start + length >= b) break;
+        remove(dmer_at(data, start));
+        add(dmer_at(data, start + dmers));
+    }
+}
+
+} // namespace
+
+Dictionary::Dictionary(ByteVector content, const std::vector<uint32_t>& frequencies)
+    : id_(NONE), content_(std::move(content)), frequencies_(frequencies) {
+    if (frequencies_.size() != 256) {
+        throw std::invalid_argument("Dictionary needs 256 byte frequencies");
+    }
+    for (auto& f : frequencies_) {
+        f = std::max<uint32_t>(f, 1);
+    }
+
+    ByteVector identity = content_;
+    for (uint32_t f : frequencies_) {
+        put_u32(identity, f);
+    }
+    id_ = static_cast<uint32_t>(ContentHash::calculate(identity).low);
+    if (id_ == NONE) id_ = 1;
+}
+
+std::string Dictionary::format_id(uint32_t id) {
+    char buffer[9];
+    std::snprintf(buffer, sizeof(buffer), "%08x", id);
+    return buffer;
+}
+
+ByteVector Dictionary::serialize() const {
+    ByteVector out;
+    out.reserve(HEADER_SIZE + content_.size());
+    out.push_back('C');
+    out.push_back('D');
+    out.push_back('C');
+    out.push_back('T');
+    out.push_back(FORMAT_VERSION);
+    put_u32(out, id_);
+    put_u32(out, static_cast<uint32_t>(content_.size()));
+    for (uint32_t f : frequencies_) {
+        put_u32(out, f);
+    }
+    out.insert(out.end(), content_.begin(), content_.end());
+    return out;
+}
+
+Dictionary Dictionary::deserialize(const ByteVector& data) {
+    if (data.size() < HEADER_SIZE || data[0] != 'C' || data[1] != 'D' || data[2] != 'C' || data[3] != 'T') {
+        throw std::runtime_error("Not a dictionary file");
+    }
+    if (data[4] != FORMAT_VERSION) {
+        throw std::runtime_error("Unsupported dictionary version " + std::to_string(data[4]));
+    }
+
+    uint32_t id = get_u32(data, 5);
+    uint32_t size = get_u32(data, 9);
+    if (data.size() != HEADER_SIZE + size) {
+        throw std::runtime_error("Truncated dictionary");
+    }
+
+    std::vector<uint32_t> frequencies(256);
+    for (size_t i = 0; i < 256; ++i) {
+        frequencies[i] = get_u32(data, 13 + i * 4);
+    }
+
+    Dictionary dictionary(ByteVector(data.begin() + HEADER_SIZE, data.end()), frequencies);
+    if (dictionary.id() != id) {
+        throw std::runtime_error("Dictionary id does not match its content");
+    }
+    return dictionary;
+}
+
+Dictionary Dictionary::train(const std::vector<ByteVector>& samples, size_t capacity) {
+    size_t total = 0;
+    uint64_t counts[256] = {};
+    for (const auto& sample : samples) {
+        Kernels::histogram(sample.data(), sample.size(), counts);
+        total += sample.size();
+    }
+    if (total == 0 || capacity == 0) {
+        throw std::invalid_argument("No training data");
+    }
+
+    // Scale the byte distribution so Huffman code lengths stay short
+    uint64_t scale = (total + 65535) / 65536;
+    std::vector<uint32_t> frequencies(256);
+    for (size_t i = 0; i < 256; ++i) {
+        frequencies[i] = static_cast<uint32_t>(std::max<uint64_t>(1, counts[i] / scale));
+    }
+
+    // Number of samples each d-gram occurs in
+    std::unordered_map<uint64_t, uint32_t> frequency;
+    std::unordered_set<uint64_t> seen;
+    for (const auto& sample : samples) {
+        seen.clear();
+        for (size_t i = 0; i + DMER <= sample.size(); ++i) {
+            uint64_t key = dmer_at(sample, i);
+            if (seen.insert(key).second) {
+                frequency[key]++;
+            }
+        }
+    }
+    // A d-gram seen in one sample only is not worth dictionary space
+    for (auto it = frequency.begin(); it != frequency.end();) {
+        it = samples.size() > 1 && it->second < 2 ? frequency.erase(it) : std::next(it);
+    }
+
+    // Split the corpus into epochs and take the best segment of each,
+    // then zero the d-grams it covers so later picks add new content.
+    // Repeat passes until the dictionary is full or nothing scores.
+    size_t wanted = std::max<size_t>(1, capacity / SEGMENT);
+    size_t epoch = std::max(SEGMENT, total / wanted);
+    std::vector<Segment> picked;
+    size_t picked_bytes = 0;
+
+    bool progress = true;
+    while (picked_bytes < capacity && progress) {
+        progress = false;
+        size_t epoch_start = 0;
+        while (epoch_start < total && picked_bytes < capacity) {
+            size_t epoch_end = epoch_start + epoch;
+            Segment best;
+            size_t base = 0;
+            for (const auto& sample : samples) {
+                size_t lo = std::max(epoch_start, base);
+                size_t hi = std::min(epoch_end, base + sample.size());
+                if (lo < hi) {
+                    best_segment(sample, lo - base, hi - base, frequency, best);
+                }
+                base += sample.size();
+                if (base >= epoch_end) break;
+            }
+            epoch_start = epoch_end;
+
+            if (best.score == 0) continue;
+            for (size_t j = best.begin; j + DMER <= best.begin + best.length; ++j) {
+                frequency.erase(dmer_at(*best.sample, j));
+            }
+            picked.push_back(best);
+            picked_bytes += best.length;
+            progress = true;
+        }
+    }
+
+    // Highest scores last, nearest to the data in the LZ77 window; drop
+    // the lowest if the last pick overshot
+    std::stable_sort(picked.begin(), picked.end(),
+                     [](const Segment& a, const Segment& b) { return a.score < b.score; });
+    ByteVector content;
+    content.reserve(picked_bytes);
+    for (const auto& segment : picked) {
+        content.insert(content.end(), segment.sample->begin() + segment.begin,
+                       segment.sample->begin() + segment.begin + segment.length);
+    }
+    if (content.size() > capacity) {
+        content.erase(content.begin(), content.begin() + (content.size() - capacity));
+    }
+
+    return Dictionary(std::move(content), frequencies);
+}
+
+uint32_t Dictionary::parse_id(const std::string& text) {
+    if (text.empty() || text.size() > 8 ||
+        text.find_first_not_of("0123456789abcdefABCDEF") != std::string::npos) {
+        throw std::invalid_argument("Invalid dictionary id: " + text);
+    }
+    return static_cast<uint32_t>(std::stoul(text, nullptr, 16));
+}
+
+DictionaryRegistry& DictionaryRegistry::instance() {
+    static DictionaryRegistry registry;
+    return registry;
+}
+
+uint32_t DictionaryRegistry::add(const Dictionary& dictionary) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& slot = dictionaries_[dictionary.id()];
+    if (!slot) {
+        slot = std::make_shared<const Dictionary>(dictionary);
+    }
+    return dictionary.id();
+}
+
+std::shared_ptr<const Dictionary> DictionaryRegistry::find(uint32_t id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = dictionaries_.find(id);
+    return it != dictionaries_.end() ? it->second : nullptr;
+}
+
+std::vector<std::shared_ptr<const Dictionary>> DictionaryRegistry::list() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::shared_ptr<const Dictionary>> result;
+    result.reserve(dictionaries_.size());
+    for (const auto& entry : dictionaries_) {
+        result.push_back(entry.second);
+    }
+    std::sort(result.begin(), result.end(),
+              [](const auto& a, const auto& b) { return a->id() < b->id(); });
+    return result;
+}
+
+uint32_t DictionaryRegistry::load_file(const std::string& path) {
+    try {
+        return add(Dictionary::deserialize(FileUtils::read_file(path)));
+    } catch (const std::exception& e) {
+        throw std::runtime_error(path + ": " + e.what());
+    }
+}
+
+size_t DictionaryRegistry::load_directory(const std::string& directory) {
+    size_t loaded = 0;
+    for (const auto& path : FileUtils::list_directory(directory)) {
+        if (FileUtils::get_extension(path) == "dict") {
+            load_file(path);
+            ++loaded;
+        }
+    }
+    return loaded;
+}
+
+} // namespace utils
+} // namespace compressor
@@ -0,0 +1,83 @@
+#ifndef COMPRESSOR_DICTIONARY_HPP
+#define COMPRESSOR_DICTIONARY_HPP
+
+#include "core/common.hpp"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace compressor {
+namespace utils {
+
+// Content dictionary for small payloads.
+//
+// `content` holds substrings that are frequent across the training
+// samples, most valuable last: LZ77 primes its window with it, so the end
+// of the dictionary sits at the shortest distances. `frequencies` is the
+// byte distribution of the samples, from which Huffman builds its code
+// instead of shipping a tree. Compressed data names the dictionary by id,
+// and the decoder looks it up in the DictionaryRegistry.
+class Dictionary {
+public:
+    static constexpr uint32_t NONE = 0;
+
+    // LZ77 reaches back WINDOW_SIZE bytes, so more content would be unused
+    static constexpr size_t DEFAULT_SIZE = 4096;
+
+    Dictionary(ByteVector content, const std::vector<uint32_t>& frequencies);
+
+    uint32_t id() const { return id_; }
+    std::string id_string() const { return format_id(id_); }
+    const ByteVector& content() const { return content_; }
+
+    // 256 entries, each at least 1, summing to at most 2^16 + 256
+    const std::vector<uint32_t>& frequencies() const { return frequencies_; }
+
+    // File format: "CDCT", version, id, content size, frequencies, content
+    ByteVector serialize() const;
+    static Dictionary deserialize(const ByteVector& data);
+
+    // Select up to `capacity` bytes of segments that cover the d-grams
+    // occurring in the most samples (a greedy cover, as in zstd's COVER)
+    static Dictionary train(const std::vector<ByteVector>& samples, size_t capacity = DEFAULT_SIZE);
+
+    // Ids are written as 8 hex digits; parse_id throws std::invalid_argument
+    static std::string format_id(uint32_t id);
+    static uint32_t parse_id(const std::string& text);
+
+private:
+    uint32_t id_;
+    ByteVector content_;
+    std::vector<uint32_t> frequencies_;
+};
+
+// Process-wide set of loaded dictionaries, keyed by id
+class DictionaryRegistry {
+public:
+    static DictionaryRegistry& instance();
+
+    // Returns the dictionary's id; adding the same dictionary twice is harmless
+    uint32_t add(const Dictionary& dictionary);
+    std::shared_ptr<const Dictionary> find(uint32_t id) const;
+    std::vector<std::shared_ptr<const Dictionary>> list() const;
+
+    // Throws std::runtime_error if the file is missing or malformed
+    uint32_t load_file(const std::string& path);
+
+    // Load every "*.dict" file in `directory`; returns how many were loaded
+    size_t load_directory(const std::string& directory);
+
+private:
+    DictionaryRegistry() = default;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<uint32_t, std::shared_ptr<const Dictionary>> dictionaries_;
+};
+
+} // namespace utils
+} // namespace compressor
+
+#endif // COMPRESSOR_DICTIONARY_HPP
@@ -1,12 +1,19 @@
 #include "utils/file_utils.hpp"
+#include "utils/tracing.hpp"
+#include <algorithm>
 #include <fstream>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 #include <stdexcept>
 
 namespace compressor {
 namespace utils {
 
 ByteVector FileUtils::read_file(const std::string& filename) {
+    TraceSpan span("file.read", "io");
     std::ifstream file(filename, std::ios::binary);
     if (!file.is_open()) {
         throw std::runtime_error("Cannot open file: " + filename);
@@ -18,6 +25,7 @@ ByteVector FileUtils::read_file(const std::string& filename) {
     file.seekg(0, std::ios::beg);
     
     // Read data
+    span.arg("bytes", size);
     ByteVector data(size);
     file.read(reinterpret_cast<char*>(data.data()), size);
     
@@ -29,6 +37,8 @@ ByteVector FileUtils::read_file(const std::string& filename) {
 }
 
 bool FileUtils::write_file(const std::string& filename, const ByteVector& data) {
+    TraceSpan span("file.write", "io");
+    span.arg("bytes", data.size());
     std::ofstream file(filename, std::ios::binary);
     if (!file.is_open()) {
         return false;
@@ -61,6 +71,31 @@ bool FileUtils::create_directory(const std::string& path) {
     return mkdir(path.c_str(), 0755) == 0;
 }
 
+bool FileUtils::is_directory(const std::string& path) {
+    struct stat buffer;
+    return stat(path.c_str(), &buffer) == 0 && S_ISDIR(buffer.st_mode);
+}
+
+std::vector<std::string> FileUtils::list_directory(const std::string& path) {
+    DIR* dir = opendir(path.c_str());
+    if (!dir) {
+        throw std::runtime_error("Cannot open directory: " + path);
+    }
+    
+    std::vector<std::string> files;
+    while (struct dirent* entry = readdir(dir)) {
+        std::string file = path + "/" + entry->d_name;
+        struct stat buffer;
+        if (stat(file.c_str(), &buffer) == 0 && S_ISREG(buffer.st_mode)) {
+            files.push_back(file);
+        }
+    }
+    closedir(dir);
+    
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
 // FileReader implementation
 FileUtils::FileReader::FileReader(const std::string& filename, size_t chunk_size)
     : file_(filename, std::ios::binary), chunk_size_(chunk_size), bytes_read_(0) {
@@ -86,6 +121,8 @@ ByteVector FileUtils::FileReader::read_chunk() {
     }
     
     size_t to_read = std::min(chunk_size_, total_size_ - bytes_read_);
+    TraceSpan span("file.read_chunk", "io");
+    span.arg("bytes", to_read);
     ByteVector chunk(to_read);
     
     file_.read(reinterpret_cast<char*>(chunk.data()), to_read);
@@ -119,6 +156,8 @@ bool FileUtils::FileWriter::write_chunk(const ByteVector& data) {
         return false;
     }
     
+    TraceSpan span("file.write_chunk", "io");
+    span.arg("bytes", data.size());
     file_.write(reinterpret_cast<const char*>(data.data()), data.size());
     if (file_.good()) {
         bytes_written_ += data.size();
@@ -128,5 +167,36 @@ bool FileUtils::FileWriter::write_chunk(const ByteVector& data) {
     return false;
 }
 
+// MappedFile implementation
+FileUtils::MappedFile::MappedFile(const std::string& filename) : data_(nullptr), size_(0) {
+    int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+    
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        throw std::runtime_error("Cannot stat file: " + filename);
+    }
+    
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ > 0) {
+        void* mapped = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error("Cannot map file: " + filename);
+        }
+        data_ = static_cast<const uint8_t*>(mapped);
+    }
+    close(fd);
+}
+
+FileUtils::MappedFile::~MappedFile() {
+    if (data_) {
+        munmap(const_cast<uint8_t*>(data_), size_);
+    }
+}
+
 } // namespace utils
 } // namespace compressor
@@ -4,6 +4,7 @@
 #include "core/common.hpp"
 #include <string>
 #include <fstream>
+#include <vector>
 
 namespace compressor {
 namespace utils {
@@ -28,6 +29,12 @@ public:
     // Create directory if it doesn't exist
     static bool create_directory(const std::string& path);
     
+    // Check if path is a directory
+    static bool is_directory(const std::string& path);
+    
+    // Paths of the regular files in a directory, sorted by name
+    static std::vector<std::string> list_directory(const std::string& path);
+    
     // Read file in chunks (for large files)
     class FileReader {
     public:
@@ -61,6 +68,25 @@ public:
         std::ofstream file_;
         size_t bytes_written_;
     };
+    
+    // Read-only memory mapping of a whole file; pages are loaded on access,
+    // so files larger than memory can be scanned
+    class MappedFile {
+    public:
+        // Throws std::runtime_error if the file cannot be opened or mapped
+        explicit MappedFile(const std::string& filename);
+        ~MappedFile();
+        
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        
+        const uint8_t* data() const { return data_; }
+        size_t size() const { return size_; }
+        
+    private:
+        const uint8_t* data_;
+        size_t size_;
+    };
 };
 
 } // namespace utils
@@ -0,0 +1,127 @@
+#include "utils/hash.hpp"
+#include <cerrno>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <sys/random.h>
+
+namespace compressor {
+namespace utils {
+
+namespace {
+
+inline uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t fmix64(uint64_t k) {
+    k ^= k >> 33;
+    k *= 0xFF51AFD7ED558CCDULL;
+    k ^= k >> 33;
+    k *= 0xC4CEB9FE1A85EC53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+inline uint64_t load64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+} // namespace
+
+std::string Hash128::to_hex() const {
+    std::ostringstream oss;
+    oss << std::hex << std::setfill('0') << std::setw(16) << high << std::setw(16) << low;
+    return oss.str();
+}
+
+Hash128 ContentHash::calculate(const ByteVector& data, uint64_t seed) {
+    return calculate(data.data(), data.size(), seed);
+}
+
+Hash128 ContentHash::calculate(const uint8_t* data, size_t length, uint64_t seed) {
+    const size_t nblocks = length / 16;
+    const uint64_t c1 = 0x87C37B91114253D5ULL;
+    const uint64_t c2 = 0x4CF5AD432745937FULL;
+
+    uint64_t h1 = seed;
+    uint64_t h2 = seed;
+
+    // Body: 16-byte blocks
+    for (size_t i = 0; i < nblocks; ++i) {
+        uint64_t k1 = load64(data + i * 16);
+        uint64_t k2 = load64(data + i * 16 + 8);
+
+        k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+        h1 = rotl64(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52DCE729;
+
+        k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+        h2 = rotl64(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495AB5;
+    }
+
+    // Tail: remaining 0-15 bytes
+    const uint8_t* tail = data + nblocks * 16;
+    uint64_t k1 = 0;
+    uint64_t k2 = 0;
+
+    switch (length & 15) {
+        case 15: k2 ^= static_cast<uint64_t>(tail[14]) << 48; // fallthrough
+        case 14: k2 ^= static_cast<uint64_t>(tail[13]) << 40; // fallthrough
+        case 13: k2 ^= static_cast<uint64_t>(tail[12]) << 32; // fallthrough
+        case 12: k2 ^= static_cast<uint64_t>(tail[11]) << 24; // fallthrough
+        case 11: k2 ^= static_cast<uint64_t>(tail[10]) << 16; // fallthrough
+        case 10: k2 ^= static_cast<uint64_t>(tail[9]) << 8;   // fallthrough
+        case 9:
+            k2 ^= static_cast<uint64_t>(tail[8]);
+            k2 *= c2; k2 = rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+            // fallthrough
+        case 8: k1 ^= static_cast<uint64_t>(tail[7]) << 56; // fallthrough
+        case 7: k1 ^= static_cast<uint64_t>(tail[6]) << 48; // fallthrough
+        case 6: k1 ^= static_cast<uint64_t>(tail[5]) << 40; // fallthrough
+        case 5: k1 ^= static_cast<uint64_t>(tail[4]) << 32; // fallthrough
+        case 4: k1 ^= static_cast<uint64_t>(tail[3]) << 24; // fallthrough
+        case 3: k1 ^= static_cast<uint64_t>(tail[2]) << 16; // fallthrough
+        case 2: k1 ^= static_cast<uint64_t>(tail[1]) << 8;  // fallthrough
+        case 1:
+            k1 ^= static_cast<uint64_t>(tail[0]);
+            k1 *= c1; k1 = rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+    }
+
+    // Finalization
+    h1 ^= length;
+    h2 ^= length;
+
+    h1 += h2;
+    h2 += h1;
+
+    h1 = fmix64(h1);
+    h2 = fmix64(h2);
+
+    h1 += h2;
+    h2 += h1;
+
+    return Hash128(h1, h2);
+}
+
+Hash128 Hash128::random() {
+    // Ids are the only access control on results, so every bit comes from
+    // the kernel CSPRNG rather than a seeded generator
+    uint64_t words[2];
+    uint8_t* bytes = reinterpret_cast<uint8_t*>(words);
+    size_t filled = 0;
+    while (filled < sizeof(words)) {
+        ssize_t got = getrandom(bytes + filled, sizeof(words) - filled, 0);
+        if (got < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error(std::string("getrandom failed: ") + std::strerror(errno));
+        }
+        filled += static_cast<size_t>(got);
+    }
+    return Hash128(words[0], words[1]);
+}
+
+} // namespace utils
+} // namespace compressor
@@ -0,0 +1,49 @@
+#ifndef COMPRESSOR_HASH_HPP
+#define COMPRESSOR_HASH_HPP
+
+#include "core/common.hpp"
+#include <cstdint>
+#include <functional>
+
+namespace compressor {
+namespace utils {
+
+// 128-bit content digest
+struct Hash128 {
+    uint64_t low;
+    uint64_t high;
+
+    Hash128() : low(0), high(0) {}
+    Hash128(uint64_t l, uint64_t h) : low(l), high(h) {}
+
+    bool operator==(const Hash128& other) const { return low == other.low && high == other.high; }
+    bool operator!=(const Hash128& other) const { return !(*this == other); }
+
+    std::string to_hex() const;
+
+    // 128 bits from getrandom(), used for unguessable job, upload and run
+    // identifiers. Throws std::runtime_error if the kernel refuses.
+    static Hash128 random();
+};
+
+// Fast non-cryptographic 128-bit hash (MurmurHash3 x64/128).
+// Suitable for content addressing and deduplication, not for security.
+class ContentHash {
+public:
+    static Hash128 calculate(const ByteVector& data, uint64_t seed = 0);
+    static Hash128 calculate(const uint8_t* data, size_t length, uint64_t seed = 0);
+};
+
+} // namespace utils
+} // namespace compressor
+
+namespace std {
+template<>
+struct hash<compressor::utils::Hash128> {
+    size_t operator()(const compressor::utils::Hash128& h) const noexcept {
+        return static_cast<size_t>(h.low ^ (h.high * 0x9E3779B97F4A7C15ULL));
+    }
+};
+} // namespace std
+
+#endif // COMPRESSOR_HASH_HPP
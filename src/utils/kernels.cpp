@@ -0,0 +1,634 @@
+#include "utils/kernels.hpp"
+#include "utils/base64.hpp"
+#include "utils/cpu_features.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <utility>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define COMPRESSOR_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ && defined(__GNUC__)
+#define COMPRESSOR_KERNELS_WORDS 1
+#endif
+
+namespace compressor {
+namespace utils {
+
+namespace {
+
+// Slicing-by-8 tables: tables[0] is the bytewise table, tables[k] advances
+// a byte through k further zero bytes
+struct CrcTables {
+    uint32_t tables[8][256];
+
+    constexpr CrcTables() : tables() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int j = 0; j < 8; ++j) {
+                crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+            }
+            tables[0][i] = crc;
+        }
+        for (int k = 1; k < 8; ++k) {
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t previous = tables[k - 1][i];
+                tables[k][i] = (previous >> 8) ^ tables[0][previous & 0xFF];
+            }
+        }
+    }
+};
+
+constexpr CrcTables crc_tables;
+
+uint32_t crc32_portable(uint32_t crc, const uint8_t* data, size_t size) {
+    const auto& t = crc_tables.tables;
+#ifdef COMPRESSOR_KERNELS_WORDS
+    for (; size >= 8; data += 8, size -= 8) {
+        uint32_t low, high;
+        std::memcpy(&low, data, 4);
+        std::memcpy(&high, data + 4, 4);
+        low ^= crc;
+        crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+              t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+    }
+#endif
+    for (size_t i = 0; i < size; ++i) {
+        crc = t[0][(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+size_t match_length_portable(const uint8_t* a, const uint8_t* b, size_t limit) {
+    size_t i = 0;
+#ifdef COMPRESSOR_KERNELS_WORDS
+    for (; i + 8 <= limit; i += 8) {
+        uint64_t x, y;
+        std::memcpy(&x, a + i, 8);
+        std::memcpy(&y, b + i, 8);
+        if (x != y) {
+            return i + (__builtin_ctzll(x ^ y) >> 3);
+        }
+    }
+#endif
+    while (i < limit && a[i] == b[i]) {
+        ++i;
+    }
+    return i;
+}
+
+size_t run_length_portable(const uint8_t* data, size_t limit) {
+    if (limit == 0) return 0;
+    size_t i = 1;
+#ifdef COMPRESSOR_KERNELS_WORDS
+    uint64_t pattern = data[0] * 0x0101010101010101ull;
+    for (; i + 8 <= limit; i += 8) {
+        uint64_t x;
+        std::memcpy(&x, data + i, 8);
+        if (x != pattern) {
+            return i + (__builtin_ctzll(x ^ pattern) >> 3);
+        }
+    }
+#endif
+    while (i < limit && data[i] == data[0]) {
+        ++i;
+    }
+    return i;
+}
+
+void shuffle_portable(const uint8_t* src, uint8_t* dst, size_t count, size_t width) {
+    for (size_t k = 0; k < width; ++k) {
+        uint8_t* plane = dst + k * count;
+        for (size_t i = 0; i < count; ++i) {
+            plane[i] = src[i * width + k];
+        }
+    }
+}
+
+void unshuffle_portable(const uint8_t* src, uint8_t* dst, size_t count, size_t width) {
+    for (size_t k = 0; k < width; ++k) {
+        const uint8_t* plane = src + k * count;
+        for (size_t i = 0; i < count; ++i) {
+            dst[i * width + k] = plane[i];
+        }
+    }
+}
+
+uint32_t load_le32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+void store_le32(uint8_t* p, uint32_t value) {
+    p[0] = static_cast<uint8_t>(value);
+    p[1] = static_cast<uint8_t>(value >> 8);
+    p[2] = static_cast<uint8_t>(value >> 16);
+    p[3] = static_cast<uint8_t>(value >> 24);
+}
+
+uint32_t low_mask(unsigned bits) {
+    return bits >= 32 ? 0xFFFFFFFFu : (1u << bits) - 1;
+}
+
+void pack128_portable(const uint32_t* in, uint8_t* out, unsigned bits) {
+    const uint32_t mask = low_mask(bits);
+    for (size_t lane = 0; lane < 4; ++lane) {
+        uint64_t acc = 0;
+        unsigned filled = 0;
+        size_t word = 0;
+        for (size_t k = 0; k < 32; ++k) {
+            acc |= static_cast<uint64_t>(in[4 * k + lane] & mask) << filled;
+            filled += bits;
+            if (filled >= 32) {
+                store_le32(out + (4 * word + lane) * 4, static_cast<uint32_t>(acc));
+                ++word;
+                acc >>= 32;
+                filled -= 32;
+            }
+        }
+    }
+}
+
+void unpack128_portable(const uint8_t* in, uint32_t* out, unsigned bits) {
+    const uint32_t mask = low_mask(bits);
+    for (size_t lane = 0; lane < 4; ++lane) {
+        uint64_t acc = 0;
+        unsigned available = 0;
+        size_t word = 0;
+        for (size_t k = 0; k < 32; ++k) {
+            if (available < bits) {
+                acc |= static_cast<uint64_t>(load_le32(in + (4 * word + lane) * 4)) << available;
+                ++word;
+                available += 32;
+            }
+            out[4 * k + lane] = static_cast<uint32_t>(acc) & mask;
+            acc >>= bits;
+            available -= bits;
+        }
+    }
+}
+
+void prefix_sum32_portable(uint32_t* values, size_t count, uint32_t initial, uint32_t increment) {
+    uint32_t sum = initial;
+    for (size_t i = 0; i < count; ++i) {
+        sum += values[i] + increment;
+        values[i] = sum;
+    }
+}
+
+#ifdef COMPRESSOR_KERNELS_X86
+
+__attribute__((target("sse2")))
+size_t match_length_sse2(const uint8_t* a, const uint8_t* b, size_t limit) {
+    size_t i = 0;
+    for (; i + 16 <= limit; i += 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        unsigned equal = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)));
+        if (equal != 0xFFFF) {
+            return i + __builtin_ctz(~equal);
+        }
+    }
+    return i + match_length_portable(a + i, b + i, limit - i);
+}
+
+__attribute__((target("sse2")))
+size_t run_length_sse2(const uint8_t* data, size_t limit) {
+    if (limit == 0) return 0;
+    __m128i pattern = _mm_set1_epi8(static_cast<char>(data[0]));
+    size_t i = 1;
+    for (; i + 16 <= limit; i += 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        unsigned equal = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, pattern)));
+        if (equal != 0xFFFF) {
+            return i + __builtin_ctz(~equal);
+        }
+    }
+    return i + run_length_portable(data + i - 1, limit - i + 1) - 1;
+}
+
+__attribute__((target("avx2")))
+size_t match_length_avx2(const uint8_t* a, const uint8_t* b, size_t limit) {
+    size_t i = 0;
+    for (; i + 32 <= limit; i += 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        uint32_t equal = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)));
+        if (equal != 0xFFFFFFFFu) {
+            return i + __builtin_ctz(~equal);
+        }
+    }
+    return i + match_length_sse2(a + i, b + i, limit - i);
+}
+
+__attribute__((target("avx2")))
+size_t run_length_avx2(const uint8_t* data, size_t limit) {
+    if (limit == 0) return 0;
+    __m256i pattern = _mm256_set1_epi8(static_cast<char>(data[0]));
+    size_t i = 1;
+    for (; i + 32 <= limit; i += 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        uint32_t equal = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, pattern)));
+        if (equal != 0xFFFFFFFFu) {
+            return i + __builtin_ctz(~equal);
+        }
+    }
+    return i + run_length_sse2(data + i - 1, limit - i + 1) - 1;
+}
+
+__attribute__((target("avx512f,avx512bw")))
+size_t match_length_avx512(const uint8_t* a, const uint8_t* b, size_t limit) {
+    size_t i = 0;
+    for (; i + 64 <= limit; i += 64) {
+        __m512i x = _mm512_loadu_si512(a + i);
+        __m512i y = _mm512_loadu_si512(b + i);
+        uint64_t differ = _mm512_cmpneq_epi8_mask(x, y);
+        if (differ != 0) {
+            return i + __builtin_ctzll(differ);
+        }
+    }
+    return i + match_length_avx2(a + i, b + i, limit - i);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+size_t run_length_avx512(const uint8_t* data, size_t limit) {
+    if (limit == 0) return 0;
+    __m512i pattern = _mm512_set1_epi8(static_cast<char>(data[0]));
+    size_t i = 1;
+    for (; i + 64 <= limit; i += 64) {
+        uint64_t differ = _mm512_cmpneq_epi8_mask(_mm512_loadu_si512(data + i), pattern);
+        if (differ != 0) {
+            return i + __builtin_ctzll(differ);
+        }
+    }
+    return i + run_length_avx2(data + i - 1, limit - i + 1) - 1;
+}
+
+__attribute__((target("sse4.1,pclmul")))
+inline __m128i load_128(const uint8_t* data) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+}
+
+// Multiply both halves of `value` by the folding constants in `k` and add
+// the next 128 bits of input
+__attribute__((target("sse4.1,pclmul")))
+inline __m128i fold_128(__m128i value, __m128i next, __m128i k) {
+    __m128i low = _mm_clmulepi64_si128(value, k, 0x00);
+    __m128i high = _mm_clmulepi64_si128(value, k, 0x11);
+    return _mm_xor_si128(_mm_xor_si128(high, low), next);
+}
+
+// Folding CRC with carry-less multiplication ("Fast CRC Computation for
+// Generic Polynomials Using PCLMULQDQ", Intel, 2009), constants for the
+// reflected IEEE polynomial. Four 128-bit lanes fold 64 bytes per step,
+// then collapse to one lane and Barrett-reduce to 32 bits. Needs at least
+// 64 bytes and a multiple of 16.
+__attribute__((target("sse4.1,pclmul")))
+uint32_t crc32_fold_pclmul(uint32_t crc, const uint8_t* data, size_t size) {
+    alignas(16) static const uint64_t k1k2[] = {0x0154442bd4, 0x01c6e41596};
+    alignas(16) static const uint64_t k3k4[] = {0x01751997d0, 0x00ccaa009e};
+    alignas(16) static const uint64_t k5k0[] = {0x0163cd6124, 0x0000000000};
+    alignas(16) static const uint64_t poly[] = {0x01db710641, 0x01f7011641};
+
+    __m128i x1 = _mm_xor_si128(load_128(data), _mm_cvtsi32_si128(static_cast<int>(crc)));
+    __m128i x2 = load_128(data + 16);
+    __m128i x3 = load_128(data + 32);
+    __m128i x4 = load_128(data + 48);
+    data += 64;
+    size -= 64;
+
+    __m128i k = _mm_load_si128(reinterpret_cast<const __m128i*>(k1k2));
+    for (; size >= 64; data += 64, size -= 64) {
+        x1 = fold_128(x1, load_128(data), k);
+        x2 = fold_128(x2, load_128(data + 16), k);
+        x3 = fold_128(x3, load_128(data + 32), k);
+        x4 = fold_128(x4, load_128(data + 48), k);
+    }
+
+    k = _mm_load_si128(reinterpret_cast<const __m128i*>(k3k4));
+    x1 = fold_128(x1, x2, k);
+    x1 = fold_128(x1, x3, k);
+    x1 = fold_128(x1, x4, k);
+    for (; size >= 16; data += 16, size -= 16) {
+        x1 = fold_128(x1, load_128(data), k);
+    }
+
+    // 128 -> 64 bits
+    __m128i mask = _mm_setr_epi32(~0, 0, ~0, 0);
+    __m128i t = _mm_clmulepi64_si128(x1, k, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), t);
+    k = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(k5k0));
+    t = _mm_srli_si128(x1, 4);
+    x1 = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x1, mask), k, 0x00), t);
+
+    // Barrett reduction to 32 bits
+    k = _mm_load_si128(reinterpret_cast<const __m128i*>(poly));
+    t = _mm_clmulepi64_si128(_mm_and_si128(x1, mask), k, 0x10);
+    t = _mm_clmulepi64_si128(_mm_and_si128(t, mask), k, 0x00);
+    x1 = _mm_xor_si128(x1, t);
+    return static_cast<uint32_t>(_mm_extract_epi32(x1, 1));
+}
+
+uint32_t crc32_pclmul(uint32_t crc, const uint8_t* data, size_t size) {
+    if (size >= 64) {
+        size_t folded = size & ~static_cast<size_t>(15);
+        crc = crc32_fold_pclmul(crc, data, folded);
+        data += folded;
+        size -= folded;
+    }
+    return crc32_portable(crc, data, size);
+}
+
+// Shuffles move 16 elements per step: pshufb groups equal byte positions
+// inside each vector, then an unpack transpose gathers them across
+// vectors. Both steps are permutations, so unshuffle runs them in reverse.
+
+__attribute__((target("ssse3")))
+void transpose_2(__m128i v[2]) {
+    __m128i a = _mm_unpacklo_epi64(v[0], v[1]);
+    __m128i b = _mm_unpackhi_epi64(v[0], v[1]);
+    v[0] = a;
+    v[1] = b;
+}
+
+// 4x4 transpose of 32-bit lanes
+__attribute__((target("ssse3")))
+void transpose_4(__m128i v[4]) {
+    __m128i t0 = _mm_unpacklo_epi32(v[0], v[1]);
+    __m128i t1 = _mm_unpacklo_epi32(v[2], v[3]);
+    __m128i t2 = _mm_unpackhi_epi32(v[0], v[1]);
+    __m128i t3 = _mm_unpackhi_epi32(v[2], v[3]);
+    v[0] = _mm_unpacklo_epi64(t0, t1);
+    v[1] = _mm_unpackhi_epi64(t0, t1);
+    v[2] = _mm_unpacklo_epi64(t2, t3);
+    v[3] = _mm_unpackhi_epi64(t2, t3);
+}
+
+// 8x8 transpose of 16-bit lanes
+__attribute__((target("ssse3")))
+void transpose_8(__m128i v[8]) {
+    __m128i a[8], b[8];
+    for (int j = 0; j < 4; ++j) {
+        a[j] = _mm_unpacklo_epi16(v[2 * j], v[2 * j + 1]);
+        a[j + 4] = _mm_unpackhi_epi16(v[2 * j], v[2 * j + 1]);
+    }
+    for (int j = 0; j < 2; ++j) {
+        b[4 * j] = _mm_unpacklo_epi32(a[4 * j], a[4 * j + 1]);
+        b[4 * j + 1] = _mm_unpacklo_epi32(a[4 * j + 2], a[4 * j + 3]);
+        b[4 * j + 2] = _mm_unpackhi_epi32(a[4 * j], a[4 * j + 1]);
+        b[4 * j + 3] = _mm_unpackhi_epi32(a[4 * j + 2], a[4 * j + 3]);
+    }
+    for (int j = 0; j < 4; ++j) {
+        v[2 * j] = _mm_unpacklo_epi64(b[2 * j], b[2 * j + 1]);
+        v[2 * j + 1] = _mm_unpackhi_epi64(b[2 * j], b[2 * j + 1]);
+    }
+}
+
+__attribute__((target("ssse3")))
+void transpose(__m128i* v, size_t width) {
+    if (width == 2) {
+        transpose_2(v);
+    } else if (width == 4) {
+        transpose_4(v);
+    } else {
+        transpose_8(v);
+    }
+}
+
+// pshufb masks grouping byte positions within one vector, and their inverses
+__attribute__((target("ssse3")))
+__m128i group_mask(size_t width, bool inverse) {
+    // Widths 2 and 8 are each other's inverse; width 4 is its own
+    const __m128i by_2 = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+    const __m128i by_4 = _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+    const __m128i by_8 = _mm_setr_epi8(0, 8, 1, 9, 2, 10, 3, 11, 4, 12, 5, 13, 6, 14, 7, 15);
+    if (width == 4) return by_4;
+    return (width == 2) != inverse ? by_2 : by_8;
+}
+
+__attribute__((target("ssse3")))
+void shuffle_ssse3(const uint8_t* src, uint8_t* dst, size_t count, size_t width) {
+    if (width != 2 && width != 4 && width != 8) {
+        shuffle_portable(src, dst, count, width);
+        return;
+    }
+    const __m128i mask = group_mask(width, false);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i v[8];
+        for (size_t j = 0; j < width; ++j) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * width + j * 16));
+            v[j] = _mm_shuffle_epi8(x, mask);
+        }
+        transpose(v, width);
+        for (size_t k = 0; k < width; ++k) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + k * count + i), v[k]);
+        }
+    }
+    for (; i < count; ++i) {
+        for (size_t k = 0; k < width; ++k) {
+            dst[k * count + i] = src[i * width + k];
+        }
+    }
+}
+
+__attribute__((target("ssse3")))
+void unshuffle_ssse3(const uint8_t* src, uint8_t* dst, size_t count, size_t width) {
+    if (width != 2 && width != 4 && width != 8) {
+        unshuffle_portable(src, dst, count, width);
+        return;
+    }
+    const __m128i mask = group_mask(width, true);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i v[8];
+        for (size_t k = 0; k < width; ++k) {
+            v[k] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + k * count + i));
+        }
+        transpose(v, width);
+        for (size_t j = 0; j < width; ++j) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * width + j * 16), _mm_shuffle_epi8(v[j], mask));
+        }
+    }
+    for (; i < count; ++i) {
+        for (size_t k = 0; k < width; ++k) {
+            dst[i * width + k] = src[k * count + i];
+        }
+    }
+}
+
+// Shift counts come from a register (psrld/pslld xmm), so one loop serves
+// every width; counts of 32 or more yield zero, like the portable code
+__attribute__((target("sse2")))
+void pack128_sse2(const uint32_t* in, uint8_t* out, unsigned bits) {
+    if (bits == 0) {
+        return;
+    }
+    const __m128i mask = _mm_set1_epi32(static_cast<int>(low_mask(bits)));
+    __m128i acc = _mm_setzero_si128();
+    unsigned filled = 0;
+    for (size_t k = 0; k < 32; ++k) {
+        __m128i v = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 4 * k)), mask);
+        acc = _mm_or_si128(acc, _mm_sll_epi32(v, _mm_cvtsi32_si128(static_cast<int>(filled))));
+        filled += bits;
+        if (filled >= 32) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), acc);
+            out += 16;
+            filled -= 32;
+            // Bits of v that did not fit start the next word
+            acc = _mm_srl_epi32(v, _mm_cvtsi32_si128(static_cast<int>(filled ? bits - filled : 32)));
+        }
+    }
+}
+
+// Decoding is the hot side, so it is specialized per width: with BITS
+// known the loop unrolls and every shift becomes an immediate
+template<unsigned BITS>
+__attribute__((target("sse2")))
+void unpack128_sse2_bits(const uint8_t* in, uint32_t* out) {
+    const __m128i mask = _mm_set1_epi32(static_cast<int>(low_mask(BITS)));
+    __m128i word = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+    unsigned used = 0;
+    size_t next = 1;
+#pragma GCC unroll 32
+    for (size_t k = 0; k < 32; ++k) {
+        __m128i v = _mm_srli_epi32(word, used);
+        used += BITS;
+        if (used >= 32) {
+            used -= 32;
+            if (next < BITS) {
+                word = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16 * next++));
+                // The value continues in the low bits of the next word
+                if (used > 0) {
+                    v = _mm_or_si128(v, _mm_slli_epi32(word, BITS - used));
+                }
+            }
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4 * k), BITS < 32 ? _mm_and_si128(v, mask) : v);
+    }
+}
+
+template<>
+__attribute__((target("sse2")))
+void unpack128_sse2_bits<0>(const uint8_t*, uint32_t* out) {
+    std::memset(out, 0, Kernels::PACK_BLOCK * sizeof(uint32_t));
+}
+
+template<size_t... WIDTHS>
+constexpr std::array<void (*)(const uint8_t*, uint32_t*), sizeof...(WIDTHS)>
+unpack128_sse2_table(std::index_sequence<WIDTHS...>) {
+    return {{unpack128_sse2_bits<WIDTHS>...}};
+}
+
+__attribute__((target("sse2")))
+void unpack128_sse2(const uint8_t* in, uint32_t* out, unsigned bits) {
+    static constexpr auto table = unpack128_sse2_table(std::make_index_sequence<33>());
+    table[std::min(bits, 32u)](in, out);
+}
+
+// Two shifted adds give the running sum within a vector; its last lane
+// carries into the next one
+__attribute__((target("sse2")))
+void prefix_sum32_sse2(uint32_t* values, size_t count, uint32_t initial, uint32_t increment) {
+    const __m128i step = _mm_set1_epi32(static_cast<int>(increment));
+    __m128i carry = _mm_set1_epi32(static_cast<int>(initial));
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i x = _mm_add_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i)), step);
+        x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+        x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+        x = _mm_add_epi32(x, carry);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(values + i), x);
+        carry = _mm_shuffle_epi32(x, 0xFF);
+    }
+    prefix_sum32_portable(values + i, count - i, static_cast<uint32_t>(_mm_cvtsi128_si32(carry)), increment);
+}
+
+#endif
+
+} // namespace
+
+Kernels::Table Kernels::table_ = {
+    match_length_portable, run_length_portable, crc32_portable, shuffle_portable, unshuffle_portable,
+    pack128_portable, unpack128_portable, prefix_sum32_portable, "portable", "slice8", "portable", "portable"
+};
+
+bool Kernels::resolve() {
+#ifdef COMPRESSOR_KERNELS_X86
+    const CpuFeatures& cpu = CpuFeatures::get();
+    if (cpu.avx512bw) {
+        table_.match_length = match_length_avx512;
+        table_.run_length = run_length_avx512;
+        table_.match_name = "avx512bw";
+    } else if (cpu.avx2) {
+        table_.match_length = match_length_avx2;
+        table_.run_length = run_length_avx2;
+        table_.match_name = "avx2";
+    } else if (cpu.sse2) {
+        table_.match_length = match_length_sse2;
+        table_.run_length = run_length_sse2;
+        table_.match_name = "sse2";
+    }
+    // The SSE4.2 crc32 instruction computes CRC-32C, a different polynomial
+    // from the checksums we store, so CRC-32 goes through PCLMUL folding
+    if (cpu.pclmul && cpu.sse42) {
+        table_.crc32 = crc32_pclmul;
+        table_.crc_name = "pclmul";
+    }
+    if (cpu.ssse3) {
+        table_.shuffle = shuffle_ssse3;
+        table_.unshuffle = unshuffle_ssse3;
+        table_.shuffle_name = "ssse3";
+    }
+    if (cpu.sse2) {
+        table_.pack128 = pack128_sse2;
+        table_.unpack128 = unpack128_sse2;
+        table_.prefix_sum32 = prefix_sum32_sse2;
+        table_.pack_name = "sse2";
+    }
+#endif
+    return true;
+}
+
+const bool Kernels::resolved_ = Kernels::resolve();
+
+void Kernels::histogram(const uint8_t* data, size_t size, uint64_t counts[256]) {
+    // 32-bit sub-counters, flushed often enough that they cannot overflow
+    constexpr size_t CHUNK = size_t(1) << 30;
+    uint32_t sub[4][256];
+
+    while (size > 0) {
+        size_t chunk = std::min(size, CHUNK);
+        std::memset(sub, 0, sizeof(sub));
+
+        size_t i = 0;
+        for (; i + 4 <= chunk; i += 4) {
+            sub[0][data[i]]++;
+            sub[1][data[i + 1]]++;
+            sub[2][data[i + 2]]++;
+            sub[3][data[i + 3]]++;
+        }
+        for (; i < chunk; ++i) {
+            sub[0][data[i]]++;
+        }
+
+        for (int b = 0; b < 256; ++b) {
+            counts[b] += static_cast<uint64_t>(sub[0][b]) + sub[1][b] + sub[2][b] + sub[3][b];
+        }
+        data += chunk;
+        size -= chunk;
+    }
+}
+
+std::string Kernels::describe() {
+    return std::string("crc32=") + table_.crc_name + " match=" + table_.match_name +
+           " run=" + table_.match_name + " shuffle=" + table_.shuffle_name +
+           " pack=" + table_.pack_name +
+           " base64=" + Base64::implementation();
+}
+
+} // namespace utils
+} // namespace compressor
@@ -0,0 +1,98 @@
+#ifndef COMPRESSOR_KERNELS_HPP
+#define COMPRESSOR_KERNELS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace compressor {
+namespace utils {
+
+// Hot inner loops shared by the codecs.
+//
+// Each kernel has a portable implementation and, on x86, variants built
+// with per-function target attributes (SSE2, AVX2, AVX-512BW, PCLMUL). The
+// fastest variant the CPU supports (see cpu_features.hpp) is installed in
+// a function pointer table during static initialization, so the binary
+// itself needs no ISA flags. Calls made before that run use the portable
+// code.
+class Kernels {
+public:
+    // Length of the common prefix of `a` and `b`, at most `limit`
+    static size_t match_length(const uint8_t* a, const uint8_t* b, size_t limit) {
+        return table_.match_length(a, b, limit);
+    }
+
+    // Number of bytes from `data` equal to data[0], at most `limit`
+    static size_t run_length(const uint8_t* data, size_t limit) {
+        return table_.run_length(data, limit);
+    }
+
+    // Advance a CRC-32 (IEEE 802.3, reflected) register over `data`. The
+    // register is the pre- and post-inverted value kept by CRC32.
+    static uint32_t crc32(uint32_t crc, const uint8_t* data, size_t size) {
+        return table_.crc32(crc, data, size);
+    }
+
+    // Add byte frequencies of `data` to `counts`. Spreads increments over
+    // four sub-tables so runs of equal bytes do not serialize on one
+    // counter; vector units do not help here, so there is one version.
+    static void histogram(const uint8_t* data, size_t size, uint64_t counts[256]);
+
+    // Byte-transpose `count` elements of `width` bytes: byte k of element i
+    // moves to dst[k * count + i]. unshuffle is the inverse. The buffers
+    // must not overlap. Widths 2, 4 and 8 have vector versions.
+    static void shuffle(const uint8_t* src, uint8_t* dst, size_t count, size_t width) {
+        table_.shuffle(src, dst, count, width);
+    }
+    static void unshuffle(const uint8_t* src, uint8_t* dst, size_t count, size_t width) {
+        table_.unshuffle(src, dst, count, width);
+    }
+
+    // Bit-pack PACK_BLOCK values below 2^bits (bits <= 32; higher bits are
+    // dropped) into 16 * bits bytes, and back. Value i belongs to lane i % 4
+    // and each lane packs its 32 values LSB-first into `bits` little-endian
+    // 32-bit words; word j of lane l is stored at byte (4 * j + l) * 4. The
+    // layout lets one 128-bit vector work on all four lanes.
+    static constexpr size_t PACK_BLOCK = 128;
+    static void pack128(const uint32_t* in, uint8_t* out, unsigned bits) {
+        table_.pack128(in, out, bits);
+    }
+    static void unpack128(const uint8_t* in, uint32_t* out, unsigned bits) {
+        table_.unpack128(in, out, bits);
+    }
+
+    // In-place running sum modulo 2^32: values[i] becomes initial plus the
+    // sum of (values[j] + increment) for j <= i. Decodes delta coding.
+    static void prefix_sum32(uint32_t* values, size_t count, uint32_t initial, uint32_t increment) {
+        table_.prefix_sum32(values, count, initial, increment);
+    }
+
+    // Selected implementation per kernel, e.g. "crc32=pclmul match=avx2 ..."
+    static std::string describe();
+
+private:
+    struct Table {
+        size_t (*match_length)(const uint8_t*, const uint8_t*, size_t);
+        size_t (*run_length)(const uint8_t*, size_t);
+        uint32_t (*crc32)(uint32_t, const uint8_t*, size_t);
+        void (*shuffle)(const uint8_t*, uint8_t*, size_t, size_t);
+        void (*unshuffle)(const uint8_t*, uint8_t*, size_t, size_t);
+        void (*pack128)(const uint32_t*, uint8_t*, unsigned);
+        void (*unpack128)(const uint8_t*, uint32_t*, unsigned);
+        void (*prefix_sum32)(uint32_t*, size_t, uint32_t, uint32_t);
+        const char* match_name;
+        const char* crc_name;
+        const char* shuffle_name;
+        const char* pack_name;
+    };
+
+    static Table table_;
+    static bool resolve();
+    static const bool resolved_;
+};
+
+} // namespace utils
+} // namespace compressor
+
+#endif // COMPRESSOR_KERNELS_HPP
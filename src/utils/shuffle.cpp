@@ -0,0 +1,81 @@
+#include "utils/shuffle.hpp"
+#include "utils/kernels.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace compressor {
+namespace utils {
+
+namespace {
+
+constexpr size_t SAMPLE_SIZE = 64 * 1024;
+
+// A wider element must beat the best narrower one by this factor, since
+// the planes of e.g. 16-byte elements over 8-byte data score about the same
+constexpr double MIN_GAIN = 0.97;
+
+// Order-0 entropy of `data`, in bits
+double entropy_bits(const uint8_t* data, size_t size) {
+    uint64_t counts[256] = {};
+    Kernels::histogram(data, size, counts);
+    double bits = 0.0;
+    for (uint64_t count : counts) {
+        if (count > 0) {
+            bits -= count * std::log2(static_cast<double>(count) / size);
+        }
+    }
+    return bits;
+}
+
+ByteVector transform(const ByteVector& data, size_t width, bool forward) {
+    ByteVector out(data.size());
+    size_t count = width > 0 ? data.size() / width : 0;
+    if (width <= 1 || count == 0) {
+        std::copy(data.begin(), data.end(), out.begin());
+        return out;
+    }
+    if (forward) {
+        Kernels::shuffle(data.data(), out.data(), count, width);
+    } else {
+        Kernels::unshuffle(data.data(), out.data(), count, width);
+    }
+    std::copy(data.begin() + count * width, data.end(), out.begin() + count * width);
+    return out;
+}
+
+} // namespace
+
+ByteVector ByteShuffle::shuffle(const ByteVector& data, size_t width) {
+    return transform(data, width, true);
+}
+
+ByteVector ByteShuffle::unshuffle(const ByteVector& data, size_t width) {
+    return transform(data, width, false);
+}
+
+size_t ByteShuffle::detect_width(const ByteVector& data) {
+    size_t sample = std::min(data.size(), SAMPLE_SIZE) & ~static_cast<size_t>(15);
+    if (sample < 256) {
+        return 1;
+    }
+
+    size_t best_width = 1;
+    double best_bits = entropy_bits(data.data(), sample);
+    ByteVector planes(sample);
+    for (size_t width : {2, 4, 8, 16}) {
+        size_t count = sample / width;
+        Kernels::shuffle(data.data(), planes.data(), count, width);
+        double bits = 0.0;
+        for (size_t k = 0; k < width; ++k) {
+            bits += entropy_bits(planes.data() + k * count, count);
+        }
+        if (bits < best_bits * MIN_GAIN) {
+            best_bits = bits;
+            best_width = width;
+        }
+    }
+    return best_width;
+}
+
+} // namespace utils
+} // namespace compressor
@@ -0,0 +1,33 @@
+#ifndef COMPRESSOR_SHUFFLE_HPP
+#define COMPRESSOR_SHUFFLE_HPP
+
+#include "core/common.hpp"
+#include <cstddef>
+#include <cstdint>
+
+namespace compressor {
+namespace utils {
+
+// Byte shuffle for arrays of fixed-width records (as in Blosc).
+//
+// Byte k of every element is stored together, so the slowly changing
+// bytes of numeric columns (exponents, high bytes of counters) form long
+// low-entropy runs instead of being interleaved with noisy low bytes.
+// Trailing bytes that do not fill an element are kept in place.
+class ByteShuffle {
+public:
+    static constexpr size_t MAX_WIDTH = 255;
+
+    static ByteVector shuffle(const ByteVector& data, size_t width);
+    static ByteVector unshuffle(const ByteVector& data, size_t width);
+
+    // Element width among 1, 2, 4, 8 and 16 whose byte planes have the
+    // lowest order-0 entropy over a sample of `data`. 1 means shuffling
+    // does not help.
+    static size_t detect_width(const ByteVector& data);
+};
+
+} // namespace utils
+} // namespace compressor
+
+#endif // COMPRESSOR_SHUFFLE_HPP
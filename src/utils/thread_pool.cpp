@@ -0,0 +1,204 @@
+#include "utils/thread_pool.hpp"
+#include "utils/tracing.hpp"
+#include <algorithm>
+#include <sched.h>
+#include <string>
+#include <stdexcept>
+
+namespace compressor {
+namespace utils {
+
+namespace {
+
+// Pool and node of the calling worker thread, if it is one
+thread_local const ThreadPool* current_pool = nullptr;
+thread_local size_t current_node = 0;
+
+} // namespace
+
+ThreadPool::ThreadPool(size_t num_threads, size_t reserved_high)
+    : ThreadPool(num_threads, reserved_high, CpuTopology()) {}
+
+ThreadPool::ThreadPool(size_t num_threads, size_t reserved_high, const CpuTopology& topology)
+    : topology_(topology), next_node_(0), stolen_(0), stopping_(false) {
+    if (num_threads == 0) {
+        num_threads = 1;
+    }
+
+    for (const auto& cpus : topology_.nodes()) {
+        nodes_.push_back(std::make_unique<Node>());
+        nodes_.back()->cpus = cpus;
+    }
+    if (nodes_.empty()) {
+        nodes_.push_back(std::make_unique<Node>());
+    }
+
+    // Walk the CPUs node by node so each node gets workers in proportion
+    // to its size
+    std::vector<size_t> slots;
+    for (size_t node = 0; node < nodes_.size(); ++node) {
+        slots.insert(slots.end(), std::max<size_t>(nodes_[node]->cpus.size(), 1), node);
+    }
+    auto node_for = [&slots](size_t worker, size_t count) {
+        return slots[worker * slots.size() / count % slots.size()];
+    };
+
+    workers_.reserve(num_threads + reserved_high);
+    for (size_t i = 0; i < num_threads; ++i) {
+        workers_.emplace_back(&ThreadPool::worker_loop, this, node_for(i, num_threads), false);
+    }
+    for (size_t i = 0; i < reserved_high; ++i) {
+        workers_.emplace_back(&ThreadPool::worker_loop, this, node_for(i, reserved_high), true);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    shutdown();
+}
+
+size_t ThreadPool::posting_node() {
+    if (nodes_.size() == 1) {
+        return 0;
+    }
+    if (current_pool == this) {
+        return current_node;
+    }
+    int cpu = sched_getcpu();
+    int node = cpu >= 0 ? topology_.node_of(cpu) : -1;
+    if (node >= 0) {
+        return static_cast<size_t>(node);
+    }
+    return next_node_++ % nodes_.size();
+}
+
+void ThreadPool::wake(size_t node) {
+    for (size_t i = 0; i < nodes_.size(); ++i) {
+        Node& candidate = *nodes_[(node + i) % nodes_.size()];
+        if (candidate.idle > 0) {
+            candidate.cv.notify_one();
+            return;
+        }
+    }
+}
+
+void ThreadPool::post(Task task, Priority priority) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_) {
+        throw std::runtime_error("ThreadPool is shutting down");
+    }
+
+    if (priority == Priority::HIGH) {
+        high_tasks_.push_back(std::move(task));
+        high_cv_.notify_one();
+        wake(current_pool == this ? current_node : 0);
+    } else {
+        size_t node = posting_node();
+        nodes_[node]->tasks.push_back(std::move(task));
+        wake(node);
+    }
+}
+
+size_t ThreadPool::run_pending_high() {
+    size_t ran = 0;
+    while (true) {
+        Task task;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (high_tasks_.empty()) {
+                return ran;
+            }
+            task = std::move(high_tasks_.front());
+            high_tasks_.pop_front();
+        }
+        task();
+        ran++;
+    }
+}
+
+size_t ThreadPool::pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = high_tasks_.size();
+    for (const auto& node : nodes_) {
+        count += node->tasks.size();
+    }
+    return count;
+}
+
+size_t ThreadPool::stolen() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stolen_;
+}
+
+void ThreadPool::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_ && workers_.empty()) {
+            return;
+        }
+        stopping_ = true;
+        for (auto& node : nodes_) {
+            node->cv.notify_all();
+        }
+        high_cv_.notify_all();
+    }
+
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers_.clear();
+}
+
+void ThreadPool::worker_loop(size_t node_index, bool high_only) {
+    Node& node = *nodes_[node_index];
+    if (!node.cpus.empty()) {
+        CpuTopology::pin_current_thread(node.cpus);
+    }
+    current_pool = this;
+    current_node = node_index;
+    Tracer::set_thread_name((high_only ? "pool-high/node" : "pool/node") + std::to_string(node_index));
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        Task task;
+        if (!high_tasks_.empty()) {
+            task = std::move(high_tasks_.front());
+            high_tasks_.pop_front();
+        } else if (!high_only && !node.tasks.empty()) {
+            task = std::move(node.tasks.front());
+            node.tasks.pop_front();
+        } else if (!high_only) {
+            // Own queue is empty: take the oldest task of another node
+            for (size_t i = 1; i < nodes_.size() && !task; ++i) {
+                auto& other = nodes_[(node_index + i) % nodes_.size()]->tasks;
+                if (!other.empty()) {
+                    task = std::move(other.front());
+                    other.pop_front();
+                    stolen_++;
+                }
+            }
+        }
+
+        if (!task) {
+            if (stopping_) {
+                return; // Stopping and drained
+            }
+            if (high_only) {
+                high_cv_.wait(lock);
+            } else {
+                node.idle++;
+                node.cv.wait(lock);
+                node.idle--;
+            }
+            continue;
+        }
+
+        lock.unlock();
+        task();
+        lock.lock();
+    }
+}
+
+} // namespace utils
+} // namespace compressor
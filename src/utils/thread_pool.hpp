@@ -0,0 +1,105 @@
+#ifndef COMPRESSOR_THREAD_POOL_HPP
+#define COMPRESSOR_THREAD_POOL_HPP
+
+#include "utils/cpu_topology.hpp"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace compressor {
+namespace utils {
+
+// Fixed-size worker pool with two FIFO lanes.
+//
+// HIGH tasks always run before NORMAL ones. `reserved_high` extra threads
+// serve only the HIGH lane, so short latency-sensitive tasks never wait for
+// long NORMAL tasks to finish; long tasks can also call run_pending_high()
+// between units of work to hand the thread over cooperatively.
+//
+// Given a CpuTopology, workers are spread over its NUMA nodes in proportion
+// to their CPUs and each pins itself to its node before allocating
+// anything, so its malloc arena and the buffers it fills are first-touched
+// on that node. NORMAL tasks queue on the node of the thread that posts
+// them: tasks posted from a worker stay on its node, and fan-out from a
+// request thread lands where its data was written. Idle workers take work
+// from other nodes only when their own queue is empty.
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    enum class Priority { HIGH, NORMAL };
+
+    explicit ThreadPool(size_t num_threads, size_t reserved_high = 0);
+    // An empty topology gives an unpinned pool with one queue
+    ThreadPool(size_t num_threads, size_t reserved_high, const CpuTopology& topology);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Queue a fire-and-forget task
+    void post(Task task, Priority priority = Priority::NORMAL);
+
+    // Queue a task and obtain its result through a future
+    template<typename Func>
+    auto submit(Func&& func, Priority priority = Priority::NORMAL) -> std::future<decltype(func())> {
+        using Result = decltype(func());
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Func>(func));
+        std::future<Result> future = task->get_future();
+        post([task]() { (*task)(); }, priority);
+        return future;
+    }
+
+    // Run queued HIGH tasks on the calling thread until that lane is empty;
+    // returns how many ran. Safe to call from inside a pool task.
+    size_t run_pending_high();
+
+    size_t size() const { return workers_.size(); }
+    size_t pending() const;
+
+    // Node queues; 1 unless built from a multi-node topology
+    size_t nodes() const { return nodes_.size(); }
+
+    // NORMAL tasks run on a node other than the one they were queued on
+    size_t stolen() const;
+
+    // Finish queued tasks and join all workers
+    void shutdown();
+
+private:
+    struct Node {
+        std::deque<Task> tasks;
+        std::condition_variable cv;
+        std::vector<int> cpus;   // Empty when unpinned
+        size_t idle = 0;         // Workers waiting on `cv`
+    };
+
+    void worker_loop(size_t node, bool high_only);
+
+    // Queue for a NORMAL task posted by the calling thread. Caller holds mutex_.
+    size_t posting_node();
+
+    // Wake an idle worker, preferring `node`. Caller holds mutex_.
+    void wake(size_t node);
+
+    CpuTopology topology_;
+    std::vector<std::unique_ptr<Node>> nodes_;
+    size_t next_node_;                 // Round-robin for unpinned callers
+
+    std::vector<std::thread> workers_;
+    std::deque<Task> high_tasks_;
+    mutable std::mutex mutex_;
+    std::condition_variable high_cv_;  // Wakes the reserved HIGH-only threads
+    size_t stolen_;
+    bool stopping_;
+};
+
+} // namespace utils
+} // namespace compressor
+
+#endif // COMPRESSOR_THREAD_POOL_HPP
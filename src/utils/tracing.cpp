@@ -0,0 +1,203 @@
+#include "utils/tracing.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+namespace compressor {
+namespace utils {
+
+std::atomic<bool> Tracer::enabled_{false};
+
+namespace {
+
+struct Event {
+    const char* name;
+    const char* category;
+    const char* arg_name;
+    uint64_t arg;
+    uint64_t start_ns;
+    uint64_t duration_ns;
+    uint32_t tid;
+};
+
+// One thread writes a buffer at a time; the lock is only contended while
+// a dump copies it out
+struct Buffer {
+    std::mutex mutex;
+    std::vector<Event> events;
+    size_t next = 0;
+    bool wrapped = false;
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Buffer>> buffers;
+    std::vector<Buffer*> free;  // Released by exited threads
+    std::unordered_map<uint32_t, std::string> thread_names;
+    size_t events_per_thread = Tracer::DEFAULT_EVENTS_PER_THREAD;
+    uint64_t epoch_ns = 0;      // Timestamps are written relative to this
+};
+
+// Never destroyed: thread_local destructors may run after static ones
+Registry& registry() {
+    static Registry* instance = new Registry();
+    return *instance;
+}
+
+uint32_t current_tid() {
+    return static_cast<uint32_t>(syscall(SYS_gettid));
+}
+
+struct ThreadSlot {
+    Buffer* buffer = nullptr;
+    uint32_t tid = 0;
+
+    ~ThreadSlot() {
+        if (buffer) {
+            Registry& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            reg.free.push_back(buffer);
+        }
+    }
+
+    Buffer& acquire() {
+        if (!buffer) {
+            tid = current_tid();
+            Registry& reg = registry();
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            if (!reg.free.empty()) {
+                buffer = reg.free.back();
+                reg.free.pop_back();
+            } else {
+                reg.buffers.push_back(std::make_unique<Buffer>());
+                buffer = reg.buffers.back().get();
+                buffer->events.resize(std::max<size_t>(1, reg.events_per_thread));
+            }
+        }
+        return *buffer;
+    }
+};
+
+thread_local ThreadSlot slot;
+
+void append_event(std::ostringstream& out, const Event& event, uint64_t epoch_ns, pid_t pid) {
+    uint64_t start = event.start_ns > epoch_ns ? event.start_ns - epoch_ns : 0;
+    out << "{\"name\":\"" << event.name << "\",\"cat\":\"" << event.category
+        << "\",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << event.tid
+        << ",\"ts\":" << start / 1000 << "." << std::setw(3) << std::setfill('0') << start % 1000
+        << ",\"dur\":" << event.duration_ns / 1000 << "." << std::setw(3) << std::setfill('0')
+        << event.duration_ns % 1000;
+    if (event.arg_name) {
+        out << ",\"args\":{\"" << event.arg_name << "\":" << event.arg << "}";
+    }
+    out << "}";
+}
+
+} // namespace
+
+uint64_t Tracer::now_ns() {
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    return ns > 0 ? static_cast<uint64_t>(ns) : 1;  // 0 marks a disabled span
+}
+
+void Tracer::enable(size_t events_per_thread) {
+    Registry& reg = registry();
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.events_per_thread = events_per_thread;
+        if (reg.epoch_ns == 0) {
+            reg.epoch_ns = now_ns();
+        }
+    }
+    enabled_.store(true, std::memory_order_relaxed);
+}
+
+void Tracer::disable() {
+    enabled_.store(false, std::memory_order_relaxed);
+}
+
+void Tracer::clear() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (auto& buffer : reg.buffers) {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+        buffer->next = 0;
+        buffer->wrapped = false;
+    }
+}
+
+void Tracer::set_thread_name(const std::string& name) {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.thread_names[current_tid()] = name;
+}
+
+void Tracer::record(const char* name, const char* category, uint64_t start_ns, uint64_t end_ns,
+                    const char* arg_name, uint64_t arg) {
+    Buffer& buffer = slot.acquire();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    buffer.events[buffer.next] = Event{name, category, arg_name, arg, start_ns,
+                                       end_ns > start_ns ? end_ns - start_ns : 0, slot.tid};
+    if (++buffer.next == buffer.events.size()) {
+        buffer.next = 0;
+        buffer.wrapped = true;
+    }
+}
+
+std::string Tracer::to_json() {
+    Registry& reg = registry();
+    pid_t pid = getpid();
+
+    std::vector<Event> events;
+    std::unordered_map<uint32_t, std::string> names;
+    uint64_t epoch_ns;
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        names = reg.thread_names;
+        epoch_ns = reg.epoch_ns;
+        for (auto& buffer : reg.buffers) {
+            std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+            if (buffer->wrapped) {
+                events.insert(events.end(), buffer->events.begin() + buffer->next, buffer->events.end());
+            }
+            events.insert(events.end(), buffer->events.begin(), buffer->events.begin() + buffer->next);
+        }
+    }
+
+    std::ostringstream out;
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto& entry : names) {
+        out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid
+            << ",\"tid\":" << entry.first << ",\"args\":{\"name\":\"" << entry.second << "\"}}";
+        first = false;
+    }
+    for (const auto& event : events) {
+        out << (first ? "" : ",") << "\n";
+        append_event(out, event, epoch_ns, pid);
+        first = false;
+    }
+    out << "\n]}\n";
+    return out.str();
+}
+
+bool Tracer::write(const std::string& path) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    file << to_json();
+    return file.good();
+}
+
+} // namespace utils
+} // namespace compressor
@@ -0,0 +1,88 @@
+#ifndef COMPRESSOR_TRACING_HPP
+#define COMPRESSOR_TRACING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace compressor {
+namespace utils {
+
+// Scoped timing spans written as Chrome trace-event JSON (load the output
+// in chrome://tracing or ui.perfetto.dev).
+//
+// Each thread appends to its own fixed-size ring buffer, so recording
+// never allocates after a thread's first span and the oldest events are
+// overwritten when a buffer is full. Buffers of exited threads are
+// recycled by new threads, which keeps memory bounded by the number of
+// threads alive at once. While tracing is disabled a span costs one
+// relaxed atomic load.
+//
+// Span names and categories must be string literals (or otherwise outlive
+// the tracer); only the pointers are stored.
+class Tracer {
+public:
+    static constexpr size_t DEFAULT_EVENTS_PER_THREAD = 16384;
+
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+    // Start recording. The buffer size applies to buffers created from now on.
+    static void enable(size_t events_per_thread = DEFAULT_EVENTS_PER_THREAD);
+    static void disable();
+
+    // Drop all recorded events
+    static void clear();
+
+    // Label the calling thread in the trace viewer
+    static void set_thread_name(const std::string& name);
+
+    // Recorded events as a Chrome trace-event JSON document
+    static std::string to_json();
+    static bool write(const std::string& path);
+
+private:
+    friend class TraceSpan;
+
+    static uint64_t now_ns();
+    static void record(const char* name, const char* category, uint64_t start_ns, uint64_t end_ns,
+                       const char* arg_name, uint64_t arg);
+
+    static std::atomic<bool> enabled_;
+};
+
+// Records the time between construction and destruction as one complete
+// ("X") event, if tracing was enabled at construction.
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name, const char* category = "codec")
+        : name_(name), category_(category), arg_name_(nullptr), arg_(0)
+        , start_ns_(Tracer::enabled() ? Tracer::now_ns() : 0) {}
+
+    ~TraceSpan() {
+        if (start_ns_ != 0) {
+            Tracer::record(name_, category_, start_ns_, Tracer::now_ns(), arg_name_, arg_);
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    // Attach one numeric argument, e.g. a byte count or block index
+    void arg(const char* name, uint64_t value) {
+        arg_name_ = name;
+        arg_ = value;
+    }
+
+private:
+    const char* name_;
+    const char* category_;
+    const char* arg_name_;
+    uint64_t arg_;
+    uint64_t start_ns_;
+};
+
+} // namespace utils
+} // namespace compressor
+
+#endif // COMPRESSOR_TRACING_HPP
@@ -8,54 +8,108 @@
 #include <regex>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
 #include <cstdlib>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <unistd.h>
 #include <signal.h>
+#include <poll.h>
+#include <atomic>
+#include <fcntl.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
 
 #include "core/algorithm.hpp"
+#include "algorithms/custom_hybrid/hybrid_algorithm.hpp"
+#include "algorithms/integer/integer_algorithm.hpp"
+#include "utils/base64.hpp"
+#include "utils/cpu_features.hpp"
+#include "utils/cpu_topology.hpp"
 #include "utils/crc.hpp"
+#include "utils/dictionary.hpp"
+#include "utils/hash.hpp"
+#include "utils/kernels.hpp"
+#include "utils/tracing.hpp"
+#include "server/metrics.hpp"
+#include "server/result_cache.hpp"
+#include "server/server_config.hpp"
+#include "server/admission.hpp"
+#include "server/http.hpp"
+#include "server/batch.hpp"
+#include "server/ipc_service.hpp"
+#include "server/benchmark_service.hpp"
+#include "server/codec_pool.hpp"
+#include "server/gzip_encoding.hpp"
+#include "server/job_manager.hpp"
+#include "server/prefork.hpp"
+#include "server/trace_recorder.hpp"
+#include "server/verifier.hpp"
+#include "utils/thread_pool.hpp"
 
-// Base64 encoding function
-std::string base64Encode(const std::vector<uint8_t>& data) {
-    const std::string chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-    std::string result;
-    int val = 0, valb = -6;
-    for (auto c : data) {
-        val = (val << 8) + c;
-        valb += 8;
-        while (valb >= 0) {
-            result.push_back(chars[(val >> valb) & 0x3F]);
-            valb -= 6;
-        }
-    }
-    if (valb > -6) result.push_back(chars[((val << 8) >> (valb + 8)) & 0x3F]);
-    while (result.size() % 4) result.push_back('=');
-    return result;
-}
+using compressor::server::Metrics;
+using compressor::server::ErrorType;
+using compressor::server::GaugeGuard;
+using compressor::server::Http;
+
+// Raised by SIGTERM/SIGINT; the accept loop polls it
+static volatile std::sig_atomic_t stopRequested = 0;
 
 class WebServer {
 private:
     int server_fd;
     bool running;
+    std::atomic<size_t> openConnections;
+    compressor::server::ServerConfig config;
+    compressor::server::ResultCache cache;
+    compressor::server::AdmissionController admission;
+    compressor::utils::ThreadPool workers;
+    // Two warm instances per worker: one codes, one verifies the result
+    compressor::server::CodecPool codecs;
+    compressor::server::JobManager jobs;
+    compressor::server::Verifier verifier;
+    compressor::server::BatchProcessor batches;
+    compressor::server::BenchmarkService benchmarks;
+    compressor::server::TraceRecorder trace;
+    compressor::server::IpcService ipc;
+    
+    // Benchmark runs allowed to be queued or running at once
+    static constexpr size_t MAX_ACTIVE_BENCHMARKS = 4;
+    
+    // Peak memory of a codec request relative to its body: the raw request,
+    // extracted payload, codec output, verification copy and base64 response
+    static constexpr size_t REQUEST_MEMORY_FACTOR = 8;
     
 public:
-    WebServer() : server_fd(-1), running(false) {}
+    explicit WebServer(const compressor::server::ServerConfig& cfg)
+        : server_fd(-1), running(false), openConnections(0), config(cfg), cache(cfg.cache_max_bytes)
+        , admission(cfg.admission), workers(cfg.worker_threads, cfg.admission.reserved_small,
+                  cfg.numa_pool ? compressor::utils::CpuTopology::detect() : compressor::utils::CpuTopology())
+        , codecs(cfg.worker_threads * 2)
+        , jobs(workers, codecs, cfg.spool_dir, cfg.job_ttl, cfg.job_block_size)
+        , verifier(cfg.verification, workers, codecs), batches(workers, codecs, verifier)
+        , benchmarks(cfg.benchmark_threads, MAX_ACTIVE_BENCHMARKS, cfg.job_ttl)
+        , trace(cfg.trace_file, cfg.trace_sample_rate), ipc(codecs, admission) {}
     
     ~WebServer() {
         stop();
+        // Let queued jobs finish while the job manager is still alive
+        workers.shutdown();
     }
     
-    bool start(int port = 8080) {
+    // `primary` is false for pre-forked workers after the first; only the
+    // primary serves the IPC socket, which cannot be shared like the port
+    bool start(int port = 8080, bool primary = true) {
         server_fd = socket(AF_INET, SOCK_STREAM, 0);
-        if (server_fd == 0) {
+        if (server_fd < 0) {
             std::cerr << "Error creating socket" << std::endl;
             return false;
         }
         
+        // SO_REUSEPORT lets every pre-forked worker bind its own listener
         int opt = 1;
-        if (setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR | SO_REUSEPORT, &opt, sizeof(opt))) {
+        if (setsockopt(server_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) ||
+            setsockopt(server_fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt))) {
             std::cerr << "Error configuring socket" << std::endl;
             return false;
         }
@@ -70,25 +124,86 @@ public:
             return false;
         }
         
-        if (listen(server_fd, 3) < 0) {
+        if (listen(server_fd, SOMAXCONN) < 0) {
             std::cerr << "Error listening" << std::endl;
             return false;
         }
         
+        if (primary && !config.ipc_socket.empty() && !ipc.start(config.ipc_socket)) {
+            return false;
+        }
+        
         running = true;
-        std::cout << "Server started on port " << port << std::endl;
+        std::cout << "Server started on port " << port << " (pid " << getpid() << ")" << std::endl;
         std::cout << "Access: http://localhost:" << port << std::endl;
+        if (workers.nodes() > 1) {
+            std::cout << "Worker pool: " << workers.size() << " threads across " << workers.nodes()
+                      << " NUMA nodes" << std::endl;
+        }
         
         return true;
     }
     
     std::string handleAlgorithmsList() {
-        std::string jsonResponse = R"({"algorithms": ["lz77", "huffman", "rle"]})";
-        return createCORSResponse("200 OK", "application/json", jsonResponse);
+        std::ostringstream json;
+        json << "{\"algorithms\": [";
+        const auto& algorithms = codecs.algorithms();
+        for (size_t i = 0; i < algorithms.size(); ++i) {
+            const auto& info = algorithms[i];
+            json << (i > 0 ? "," : "") << "{";
+            json << "\"name\": \"" << Http::json_escape(info.name) << "\",";
+            json << "\"description\": \"" << Http::json_escape(info.description) << "\",";
+            json << "\"supports_parallel\": " << (info.supports_parallel ? "true" : "false") << ",";
+            json << "\"min_block_size\": " << info.min_block_size;
+            json << "}";
+        }
+        json << "]}";
+        return createCORSResponse("200 OK", "application/json", json.str());
+    }
+    
+    std::string handleDictionariesList() {
+        std::ostringstream json;
+        json << "{\"dictionaries\": [";
+        auto dictionaries = compressor::utils::DictionaryRegistry::instance().list();
+        for (size_t i = 0; i < dictionaries.size(); ++i) {
+            json << (i > 0 ? "," : "") << "{";
+            json << "\"id\": \"" << dictionaries[i]->id_string() << "\",";
+            json << "\"size\": " << dictionaries[i]->content().size();
+            json << "}";
+        }
+        json << "]}";
+        return createCORSResponse("200 OK", "application/json", json.str());
+    }
+    
+    // An empty value selects no dictionary; otherwise it must name a loaded one
+    bool resolveDictionary(const std::string& value, uint32_t& dictionaryId) {
+        dictionaryId = compressor::utils::Dictionary::NONE;
+        if (value.empty()) {
+            return true;
+        }
+        try {
+            dictionaryId = compressor::utils::Dictionary::parse_id(value);
+        } catch (const std::invalid_argument&) {
+            return false;
+        }
+        return compressor::utils::DictionaryRegistry::instance().find(dictionaryId) != nullptr;
+    }
+    
+    std::string handleMetrics() {
+        std::string body = Metrics::instance().to_prometheus() + cache.to_prometheus() +
+                           admission.to_prometheus() + verifier.to_prometheus() +
+                           codecs.to_prometheus() + ipc.to_prometheus();
+        return createCORSResponse("200 OK", "text/plain; version=0.0.4", body);
     }
     
     void run() {
-        while (running) {
+        while (running && !stopRequested) {
+            // Wake periodically so a stop request is noticed promptly
+            struct pollfd listener = {server_fd, POLLIN, 0};
+            if (poll(&listener, 1, 250) <= 0) {
+                continue;
+            }
+            
             struct sockaddr_in address;
             int addrlen = sizeof(address);
             int new_socket = accept(server_fd, (struct sockaddr *)&address, (socklen_t*)&addrlen);
@@ -100,12 +215,34 @@ public:
                 continue;
             }
             
-            std::thread(&WebServer::handleRequest, this, new_socket).detach();
+            openConnections.fetch_add(1);
+            std::thread([this, new_socket]() {
+                handleRequest(new_socket);
+                openConnections.fetch_sub(1);
+            }).detach();
         }
     }
     
+    // Stop accepting and wait for in-flight requests and background jobs.
+    // Returns false if work was still running at the deadline.
+    bool drain(std::chrono::seconds timeout) {
+        stop();
+        
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (openConnections.load() > 0 || jobs.active_jobs() > 0 || benchmarks.active() > 0) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                std::cout << "Drain deadline reached with " << openConnections.load() << " connections and "
+                          << jobs.active_jobs() << " jobs still running" << std::endl;
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        return true;
+    }
+    
     void stop() {
         running = false;
+        ipc.stop();
         if (server_fd != -1) {
             close(server_fd);
             server_fd = -1;
@@ -114,10 +251,17 @@ public:
     
 private:
     void handleRequest(int socket) {
+        GaugeGuard connection(&Metrics::connection_opened, &Metrics::connection_closed);
+        compressor::utils::TraceSpan requestSpan("http.request", "server");
+        auto arrival = std::chrono::system_clock::now();
+        auto started = std::chrono::steady_clock::now();
+        
         std::string request;
         char buffer[8192];
         ssize_t totalBytesRead = 0;
-        int contentLength = 0;
+        size_t contentLength = 0;
+        compressor::server::AdmissionTicket ticket;
+        std::string method, path, version;
         
         // First, read headers to get Content-Length
         while (true) {
@@ -131,23 +275,65 @@ private:
             // Check if we have complete headers
             size_t headerEnd = request.find("\r\n\r\n");
             if (headerEnd != std::string::npos) {
-                // Extract Content-Length
-                size_t clPos = request.find("Content-Length: ");
-                if (clPos != std::string::npos) {
-                    clPos += 16; // Length of "Content-Length: "
-                    size_t clEnd = request.find("\r\n", clPos);
-                    if (clEnd != std::string::npos) {
-                        contentLength = std::stoi(request.substr(clPos, clEnd - clPos));
+                // Extract Content-Length; the limits below bound its value
+                std::string lengthHeader = Http::header_value(request, "Content-Length");
+                if (!lengthHeader.empty() && !Http::parse_content_length(lengthHeader, contentLength)) {
+                    Metrics::instance().record_error(ErrorType::BAD_REQUEST);
+                    std::string rejection = createCORSResponse("400 Bad Request", "application/json",
+                        "{\"error\":\"Invalid Content-Length\"}");
+                    Http::send_all(socket, rejection.data(), rejection.size());
+                    close(socket);
+                    return;
+                }
+                
+                // Decide on codec requests before buffering their bodies
+                std::istringstream requestLine(request.substr(0, headerEnd));
+                requestLine >> method >> path >> version;
+                
+                // Job uploads are streamed to disk instead of buffered
+                Http::QueryParams query;
+                std::string route = Http::split_target(path, query);
+                if (!config.async_endpoints && isAsyncRoute(route)) {
+                    Metrics::instance().record_error(ErrorType::NOT_FOUND);
+                    std::string disabled = createCORSResponse("404 Not Found", "application/json",
+                        "{\"error\":\"Jobs, uploads and benchmark runs are disabled (--no-async)\"}");
+                    Http::send_all(socket, disabled.data(), disabled.size());
+                    close(socket);
+                    return;
+                }
+                if (method == "POST" && route == "/jobs") {
+                    std::cout << method << " " << path << std::endl;
+                    handleJobUpload(socket, request.substr(headerEnd + 4), contentLength, query);
+                    close(socket);
+                    return;
+                }
+                
+                // Every other body is buffered in memory, whatever the route
+                if (contentLength > config.max_request_bytes) {
+                    Metrics::instance().record_error(ErrorType::PAYLOAD_TOO_LARGE);
+                    std::string rejection = createCORSResponse("413 Payload Too Large", "application/json",
+                        "{\"error\":\"Request body exceeds " + std::to_string(config.max_request_bytes) + " bytes\"}");
+                    Http::send_all(socket, rejection.data(), rejection.size());
+                    close(socket);
+                    return;
+                }
+                
+                if (isCodecRequest(method, route)) {
+                    std::string rejection = admitCodecRequest(contentLength, ticket);
+                    if (!rejection.empty()) {
+                        Http::send_all(socket, rejection.data(), rejection.size());
+                        close(socket);
+                        return;
                     }
                 }
                 
                 // Calculate how much body we have
-                int headerSize = headerEnd + 4;
-                int bodyReceived = totalBytesRead - headerSize;
+                size_t headerSize = headerEnd + 4;
+                size_t bodyReceived = totalBytesRead - headerSize;
                 
                 // Read remaining body if needed
                 while (bodyReceived < contentLength) {
-                    bytesRead = read(socket, buffer, std::min(sizeof(buffer) - 1, (size_t)(contentLength - bodyReceived)));
+                    bytesRead = read(socket, buffer, std::min(sizeof(buffer) - 1, contentLength - bodyReceived));
                     if (bytesRead <= 0) break;
                     
                     buffer[bytesRead] = '\0';
@@ -160,39 +346,418 @@ private:
             // Safety check - don't read too much
             if (totalBytesRead > 20 * 1024 * 1024) break; // 20MB limit
         }
-        std::string response;
         
-        // Parse HTTP request
-        std::istringstream iss(request);
-        std::string method, path, version;
-        iss >> method >> path >> version;
+        GaugeGuard inFlight(&Metrics::request_started, &Metrics::request_finished);
+        std::string response;
+        requestSpan.arg("bytes", request.size());
         
         std::cout << method << " " << path << std::endl;
         
+        Http::QueryParams query;
+        std::string route = Http::split_target(path, query);
+        std::vector<std::string> segments = Http::path_segments(route);
+        
         if (method == "GET") {
-            if (path == "/algorithms") {
+            if (route == "/algorithms") {
                 response = handleAlgorithmsList();
+            } else if (route == "/metrics") {
+                response = handleMetrics();
+            } else if (route == "/dictionaries") {
+                response = handleDictionariesList();
+            } else if (route == "/debug/trace" && compressor::utils::Tracer::enabled()) {
+                response = createCORSResponse("200 OK", "application/json", compressor::utils::Tracer::to_json());
+            } else if (segments.size() == 2 && segments[0] == "benchmark") {
+                response = handleBenchmarkStatus(segments[1]);
+            } else if (segments.size() == 2 && segments[0] == "jobs") {
+                response = handleJobStatus(segments[1]);
+            } else if (segments.size() == 2 && segments[0] == "uploads") {
+                response = handleUploadStatus(segments[1]);
+            } else if (segments.size() == 3 && segments[0] == "jobs" && segments[2] == "result") {
+                response = sendJobResult(socket, segments[1]);
+                if (response.empty()) {
+                    close(socket);
+                    return;
+                }
             } else if (path == "/" || path.find(".html") != std::string::npos ||
                 path.find(".js") != std::string::npos || path.find(".css") != std::string::npos) {
                 response = serveStaticFile(path);
             } else {
+                Metrics::instance().record_error(ErrorType::NOT_FOUND);
                 response = createCORSResponse("404 Not Found", "text/plain", "Not Found");
             }
-        } else if (method == "POST" && path == "/compress") {
+        } else if (method == "POST" && route == "/compress") {
             response = handleCompression(request);
-        } else if (method == "POST" && path == "/decompress") {
-            response = handleDecompression(request);
+        } else if (method == "POST" && route == "/decompress") {
+            response = handleDecompression(request, query);
+        } else if (method == "POST" && route == "/batch") {
+            response = handleBatch(request, query);
+        } else if (method == "POST" && route == "/benchmark") {
+            response = handleBenchmark(request, query);
+        } else if (method == "POST" && route == "/uploads") {
+            response = handleUploadCreate(query);
+        } else if (method == "POST" && segments.size() == 3 && segments[0] == "uploads" && segments[2] == "commit") {
+            response = handleUploadCommit(segments[1]);
+        } else if (method == "PUT" && segments.size() == 4 && segments[0] == "uploads" && segments[2] == "chunks") {
+            response = handleUploadChunk(request, contentLength, segments[1], segments[3]);
         } else if (method == "OPTIONS") {
             // Handle CORS preflight request
             response = createCORSResponse("200 OK", "text/plain", "OK");
         } else {
+            Metrics::instance().record_error(ErrorType::METHOD_NOT_ALLOWED);
             response = createCORSResponse("405 Method Not Allowed", "text/plain", "Method Not Allowed");
         }
         
-        send(socket, response.c_str(), response.length(), 0);
+        if (trace.enabled() && isCodecRequest(method, route)) {
+            recordTrace(request, method, path, route, response, arrival, started);
+        }
+        
+        // Free the admission budget before the (possibly slow) send
+        std::string acceptEncoding = Http::header_value(request, "Accept-Encoding");
+        request.clear();
+        request.shrink_to_fit();
+        ticket.release();
+        
+        compressor::utils::TraceSpan sendSpan("http.send", "server");
+        sendSpan.arg("bytes", response.size());
+        sendResponse(socket, response, acceptEncoding, version == "HTTP/1.1");
         close(socket);
     }
     
+    void recordTrace(const std::string& request, const std::string& method, const std::string& path,
+                     const std::string& route, const std::string& response,
+                     std::chrono::system_clock::time_point arrival, std::chrono::steady_clock::time_point started) {
+        compressor::server::TraceRecord record;
+        record.method = method;
+        record.endpoint = route;
+        size_t queryStart = path.find('?');
+        record.query = queryStart == std::string::npos ? "" : path.substr(queryStart + 1);
+        record.content_type = Http::header_value(request, "Content-Type");
+        
+        Http::QueryParams query;
+        Http::split_target(path, query);
+        auto algoIt = query.find("algorithm");
+        if (algoIt != query.end()) {
+            record.algorithm = algoIt->second;
+        } else if (record.content_type.find("multipart/") != std::string::npos) {
+            record.algorithm = extractFormField(request, "algorithm");
+        }
+        
+        size_t headerEnd = request.find("\r\n\r\n");
+        size_t bodyStart = headerEnd == std::string::npos ? request.size() : headerEnd + 4;
+        record.size = request.size() - bodyStart;
+        record.status = response.size() > 12 ? std::atoi(response.c_str() + 9) : 0;
+        record.latency_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+        
+        trace.record(record, arrival, reinterpret_cast<const uint8_t*>(request.data()) + bodyStart, record.size);
+    }
+    
+    // Send a complete response, gzip-encoding its body when the client
+    // accepts it and the body is large and compressible enough. The gzip
+    // body is chunked, which only HTTP/1.1 clients can parse.
+    void sendResponse(int socket, const std::string& response, const std::string& acceptEncoding,
+                      bool chunkedAllowed) {
+        size_t headerEnd = response.find("\r\n\r\n");
+        size_t bodySize = headerEnd == std::string::npos ? 0 : response.size() - headerEnd - 4;
+        
+        if (chunkedAllowed && config.gzip_level > 0 && bodySize >= config.gzip_min_bytes &&
+            compressor::server::GzipEncoding::available() &&
+            compressor::server::GzipEncoding::accepted(acceptEncoding) &&
+            compressor::server::GzipEncoding::compressible(Http::header_value(response, "Content-Type"))) {
+            // The compressed size is not known up front, so use chunked framing
+            std::string headers = response.substr(0, headerEnd + 2);
+            size_t lengthPos = headers.find("Content-Length: ");
+            if (lengthPos != std::string::npos) {
+                headers.erase(lengthPos, headers.find("\r\n", lengthPos) + 2 - lengthPos);
+            }
+            headers += "Content-Encoding: gzip\r\nVary: Accept-Encoding\r\nTransfer-Encoding: chunked\r\n\r\n";
+            
+            if (Http::send_all(socket, headers.data(), headers.size())) {
+                compressor::server::GzipEncoding::send_chunked(socket, response.data() + headerEnd + 4, bodySize,
+                                                               config.gzip_level);
+            }
+            return;
+        }
+        
+        Http::send_all(socket, response.data(), response.size());
+    }
+    
+    // POST /jobs?algorithm=<name>[&operation=compress|decompress]
+    // The raw request body is the job input; `bodyPrefix` holds the part
+    // already read together with the headers.
+    void handleJobUpload(int socket, const std::string& bodyPrefix, size_t contentLength,
+                         const Http::QueryParams& query) {
+        GaugeGuard inFlight(&Metrics::request_started, &Metrics::request_finished);
+        std::string response;
+        
+        auto algoIt = query.find("algorithm");
+        auto opIt = query.find("operation");
+        std::string operation = opIt != query.end() ? opIt->second : "compress";
+        std::string algorithm = algoIt != query.end() ? algoIt->second : "";
+        
+        if (operation != "compress" && operation != "decompress") {
+            Metrics::instance().record_error(ErrorType::BAD_REQUEST);
+            response = createCORSResponse("400 Bad Request", "application/json",
+                "{\"error\":\"operation must be compress or decompress\"}");
+        } else if (operation == "compress" && !compressor::AlgorithmFactory::is_available(algorithm)) {
+            Metrics::instance().record_error(ErrorType::INVALID_ALGORITHM);
+            response = createCORSResponse("400 Bad Request", "application/json",
+                "{\"error\":\"Invalid algorithm: " + Http::json_escape(algorithm) + "\"}");
+        } else if (contentLength == 0) {
+            Metrics::instance().record_error(ErrorType::BAD_REQUEST);
+            response = createCORSResponse("400 Bad Request", "application/json",
+                "{\"error\":\"Job input is empty\"}");
+        } else if (contentLength > config.max_job_bytes) {
+            Metrics::instance().record_error(ErrorType::PAYLOAD_TOO_LARGE);
+            response = createCORSResponse("413 Payload Too Large", "application/json",
+                "{\"error\":\"Job input exceeds " + std::to_string(config.max_job_bytes) + " bytes\"}");
+        } else {
+            auto op = operation == "compress" ? compressor::server::JobOperation::COMPRESS
+                                              : compressor::server::JobOperation::DECOMPRESS;
+            std::string id = jobs.create(op, algorithm);
+            
+            if (spoolJobInput(socket, jobs.input_path(id), bodyPrefix, contentLength) &&
+                jobs.start(id, contentLength)) {
+                response = createCORSResponse("202 Accepted", "application/json",
+                    "{\"id\":\"" + id + "\",\"status_url\":\"/jobs/" + id +
+                    "\",\"result_url\":\"/jobs/" + id + "/result\"}",
+                    "Location: /jobs/" + id + "\r\n");
+            } else {
+                jobs.abandon(id);
+                Metrics::instance().record_error(ErrorType::INTERNAL);
+                response = createCORSResponse("500 Internal Server Error", "application/json",
+                    "{\"error\":\"Failed to receive job input\"}");
+            }
+        }
+        
+        Http::send_all(socket, response.data(), response.size());
+    }
+    
+    bool spoolJobInput(int socket, const std::string& filePath, const std::string& bodyPrefix,
+                       size_t contentLength) {
+        std::ofstream out(filePath, std::ios::binary);
+        if (!out) {
+            return false;
+        }
+        
+        size_t received = std::min(bodyPrefix.size(), contentLength);
+        out.write(bodyPrefix.data(), received);
+        
+        std::vector<char> buffer(256 * 1024);
+        while (received < contentLength && out) {
+            ssize_t bytesRead = read(socket, buffer.data(), std::min(buffer.size(), contentLength - received));
+            if (bytesRead <= 0) {
+                return false;
+            }
+            out.write(buffer.data(), bytesRead);
+            received += bytesRead;
+        }
+        
+        out.flush();
+        return static_cast<bool>(out);
+    }
+    
+    std::string handleJobStatus(const std::string& id) {
+        compressor::server::JobInfo info;
+        if (!jobs.get(id, info)) {
+            Metrics::instance().record_error(ErrorType::NOT_FOUND);
+            return createCORSResponse("404 Not Found", "application/json", "{\"error\":\"Unknown job\"}");
+        }
+        return createCORSResponse("200 OK", "application/json", info.to_json());
+    }
+    
+    // POST /uploads?algorithm=<name>&size=<total bytes> opens a chunked
+    // upload; the input is then sent as PUT /uploads/{id}/chunks/{index}
+    std::string handleUploadCreate(const Http::QueryParams& query) {
+        auto algoIt = query.find("algorithm");
+        auto sizeIt = query.find("size");
+        std::string algorithm = algoIt != query.end() ? algoIt->second : "";
+        
+        size_t totalSize = 0;
+        try {
+            totalSize = sizeIt != query.end() ? std::stoull(sizeIt->second) : 0;
+        } catch (const std::exception&) {
+            totalSize = 0;
+        }
+        
+        if (!compressor::AlgorithmFactory::is_available(algorithm)) {
+            Metrics::instance().record_error(ErrorType::INVALID_ALGORITHM);
+            return createCORSResponse("400 Bad Request", "application/json",
+                "{\"error\":\"Invalid algorithm: " + Http::json_escape(algorithm) + "\"}");
+        }
+        if (totalSize == 0) {
+            Metrics::instance().record_error(ErrorType::BAD_REQUEST);
+            return createCORSResponse("400 Bad Request", "application/json",
+                "{\"error\":\"size must be a positive byte count\"}");
+        }
+        if (totalSize > config.max_job_bytes) {
+            Metrics::instance().record_error(ErrorType::PAYLOAD_TOO_LARGE);
+            return createCORSResponse("413 Payload Too Large", "application/json",
+                "{\"error\":\"Upload exceeds " + std::to_string(config.max_job_bytes) + " bytes\"}");
+        }
+        
+        std::string id = jobs.create_upload(algorithm, totalSize);
+        return createCORSResponse("201 Created", "application/json",
+            "{\"id\":\"" + id + "\",\"chunk_size\":" + std::to_string(jobs.chunk_size()) +
+            ",\"chunk_count\":" + std::to_string(jobs.chunk_count(totalSize)) +
+            ",\"status_url\":\"/uploads/" + id + "\",\"result_url\":\"/jobs/" + id + "/result\"}",
+            "Location: /uploads/" + id + "\r\n");
+    }
+    
+    std::string handleUploadChunk(const std::string& request, size_t contentLength, const std::string& id,
+                                  const std::string& indexText) {
+        size_t headerEnd = request.find("\r\n\r\n");
+        size_t index = 0;
+        try {
+            size_t parsed = 0;
+            index = std::stoull(indexText, &parsed);
+            if (parsed != indexText.size()) throw std::invalid_argument(indexText);
+        } catch (const std::exception&) {
+            Metrics::instance().record_error(ErrorType::BAD_REQUEST);
+            return createCORSResponse("400 Bad Request", "application/json", "{\"error\":\"Invalid chunk index\"}");
+        }
+        if (headerEnd == std::string::npos || request.size() - headerEnd - 4 != contentLength) {
+            Metrics::instance().record_error(ErrorType::BAD_REQUEST);
+            return createCORSResponse("400 Bad Request", "application/json", "{\"error\":\"Incomplete chunk\"}");
+        }
+        
+        size_t compressedSize = 0;
+        std::string error;
+        auto status = jobs.put_chunk(id, index, reinterpret_cast<const uint8_t*>(request.data() + headerEnd + 4),
+                                     contentLength, compressedSize, error);
+        
+        switch (status) {
+            case compressor::server::ChunkStatus::STORED:
+                return createCORSResponse("200 OK", "application/json",
+                    "{\"index\":" + std::to_string(index) + ",\"size\":" + std::to_string(contentLength) +
+                    ",\"compressed_size\":" + std::to_string(compressedSize) + "}");
+            case compressor::server::ChunkStatus::NOT_FOUND:
+                Metrics::instance().record_error(ErrorType::NOT_FOUND);
+                return createCORSResponse("404 Not Found", "application/json",
+                    "{\"error\":\"" + Http::json_escape(error) + "\"}");
+            case compressor::server::ChunkStatus::INVALID:
+                Metrics::instance().record_error(ErrorType::BAD_REQUEST);
+                return createCORSResponse("400 Bad Request", "application/json",
+                    "{\"error\":\"" + Http::json_escape(error) + "\"}");
+            case compressor::server::ChunkStatus::CONFLICT:
+                return createCORSResponse("409 Conflict", "application/json",
+                    "{\"error\":\"" + Http::json_escape(error) + "\"}");
+            case compressor::server::ChunkStatus::FAILED:
+                break;
+        }
+        Metrics::instance().record_error(ErrorType::COMPRESSION_FAILED);
+        return createCORSResponse("500 Internal Server Error", "application/json",
+            "{\"error\":\"" + Http::json_escape(error) + "\"}");
+    }
+    
+    // Job status plus the chunks still missing while the upload is open
+    std::string handleUploadStatus(const std::string& id) {
+        compressor::server::JobInfo info;
+        if (!jobs.get(id, info)) {
+            Metrics::instance().record_error(ErrorType::NOT_FOUND);
+            return createCORSResponse("404 Not Found", "application/json", "{\"error\":\"Unknown upload\"}");
+        }
+        
+        std::string body = info.to_json();
+        std::vector<size_t> missing;
+        if (jobs.missing_chunks(id, missing)) {
+            body.pop_back();
+            body += ",\"chunk_size\": " + std::to_string(jobs.chunk_size()) + ",\"missing_chunks\": [";
+            for (size_t i = 0; i < missing.size(); ++i) {
+                body += (i > 0 ? "," : "") + std::to_string(missing[i]);
+            }
+            body += "]}";
+        }
+        return createCORSResponse("200 OK", "application/json", body);
+    }
+    
+    std::string handleUploadCommit(const std::string& id) {
+        std::string error;
+        if (!jobs.commit_upload(id, error)) {
+            std::vector<size_t> missing;
+            if (!jobs.missing_chunks(id, missing)) {
+                Metrics::instance().record_error(ErrorType::NOT_FOUND);
+                return createCORSResponse("404 Not Found", "application/json", "{\"error\":\"Unknown upload\"}");
+            }
+            return createCORSResponse("409 Conflict", "application/json",
+                "{\"error\":\"" + Http::json_escape(error) + "\"}");
+        }
+        
+        return createCORSResponse("202 Accepted", "application/json",
+            "{\"id\":\"" + id + "\",\"status_url\":\"/jobs/" + id +
+            "\",\"result_url\":\"/jobs/" + id + "/result\"}",
+            "Location: /jobs/" + id + "\r\n");
+    }
+    
+    // Streams a finished job's output straight from the spool file. Returns
+    // an error response, or an empty string once the result has been sent.
+    std::string sendJobResult(int socket, const std::string& id) {
+        compressor::server::JobInfo info;
+        if (!jobs.get(id, info)) {
+            Metrics::instance().record_error(ErrorType::NOT_FOUND);
+            return createCORSResponse("404 Not Found", "application/json", "{\"error\":\"Unknown job\"}");
+        }
+        if (info.state != compressor::server::JobState::COMPLETED) {
+            return createCORSResponse("409 Conflict", "application/json",
+                "{\"error\":\"Job is " + std::string(compressor::server::JobManager::state_name(info.state)) +
+                "\",\"job\":" + info.to_json() + "}");
+        }
+        
+        int fd = open(jobs.output_path(id).c_str(), O_RDONLY);
+        struct stat st;
+        if (fd < 0 || fstat(fd, &st) != 0) {
+            if (fd >= 0) close(fd);
+            Metrics::instance().record_error(ErrorType::NOT_FOUND);
+            return createCORSResponse("404 Not Found", "application/json", "{\"error\":\"Job result expired\"}");
+        }
+        
+        std::string fileName = id + (info.operation == compressor::server::JobOperation::COMPRESS ? ".cblk" : ".bin");
+        std::string headers = createCORSHeaders("200 OK", "application/octet-stream", st.st_size,
+            "Content-Disposition: attachment; filename=\"" + fileName + "\"\r\n");
+        
+        if (Http::send_all(socket, headers.data(), headers.size())) {
+            off_t offset = 0;
+            while (offset < st.st_size) {
+                ssize_t sent = sendfile(socket, fd, &offset, st.st_size - offset);
+                if (sent <= 0) break;
+            }
+        }
+        close(fd);
+        return "";
+    }
+    
+    // Endpoints whose state (jobs, uploads, benchmark runs) lives in this
+    // process and is addressed by id in follow-up requests
+    static bool isAsyncRoute(const std::string& path) {
+        std::vector<std::string> segments = Http::path_segments(path);
+        return !segments.empty() &&
+               (segments[0] == "jobs" || segments[0] == "uploads" || segments[0] == "benchmark");
+    }
+    
+    static bool isCodecRequest(const std::string& method, const std::string& path) {
+        if (method == "PUT") {
+            return path.compare(0, 9, "/uploads/") == 0;
+        }
+        return method == "POST" && (path == "/compress" || path == "/decompress" || path == "/batch" ||
+                                    path == "/benchmark");
+    }
+    
+    // Returns an error response if the request must be refused, otherwise
+    // leaves an admitted ticket that is held until the response is built.
+    // Bodies above max_request_bytes have already been refused.
+    std::string admitCodecRequest(size_t contentLength, compressor::server::AdmissionTicket& ticket) {
+        ticket = admission.admit(contentLength * REQUEST_MEMORY_FACTOR, admission.classify(contentLength));
+        if (ticket.admitted()) {
+            return "";
+        }
+        
+        Metrics::instance().record_error(ErrorType::OVERLOADED);
+        std::string reason = ticket.status() == compressor::server::AdmissionStatus::QUEUE_FULL
+            ? "Server busy: admission queue full" : "Server busy: timed out waiting for capacity";
+        return createCORSResponse("503 Service Unavailable", "application/json",
+            "{\"error\":\"" + reason + "\"}",
+            "Retry-After: " + std::to_string(config.retry_after_seconds) + "\r\n");
+    }
+    
     std::string serveStaticFile(std::string path) {
         if (path == "/") path = "/index.html";
         
@@ -216,6 +781,7 @@ private:
     }
     
     std::string handleCompression(const std::string& request) {
+        compressor::utils::TraceSpan span("http.compress", "server");
         try {
             std::cout << "Processing compression request..." << std::endl;
             
@@ -230,6 +796,7 @@ private:
             size_t boundaryPos = request.find("boundary=");
             if (boundaryPos == std::string::npos) {
                 std::cout << "Boundary not found in request" << std::endl;
+                Metrics::instance().record_error(ErrorType::BAD_REQUEST);
                 return createCORSResponse("400 Bad Request", "application/json", 
                     "{\"error\":\"Boundary not found\"}");
             }
@@ -265,79 +832,278 @@ private:
             
             // Extract file data and algorithm
             std::string algorithm = extractFormField(request, "algorithm");
-            std::vector<uint8_t> fileData = extractFileData(request, boundary);
+            compressor::ByteVector fileData = extractFileData(request, boundary);
             
             std::cout << "Algorithm extracted: [" << algorithm << "]" << std::endl;
             std::cout << "File data size: " << fileData.size() << " bytes" << std::endl;
             
             if (algorithm.empty()) {
                 std::cout << "Algorithm field is empty" << std::endl;
+                Metrics::instance().record_error(ErrorType::BAD_REQUEST);
                 return createCORSResponse("400 Bad Request", "application/json", 
                     "{\"error\":\"Algorithm field not found or empty\"}");
             }
             
             if (fileData.empty()) {
+                Metrics::instance().record_error(ErrorType::BAD_REQUEST);
                 return createCORSResponse("400 Bad Request", "application/json", 
                     "{\"error\":\"File not found\"}");
             }
             
-            // Compress using selected algorithm
-            auto compressor = compressor::AlgorithmFactory::create(algorithm);
-            if (!compressor) {
+            if (!compressor::AlgorithmFactory::is_available(algorithm)) {
+                Metrics::instance().record_error(ErrorType::INVALID_ALGORITHM);
                 return createCORSResponse("400 Bad Request", "application/json", 
                     "{\"error\":\"Invalid algorithm\"}");
             }
             
-            auto start = std::chrono::high_resolution_clock::now();
-            auto result = compressor->compress(fileData);
-            auto end = std::chrono::high_resolution_clock::now();
+            std::string dictionary = extractFormField(request, "dictionary");
+            compressor::CompressionConfig config;
+            if (!resolveDictionary(dictionary, config.dictionary_id)) {
+                Metrics::instance().record_error(ErrorType::BAD_REQUEST);
+                return createCORSResponse("400 Bad Request", "application/json",
+                    "{\"error\":\"Unknown dictionary: " + Http::json_escape(dictionary) + "\"}");
+            }
             
-            auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+            // Identical uploads are served from the result cache
+            compressor::server::CacheKey cacheKey{
+                compressor::utils::ContentHash::calculate(fileData), fileData.size(), algorithm, config.block_size,
+                config.dictionary_id};
+            compressor::server::CachedResult cached;
             
-            if (!result.is_success()) {
-                return createCORSResponse("500 Internal Server Error", "application/json", 
-                    "{\"error\":\"Compression error: " + result.message() + "\"}");
+            auto start = std::chrono::high_resolution_clock::now();
+            bool cacheHit = cache.lookup(cacheKey, cached);
+            auto verification = cached.verified ? compressor::server::VerificationOutcome::PASSED
+                                                : compressor::server::VerificationOutcome::SKIPPED;
+            
+            if (!cacheHit) {
+                // Compress using selected algorithm
+                auto compressor = codecs.acquire(algorithm);
+                if (!compressor) {
+                    Metrics::instance().record_error(ErrorType::INVALID_ALGORITHM);
+                    return createCORSResponse("400 Bad Request", "application/json",
+                        "{\"error\":\"Invalid algorithm: " + algorithm + "\"}");
+                }
+                auto result = compressor->compress(fileData, config);
+                
+                if (!result.is_success()) {
+                    Metrics::instance().record_error(ErrorType::COMPRESSION_FAILED);
+                    return createCORSResponse("500 Internal Server Error", "application/json", 
+                        "{\"error\":\"Compression error: " + result.message() + "\"}");
+                }
+                
+                cached.stats = result.stats();
+                if (cached.stats.checksum == 0) {
+                    cached.stats.checksum = compressor::utils::CRC32::calculate(fileData);
+                }
+                cached.compressed = std::make_shared<const compressor::ByteVector>(std::move(result.data()));
+                
+                // Only results that passed their round trip are cached;
+                // async checks insert once they complete
+                compressor::server::ResultCache& resultCache = cache;
+                compressor::server::CachedResult entry = cached;
+                entry.verified = true;
+                verification = verifier.verify(algorithm, cached.compressed, fileData.size(), cached.stats.checksum,
+                    [&resultCache, cacheKey, entry]() { resultCache.insert(cacheKey, entry); });
+                cached.verified = verification == compressor::server::VerificationOutcome::PASSED;
             }
+            auto end = std::chrono::high_resolution_clock::now();
             
-            // Verify compression by decompressing
-            auto decompressResult = compressor->decompress(result.data());
-            bool verified = decompressResult.is_success() && decompressResult.data() == fileData;
+            const compressor::ByteVector& compressedData = *cached.compressed;
+            double elapsedMs = cacheHit ? std::chrono::duration<double, std::milli>(end - start).count()
+                                        : cached.stats.compression_time_ms;
             
-            // Encode compressed data in base64
-            std::string base64Data = base64Encode(result.data());
+            Metrics::instance().record_operation(algorithm, compressor::server::Operation::COMPRESS,
+                                                 fileData.size(), compressedData.size(), elapsedMs);
             
-            // Create JSON response
             std::string jsonResponse = "{";
             jsonResponse += "\"success\": true,";
             jsonResponse += "\"original_size\": " + std::to_string(fileData.size()) + ",";
-            jsonResponse += "\"compressed_size\": " + std::to_string(result.data().size()) + ",";
-            jsonResponse += "\"compression_ratio\": " + std::to_string((double)result.data().size() / fileData.size()) + ",";
-            jsonResponse += "\"compression_time_ms\": " + std::to_string(duration.count()) + ",";
+            jsonResponse += "\"compressed_size\": " + std::to_string(compressedData.size()) + ",";
+            jsonResponse += "\"compression_ratio\": " + std::to_string((double)compressedData.size() / fileData.size()) + ",";
+            jsonResponse += "\"compression_time_ms\": " + std::to_string(static_cast<long long>(elapsedMs)) + ",";
             jsonResponse += "\"algorithm\": \"" + algorithm + "\",";
-            jsonResponse += "\"verified\": " + std::string(verified ? "true" : "false") + ",";
-            jsonResponse += "\"compressed_data\": \"" + base64Data + "\"";
-            jsonResponse += "}";
+            jsonResponse += "\"verified\": " + std::string(cached.verified ? "true" : "false") + ",";
+            jsonResponse += "\"verification\": \"" + std::string(compressor::server::Verifier::outcome_name(verification)) + "\",";
+            jsonResponse += "\"cached\": " + std::string(cacheHit ? "true" : "false");
             
-            std::cout << "Compression completed: " << fileData.size() << " -> " << result.data().size() 
+            std::cout << "Compression completed" << (cacheHit ? " (cached)" : "") << ": "
+                     << fileData.size() << " -> " << compressedData.size() 
                      << " bytes (" << std::fixed << std::setprecision(1) 
-                     << ((double)result.data().size() / fileData.size() * 100) << "%)" << std::endl;
+                     << ((double)compressedData.size() / fileData.size() * 100) << "%)" << std::endl;
             
-            return createCORSResponse("200 OK", "application/json", jsonResponse);
+            return createBase64JsonResponse(jsonResponse, "compressed_data", compressedData);
             
         } catch (const std::exception& e) {
+            Metrics::instance().record_error(ErrorType::INTERNAL);
             return createCORSResponse("500 Internal Server Error", "application/json", 
                 "{\"error\":\"Internal error: " + std::string(e.what()) + "\"}");
         }
     }
     
-    std::string handleDecompression(const std::string& request) {
+    // POST /batch?algorithm=<name>[&operation=compress|decompress] with a
+    // length-prefixed bundle body (see server/batch.hpp)
+    std::string handleBatch(const std::string& request, const Http::QueryParams& query) {
+        compressor::utils::TraceSpan span("http.batch", "server");
+        auto algoIt = query.find("algorithm");
+        auto opIt = query.find("operation");
+        auto dictIt = query.find("dictionary");
+        std::string algorithm = algoIt != query.end() ? algoIt->second : "";
+        std::string operation = opIt != query.end() ? opIt->second : "compress";
+        std::string dictionary = dictIt != query.end() ? dictIt->second : "";
+        
+        if (operation != "compress" && operation != "decompress") {
+            Metrics::instance().record_error(ErrorType::BAD_REQUEST);
+            return createCORSResponse("400 Bad Request", "application/json",
+                "{\"error\":\"operation must be compress or decompress\"}");
+        }
+        if (!compressor::AlgorithmFactory::is_available(algorithm)) {
+            Metrics::instance().record_error(ErrorType::INVALID_ALGORITHM);
+            return createCORSResponse("400 Bad Request", "application/json",
+                "{\"error\":\"Invalid algorithm: " + Http::json_escape(algorithm) + "\"}");
+        }
+        compressor::CompressionConfig config;
+        if (!resolveDictionary(dictionary, config.dictionary_id)) {
+            Metrics::instance().record_error(ErrorType::BAD_REQUEST);
+            return createCORSResponse("400 Bad Request", "application/json",
+                "{\"error\":\"Unknown dictionary: " + Http::json_escape(dictionary) + "\"}");
+        }
+        
+        size_t headerEnd = request.find("\r\n\r\n");
+        size_t bodyStart = headerEnd == std::string::npos ? request.size() : headerEnd + 4;
+        
+        std::vector<compressor::server::BatchItem> items;
         try {
+            items = compressor::server::BatchBundle::parse(
+                reinterpret_cast<const uint8_t*>(request.data()) + bodyStart, request.size() - bodyStart);
+        } catch (const std::exception& e) {
+            Metrics::instance().record_error(ErrorType::BAD_REQUEST);
+            return createCORSResponse("400 Bad Request", "application/json",
+                "{\"error\":\"Invalid bundle: " + Http::json_escape(e.what()) + "\"}");
+        }
+        
+        auto op = operation == "compress" ? compressor::server::JobOperation::COMPRESS
+                                          : compressor::server::JobOperation::DECOMPRESS;
+        auto metricOp = operation == "compress" ? compressor::server::Operation::COMPRESS
+                                                : compressor::server::Operation::DECOMPRESS;
+        // Classify by the payload actually received rather than the framing
+        size_t payloadBytes = 0;
+        for (const auto& item : items) payloadBytes += item.size;
+        auto priority = admission.classify(payloadBytes) == compressor::server::RequestClass::SMALL
+            ? compressor::utils::ThreadPool::Priority::HIGH : compressor::utils::ThreadPool::Priority::NORMAL;
+        auto results = batches.run(op, algorithm, items, config, priority);
+        
+        size_t failed = 0;
+        for (size_t i = 0; i < results.size(); ++i) {
+            if (results[i].success) {
+                Metrics::instance().record_operation(algorithm, metricOp, items[i].size,
+                                                     results[i].output->size(), results[i].duration_ms);
+            } else {
+                failed++;
+                Metrics::instance().record_error(op == compressor::server::JobOperation::COMPRESS
+                    ? ErrorType::COMPRESSION_FAILED : ErrorType::DECOMPRESSION_FAILED);
+            }
+        }
+        
+        std::cout << "Batch " << operation << " completed: " << results.size() << " items, "
+                  << failed << " failed" << std::endl;
+        
+        return createCORSResponse("200 OK", "application/octet-stream",
+            compressor::server::BatchBundle::serialize(results),
+            "X-Batch-Items: " + std::to_string(results.size()) + "\r\n" +
+            "X-Batch-Failed: " + std::to_string(failed) + "\r\n");
+    }
+    
+    // POST /benchmark[?algorithms=a,b&repetitions=n] with either a multipart
+    // upload (field "file") or the raw file as body. Answers 202 with a run
+    // id; GET /benchmark/{id} returns BenchmarkResult::to_json() when done.
+    std::string handleBenchmark(const std::string& request, const Http::QueryParams& query) {
+        std::string contentType = Http::header_value(request, "Content-Type");
+        size_t headerEnd = request.find("\r\n\r\n");
+        size_t bodyStart = headerEnd == std::string::npos ? request.size() : headerEnd + 4;
+        
+        std::shared_ptr<const compressor::ByteVector> data;
+        if (contentType.find("multipart/form-data") != std::string::npos) {
+            size_t boundaryPos = contentType.find("boundary=");
+            std::string boundary = boundaryPos != std::string::npos ? contentType.substr(boundaryPos + 9) : "";
+            if (!boundary.empty() && boundary[0] == '"') {
+                boundary = boundary.substr(1, boundary.find('"', 1) - 1);
+            }
+            data = std::make_shared<const compressor::ByteVector>(extractFileData(request, boundary));
+        } else {
+            data = std::make_shared<const compressor::ByteVector>(request.begin() + bodyStart, request.end());
+        }
+        
+        if (data->empty()) {
+            Metrics::instance().record_error(ErrorType::BAD_REQUEST);
+            return createCORSResponse("400 Bad Request", "application/json", "{\"error\":\"File not found\"}");
+        }
+        
+        compressor::benchmark::BenchmarkConfig benchConfig;
+        auto algoIt = query.find("algorithms");
+        if (algoIt != query.end()) {
+            std::istringstream names(algoIt->second);
+            std::string name;
+            while (std::getline(names, name, ',')) {
+                if (!compressor::AlgorithmFactory::is_available(name)) {
+                    Metrics::instance().record_error(ErrorType::INVALID_ALGORITHM);
+                    return createCORSResponse("400 Bad Request", "application/json",
+                        "{\"error\":\"Invalid algorithm: " + Http::json_escape(name) + "\"}");
+                }
+                benchConfig.algorithms.push_back(name);
+            }
+        }
+        auto repIt = query.find("repetitions");
+        if (repIt != query.end()) {
+            benchConfig.repetitions = std::max(1, std::min(10, std::atoi(repIt->second.c_str())));
+        }
+        
+        std::string id;
+        if (!benchmarks.start(data, benchConfig, id)) {
+            Metrics::instance().record_error(ErrorType::OVERLOADED);
+            return createCORSResponse("503 Service Unavailable", "application/json",
+                "{\"error\":\"Too many benchmarks running\"}",
+                "Retry-After: " + std::to_string(config.retry_after_seconds) + "\r\n");
+        }
+        
+        std::cout << "Benchmark " << id << " queued for " << data->size() << " bytes" << std::endl;
+        return createCORSResponse("202 Accepted", "application/json",
+            "{\"id\":\"" + id + "\",\"status_url\":\"/benchmark/" + id + "\"}",
+            "Location: /benchmark/" + id + "\r\n");
+    }
+    
+    std::string handleBenchmarkStatus(const std::string& id) {
+        compressor::server::BenchmarkStatus status;
+        if (!benchmarks.get(id, status)) {
+            Metrics::instance().record_error(ErrorType::NOT_FOUND);
+            return createCORSResponse("404 Not Found", "application/json", "{\"error\":\"Unknown benchmark\"}");
+        }
+        if (!status.finished) {
+            return createCORSResponse("202 Accepted", "application/json", status.to_json());
+        }
+        return createCORSResponse("200 OK", "application/json", status.result_json);
+    }
+    
+    // Optional `?range=first-last` returns only those bytes of the original
+    // data; hybrid streams decode just the blocks covering the range
+    std::string handleDecompression(const std::string& request, const Http::QueryParams& query) {
+        compressor::utils::TraceSpan span("http.decompress", "server");
+        try {
+            auto rangeIt = query.find("range");
+            bool hasRange = rangeIt != query.end();
+            size_t rangeFirst = 0, rangeLast = SIZE_MAX;
+            if (hasRange && !Http::parse_byte_range(rangeIt->second, rangeFirst, rangeLast)) {
+                Metrics::instance().record_error(ErrorType::BAD_REQUEST);
+                return createCORSResponse("400 Bad Request", "application/json",
+                    "{\"error\":\"Invalid range, expected first-last\"}");
+            }
+            
             std::cout << "Processing decompression request..." << std::endl;
             
             // Parse multipart form data (simplified)
             size_t boundaryPos = request.find("boundary=");
             if (boundaryPos == std::string::npos) {
                 std::cout << "Boundary not found in request" << std::endl;
+                Metrics::instance().record_error(ErrorType::BAD_REQUEST);
                 return createCORSResponse("400 Bad Request", "application/json", 
                     "{\"error\":\"Boundary not found\"}");
             }
@@ -359,9 +1125,10 @@ private:
             
             // Extract file data and algorithm
             std::string algorithm = extractFormField(request, "algorithm");
-            std::vector<uint8_t> fileData = extractFileData(request, boundary);
+            compressor::ByteVector fileData = extractFileData(request, boundary);
             
             if (algorithm.empty() || fileData.empty()) {
+                Metrics::instance().record_error(ErrorType::BAD_REQUEST);
                 return createCORSResponse("400 Bad Request", "application/json", 
                     "{\"error\":\"Missing algorithm or file data\"}");
             }
@@ -372,54 +1139,132 @@ private:
             compressor::ByteVector compressedData(fileData.begin(), fileData.end());
             
             // Decompress using selected algorithm
-            auto decompressor = compressor::AlgorithmFactory::create(algorithm);
+            auto decompressor = codecs.acquire(algorithm);
             if (!decompressor) {
+                Metrics::instance().record_error(ErrorType::INVALID_ALGORITHM);
                 return createCORSResponse("400 Bad Request", "application/json", 
                     "{\"error\":\"Invalid algorithm: " + algorithm + "\"}");
             }
             
-            auto result = decompressor->decompress(compressedData);
+            auto start = std::chrono::high_resolution_clock::now();
+            compressor::CompressionResult result(false);
+            size_t totalSize = 0;
+            auto* hybrid = dynamic_cast<compressor::HybridAlgorithm*>(decompressor.get());
+            auto* integer = dynamic_cast<compressor::IntegerAlgorithm*>(decompressor.get());
+            bool blockRange = hybrid || integer;
+            
+            if (hasRange && blockRange) {
+                try {
+                    totalSize = hybrid ? compressor::HybridAlgorithm::original_size(compressedData)
+                                       : compressor::IntegerAlgorithm::original_size(compressedData);
+                } catch (const std::exception& e) {
+                    Metrics::instance().record_error(ErrorType::DECOMPRESSION_FAILED);
+                    return createCORSResponse("400 Bad Request", "application/json",
+                        "{\"error\":\"Decompression error: " + Http::json_escape(e.what()) + "\"}");
+                }
+                if (rangeFirst < totalSize) {
+                    size_t length = std::min(rangeLast, totalSize - 1) - rangeFirst + 1;
+                    result = hybrid ? hybrid->decompress_range(compressedData, rangeFirst, length)
+                                    : integer->decompress_range(compressedData, rangeFirst, length);
+                } else {
+                    // Nothing to decode; answered with 416 below
+                    result = compressor::CompressionResult(true);
+                }
+            } else {
+                result = decompressor->decompress(compressedData);
+                totalSize = result.data().size();
+            }
+            auto end = std::chrono::high_resolution_clock::now();
             
+            // A failed decode leaves totalSize at 0, so check it before the range
             if (!result.is_success()) {
+                Metrics::instance().record_error(ErrorType::DECOMPRESSION_FAILED);
                 return createCORSResponse("400 Bad Request", "application/json", 
                     "{\"error\":\"Decompression error: " + result.message() + "\"}");
             }
             
-            // Encode decompressed data in base64
-            std::string encodedData = base64Encode(result.data());
+            if (hasRange && rangeFirst >= totalSize) {
+                return createCORSResponse("416 Range Not Satisfiable", "application/json",
+                    "{\"error\":\"Range starts beyond " + std::to_string(totalSize) + " bytes\"}",
+                    "Content-Range: bytes */" + std::to_string(totalSize) + "\r\n");
+            }
+            
+            // Codecs without block headers are decoded in full and sliced
+            if (hasRange && !blockRange) {
+                size_t rangeEnd = std::min(rangeLast, totalSize - 1) + 1;
+                compressor::ByteVector slice(result.data().begin() + rangeFirst, result.data().begin() + rangeEnd);
+                result.set_data(std::move(slice));
+            }
+            
+            Metrics::instance().record_operation(algorithm, compressor::server::Operation::DECOMPRESS,
+                                                 compressedData.size(), result.data().size(),
+                                                 std::chrono::duration<double, std::milli>(end - start).count());
             
             std::string jsonResponse = "{\"success\": true,";
             jsonResponse += "\"algorithm\": \"" + algorithm + "\",";
-            jsonResponse += "\"decompressed_data\": \"" + encodedData + "\",";
             jsonResponse += "\"compressed_size\": " + std::to_string(compressedData.size()) + ",";
             jsonResponse += "\"decompressed_size\": " + std::to_string(result.data().size()) + ",";
-            jsonResponse += "\"compression_ratio\": " + std::to_string((double)compressedData.size() / result.data().size()) + ",";
+            if (hasRange) {
+                jsonResponse += "\"range_start\": " + std::to_string(rangeFirst) + ",";
+                jsonResponse += "\"range_end\": " + std::to_string(rangeFirst + result.data().size() - 1) + ",";
+                jsonResponse += "\"total_size\": " + std::to_string(totalSize) + ",";
+            } else {
+                jsonResponse += "\"compression_ratio\": " + std::to_string((double)compressedData.size() / result.data().size()) + ",";
+            }
             jsonResponse += "\"decompression_time_ms\": " + std::to_string(result.stats().decompression_time_ms);
-            jsonResponse += "}";
             
             std::cout << "Decompression completed: " << compressedData.size() << " -> " << result.data().size() 
                      << " bytes" << std::endl;
             
-            return createCORSResponse("200 OK", "application/json", jsonResponse);
+            return createBase64JsonResponse(jsonResponse, "decompressed_data", result.data());
             
         } catch (const std::exception& e) {
+            Metrics::instance().record_error(ErrorType::INTERNAL);
             return createCORSResponse("500 Internal Server Error", "application/json", 
                 "{\"error\":\"Internal error: " + std::string(e.what()) + "\"}");
         }
     }
     
-    std::string createCORSResponse(const std::string& status, const std::string& contentType, const std::string& body) {
-        std::string response = "HTTP/1.1 " + status + "\r\n";
-        response += "Access-Control-Allow-Origin: *\r\n";
-        response += "Access-Control-Allow-Methods: GET, POST, OPTIONS, PUT, DELETE\r\n";
-        response += "Access-Control-Allow-Headers: Content-Type, Authorization, X-Requested-With\r\n";
-        response += "Access-Control-Max-Age: 86400\r\n";
-        response += "Content-Type: " + contentType + "\r\n";
-        response += "Content-Length: " + std::to_string(body.length()) + "\r\n\r\n";
+    std::string createCORSResponse(const std::string& status, const std::string& contentType, const std::string& body,
+                                   const std::string& extraHeaders = "") {
+        std::string response = createCORSHeaders(status, contentType, body.length(), extraHeaders);
         response += body;
         return response;
     }
     
+    // Complete an open JSON object (`fields`, without the closing brace) with
+    // `field` holding `data` in base64. The payload is encoded straight into
+    // the presized response, so it is never copied after encoding.
+    std::string createBase64JsonResponse(const std::string& fields, const std::string& field,
+                                         const compressor::ByteVector& data) {
+        std::string prefix = fields + ",\"" + field + "\": \"";
+        const char suffix[] = "\"}";
+        size_t encodedSize = compressor::utils::Base64::encoded_size(data.size());
+        size_t bodySize = prefix.size() + encodedSize + sizeof(suffix) - 1;
+        
+        std::string response = createCORSHeaders("200 OK", "application/json", bodySize);
+        size_t encodedAt = response.size() + prefix.size();
+        response.reserve(encodedAt + encodedSize + sizeof(suffix) - 1);
+        response += prefix;
+        response.resize(encodedAt + encodedSize);
+        compressor::utils::Base64::encode(data.data(), data.size(), &response[encodedAt]);
+        response += suffix;
+        return response;
+    }
+    
+    std::string createCORSHeaders(const std::string& status, const std::string& contentType, size_t contentLength,
+                                  const std::string& extraHeaders = "") {
+        std::string headers = "HTTP/1.1 " + status + "\r\n";
+        headers += "Access-Control-Allow-Origin: *\r\n";
+        headers += "Access-Control-Allow-Methods: GET, POST, OPTIONS, PUT, DELETE\r\n";
+        headers += "Access-Control-Allow-Headers: Content-Type, Authorization, X-Requested-With\r\n";
+        headers += "Access-Control-Max-Age: 86400\r\n";
+        headers += "Content-Type: " + contentType + "\r\n";
+        headers += extraHeaders;
+        headers += "Content-Length: " + std::to_string(contentLength) + "\r\n\r\n";
+        return headers;
+    }
+    
     std::string extractFormField(const std::string& request, const std::string& fieldName) {
         std::cout << "Extracting form field: " << fieldName << std::endl;
         
@@ -460,7 +1305,8 @@ private:
         return value;
     }
     
-    std::vector<uint8_t> extractFileData(const std::string& request, const std::string& boundary) {
+    compressor::ByteVector extractFileData(const std::string& request, const std::string& boundary) {
+        compressor::utils::TraceSpan span("http.extract", "server");
         std::cout << "Extracting file data with boundary: [" << boundary << "]" << std::endl;
         
         // Look for file content after Content-Disposition header with name="file"
@@ -472,12 +1318,13 @@ private:
         }
         
         // Find the actual content after headers (after \r\n\r\n)
-        pos = request.find("\r\n\r\n", pos);
-        if (pos == std::string::npos) {
+        size_t partStart = pos;
+        size_t headersEnd = request.find("\r\n\r\n", pos);
+        if (headersEnd == std::string::npos) {
             std::cout << "Content start not found" << std::endl;
             return {};
         }
-        pos += 4; // Skip \r\n\r\n
+        pos = headersEnd + 4; // Skip \r\n\r\n
         
         // Find end of content (boundary with --)
         std::string endPattern = "\r\n--" + boundary;
@@ -497,45 +1344,117 @@ private:
             }
         }
         
-        std::string fileContent = request.substr(pos, endPos - pos);
-        std::cout << "Extracted file data: " << fileContent.size() << " bytes" << std::endl;
+        // Base64 uploads are flagged by the part header or an "encoding" field
+        std::string partHeaders = request.substr(partStart, headersEnd - partStart);
+        bool isBase64 = partHeaders.find("Content-Transfer-Encoding: base64") != std::string::npos ||
+                        (request.find("name=\"encoding\"") != std::string::npos &&
+                         extractFormField(request, "encoding") == "base64");
+        if (isBase64) {
+            compressor::ByteVector decoded;
+            if (!compressor::utils::Base64::decode(request.data() + pos, endPos - pos, decoded)) {
+                std::cout << "Invalid base64 file data" << std::endl;
+                return {};
+            }
+            std::cout << "Extracted file data: " << decoded.size() << " bytes (base64)" << std::endl;
+            return decoded;
+        }
         
-        return std::vector<uint8_t>(fileContent.begin(), fileContent.end());
+        std::cout << "Extracted file data: " << endPos - pos << " bytes" << std::endl;
+        return compressor::ByteVector(request.begin() + pos, request.begin() + endPos);
     }
 };
 
-// Global server instance
-std::unique_ptr<WebServer> server;
+void signalHandler(int) {
+    stopRequested = 1;
+}
 
-void signalHandler(int sig) {
-    std::cout << "\nStopping server..." << std::endl;
-    if (server) {
-        server->stop();
+// Serve until a stop is requested, then drain. Runs in each worker process.
+int runServer(const compressor::server::ServerConfig& config, bool primary) {
+    auto server = std::make_unique<WebServer>(config);
+    
+    if (!server->start(config.port, primary)) {
+        std::cerr << "Failed to start server" << std::endl;
+        return 1;
+    }
+    
+    if (primary) {
+        std::cout << "Available algorithms:" << std::endl;
+        for (const auto& algo : compressor::AlgorithmFactory::list_algorithms()) {
+            std::cout << "   • " << algo << std::endl;
+        }
+        std::cout << std::endl;
+    }
+    
+    server->run();
+    
+    std::cout << "Stopping server (pid " << getpid() << "), draining in-flight requests..." << std::endl;
+    if (!server->drain(config.drain_timeout)) {
+        // Detached connection threads may still touch the server; skip teardown
+        std::cout.flush();
+        _exit(1);
     }
-    exit(0);
+    
+    server.reset();
+    if (!config.span_trace_file.empty()) {
+        // Each pre-forked worker writes its own file
+        std::string path = config.span_trace_file;
+        if (config.processes > 1) {
+            path += "." + std::to_string(getpid());
+        }
+        if (compressor::utils::Tracer::write(path)) {
+            std::cout << "Span trace written to " << path << std::endl;
+        } else {
+            std::cerr << "Cannot write span trace " << path << std::endl;
+        }
+    }
+    std::cout << "Server stopped (pid " << getpid() << ")" << std::endl;
+    return 0;
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    compressor::server::ServerConfig config;
+    try {
+        config = compressor::server::ServerConfig::from_args(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        compressor::server::ServerConfig::print_usage(argv[0]);
+        return 1;
+    }
+    
+    if (config.help) {
+        compressor::server::ServerConfig::print_usage(argv[0]);
+        return 0;
+    }
+    
     // Set up signal handlers
     signal(SIGINT, signalHandler);
     signal(SIGTERM, signalHandler);
     
     std::cout << "Starting Compressor Web Server..." << std::endl;
-    
-    server = std::make_unique<WebServer>();
-    
-    if (!server->start(8080)) {
-        std::cerr << "Failed to start server" << std::endl;
-        return 1;
+    std::cout << "CPU features: " << compressor::utils::CpuFeatures::get().describe() << std::endl;
+    std::cout << "Kernels: " << compressor::utils::Kernels::describe() << std::endl;
+    compressor::HugePages::set_mode(config.huge_pages);
+    std::cout << "Huge pages: " << compressor::HugePages::mode_name(config.huge_pages) << std::endl;
+    if (!config.span_trace_file.empty()) {
+        compressor::utils::Tracer::enable();
     }
-    
-    std::cout << "Available algorithms:" << std::endl;
-    for (const auto& algo : compressor::AlgorithmFactory::list_algorithms()) {
-        std::cout << "   • " << algo << std::endl;
+    if (!config.dictionary_dir.empty()) {
+        // Loaded before forking so every worker shares them
+        try {
+            size_t loaded = compressor::utils::DictionaryRegistry::instance().load_directory(config.dictionary_dir);
+            std::cout << "Dictionaries: " << loaded << " loaded from " << config.dictionary_dir << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
     }
-    std::cout << std::endl;
     
-    server->run();
+    if (config.processes <= 1) {
+        compressor::server::Prefork::pin_worker(config.pin, 0);
+        return runServer(config, true);
+    }
     
-    return 0;
+    std::cout << "Pre-forking " << config.processes << " workers" << std::endl;
+    return compressor::server::Prefork::run(config.processes, config.pin, config.drain_timeout, stopRequested,
+        [&config](size_t index) { return runServer(config, index == 0); });
 }